@@ -0,0 +1,129 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+#ifndef VEC89_BENCH_H
+#define VEC89_BENCH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_MAX_SAMPLES 101 /* Upper bound of --samples */
+#define BENCH_MAX_METRICS 4	  /* Extra metrics a case can report next to its timings */
+
+/*
+Settings parsed from the command line, shared by every suite.
+*/
+typedef struct BENCH_SETTINGS {
+	size_t max_size;	  /* Largest element count of the size sweeps */
+	size_t max_bytes;	  /* Cases whose array would be larger than this many bytes are skipped */
+	size_t samples;		  /* Timed samples per case */
+	size_t min_ops;		  /* Operations per sample that small cases repeat up to */
+	size_t max_threads;	  /* Largest thread count of the contention cases */
+	const char *filter;	  /* Only run cases whose name contains this, NULL for all */
+} bench_settings_t;
+
+extern bench_settings_t bench_settings;
+
+/*
+One benchmark case. A case is identified by its name, implementation, element size, element count and thread count,
+so results of two runs can be joined on these fields.
+*/
+typedef struct BENCH_CASE {
+	const char *name;	   /* Operation, e.g. "push" or "insert_head" */
+	const char *impl;	   /* Implementation, e.g. "vec89", "array" or "std_vector" */
+	size_t elem_size;	   /* Element size in bytes */
+	size_t size;		   /* Element count the operation runs on */
+	size_t threads;		   /* Threads running the operation */
+	size_t sample_count;   /* Samples collected so far */
+	double samples[BENCH_MAX_SAMPLES]; /* Nanoseconds per operation of each sample */
+	double start;		   /* Start of the running sample */
+	const char *metric_names[BENCH_MAX_METRICS];
+	double metric_values[BENCH_MAX_METRICS];
+	size_t metric_count;
+} bench_case;
+
+/* Sink that keeps the compiler from removing loads whose results are otherwise unused */
+extern volatile size_t bench_sink;
+
+/* Cost of one bench_now call in nanoseconds */
+extern double bench_timer_overhead;
+
+/* Monotonic time in nanoseconds */
+double bench_now(void);
+
+/* Peak resident set size of the process in KiB, 0 if unknown */
+size_t bench_peak_rss_kb(void);
+
+/* Returns non-zero if the case should run, which depends on the filter, max_size and max_bytes */
+int bench_begin(bench_case *c, const char *name, const char *impl, size_t elem_size, size_t size, size_t threads);
+
+/* Returns non-zero while more samples are needed */
+int bench_more(bench_case *c);
+
+/* Starts timing a sample */
+void bench_start(bench_case *c);
+
+/* Stops timing a sample that ran ops operations */
+void bench_stop(bench_case *c, size_t ops);
+
+/* Nanoseconds since start, minus the cost of reading the clock. For samples timed in several intervals */
+double bench_elapsed(double start);
+
+/* Records a sample that took elapsed nanoseconds for ops operations */
+void bench_record(bench_case *c, double elapsed, size_t ops);
+
+/* Attaches an extra metric, e.g. the final capacity, to the report */
+void bench_metric(bench_case *c, const char *name, double value);
+
+/* Writes the case to the JSON report */
+void bench_end(bench_case *c);
+
+/* Number of times a case on size elements repeats to reach min_ops operations per sample */
+size_t bench_repeats(size_t size);
+
+/* Deterministic pseudo-random numbers */
+size_t bench_random(size_t *state);
+
+/* Fills n bytes with pseudo-random bytes */
+void bench_random_bytes(void *out, size_t n, size_t *state);
+
+/* Element counts and sizes of the sweeps, terminated by 0 */
+extern const size_t bench_sizes[];
+extern const size_t bench_elem_sizes[];
+
+void bench_core_suite(void);
+void bench_threads_suite(void);
+void bench_features_suite(void);
+#ifdef VEC89_BENCH_STD_VECTOR
+void bench_std_vector_suite(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VEC89_BENCH_H */
\ No newline at end of file
@@ -0,0 +1,470 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+/*
+Core suite: every basic vec89 operation over the element size and vector size sweeps, next to a raw array that does
+the same work without function calls, checks or locks.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../include/vec89.h"
+
+#define min(a, b) ((a) > (b) ? (b) : (a))
+
+#define BENCH_INDEX_COUNT 4096					/* Random indices cycled through by get/set, a power of two */
+#define BENCH_MOVE_BUDGET ((size_t)1 << 26)	/* Bytes insert/remove cases move per sample at most */
+
+#define BENCH_HEAD 0
+#define BENCH_MIDDLE 1
+#define BENCH_TAIL 2
+
+static const char *bench_insert_names[] = { "insert_head", "insert_middle", "insert_tail" };
+static const char *bench_remove_names[] = { "remove_head", "remove_middle", "remove_tail" };
+
+/* Growable raw array, the baseline */
+typedef struct BENCH_ARRAY {
+	unsigned char *arr;
+	size_t capacity;
+	size_t elem_size;
+	size_t count;
+} bench_array;
+
+static unsigned char bench_element[256];
+static size_t bench_indices[BENCH_INDEX_COUNT];
+
+static void bench_array_reserve(bench_array *a, size_t capacity) {
+	size_t new_capacity = a->capacity > 0 ? a->capacity : 15;
+	void *arr;
+	if (capacity <= a->capacity) return;
+	while (new_capacity < capacity) new_capacity *= 2;
+	arr = realloc(a->arr, a->elem_size * new_capacity);
+	if (arr == NULL) abort();
+	a->arr = (unsigned char *)arr;
+	a->capacity = new_capacity;
+}
+
+static void bench_array_fill(bench_array *a, size_t elem_size, size_t count) {
+	size_t i;
+	a->arr = NULL;
+	a->capacity = 0;
+	a->elem_size = elem_size;
+	a->count = 0;
+	bench_array_reserve(a, count);
+	for (i = 0; i < count; i++) memcpy(a->arr + elem_size * i, bench_element, elem_size);
+	a->count = count;
+}
+
+static void bench_vec_fill(vec_p v, size_t elem_size, size_t count) {
+	size_t i;
+	if (VEC89_INITIALIZATION(v, elem_size) != VEC89_SUCCESS || VEC89_RESERVE(v, count) != VEC89_SUCCESS) abort();
+	for (i = 0; i < count; i++) VEC89_PUSH(v, bench_element);
+}
+
+static size_t bench_position(int where, size_t count) {
+	if (where == BENCH_HEAD) return 0;
+	if (where == BENCH_MIDDLE) return count / 2;
+	return count;
+}
+
+/* Operations per insert/remove sample: limited by the bytes they move, and by the size so the vector stays near it */
+static size_t bench_move_ops(size_t elem_size, size_t size, int where) {
+	size_t moved = where == BENCH_HEAD ? elem_size * size : where == BENCH_MIDDLE ? elem_size * size / 2 : elem_size;
+	size_t ops = BENCH_MOVE_BUDGET / (moved > 0 ? moved : 1);
+	if (ops > bench_settings.min_ops) ops = bench_settings.min_ops;
+	return ops > 0 ? ops : 1;
+}
+
+static void bench_push(size_t elem_size, size_t size) {
+	bench_case c;
+	size_t repeats = bench_repeats(size), r, i;
+
+	if (bench_begin(&c, "push", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (r = 0; r < repeats; r++) {
+				vec v;
+				VEC89_INITIALIZATION(&v, elem_size);
+				for (i = 0; i < size; i++) VEC89_PUSH(&v, bench_element);
+				VEC89_ARRAY_FREE(&v);
+			}
+			bench_stop(&c, repeats * size);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "push", "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (r = 0; r < repeats; r++) {
+				bench_array a = { NULL, 0, 0, 0 };
+				a.elem_size = elem_size;
+				for (i = 0; i < size; i++) {
+					if (a.count >= a.capacity) bench_array_reserve(&a, a.count + 1);
+					memcpy(a.arr + elem_size * a.count++, bench_element, elem_size);
+				}
+				free(a.arr);
+			}
+			bench_stop(&c, repeats * size);
+		}
+		bench_end(&c);
+	}
+}
+
+static void bench_get_set(size_t elem_size, size_t size) {
+	bench_case c;
+	size_t ops = bench_settings.min_ops * 10, i;
+	vec v;
+	bench_array a;
+
+	for (i = 0; i < BENCH_INDEX_COUNT; i++) bench_indices[i] %= size;
+	bench_vec_fill(&v, elem_size, size);
+	bench_array_fill(&a, elem_size, size);
+
+	if (bench_begin(&c, "get", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			size_t sum = 0;
+			bench_start(&c);
+			for (i = 0; i < ops; i++) {
+				void *element;
+				VEC89_GET(&v, bench_indices[i & (BENCH_INDEX_COUNT - 1)], &element);
+				sum += *(unsigned char *)element;
+			}
+			bench_stop(&c, ops);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+	}
+
+	/* One lock acquisition for the whole loop, the accesses are plain pointer arithmetic */
+	if (bench_begin(&c, "get", "vec89_view", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			size_t sum = 0;
+			vec89_view view;
+			bench_start(&c);
+			VEC89_VIEW(&v, 0, VEC89_VIEW_END_OF_VECTOR, 0, &view);
+			for (i = 0; i < ops; i++) sum += *(unsigned char *)vec89_view_at(&view, bench_indices[i & (BENCH_INDEX_COUNT - 1)]);
+			VEC89_VIEW_RELEASE(&view);
+			bench_stop(&c, ops);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "get", "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			size_t sum = 0;
+			bench_start(&c);
+			for (i = 0; i < ops; i++) sum += a.arr[elem_size * bench_indices[i & (BENCH_INDEX_COUNT - 1)]];
+			bench_stop(&c, ops);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "set", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (i = 0; i < ops; i++) VEC89_SET(&v, bench_indices[i & (BENCH_INDEX_COUNT - 1)], bench_element);
+			bench_stop(&c, ops);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "set", "vec89_view", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			vec89_view view;
+			bench_start(&c);
+			VEC89_VIEW(&v, 0, VEC89_VIEW_END_OF_VECTOR, 1, &view);
+			for (i = 0; i < ops; i++) memcpy(vec89_view_at(&view, bench_indices[i & (BENCH_INDEX_COUNT - 1)]), bench_element, elem_size);
+			VEC89_VIEW_RELEASE(&view);
+			bench_stop(&c, ops);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "set", "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (i = 0; i < ops; i++) memcpy(a.arr + elem_size * bench_indices[i & (BENCH_INDEX_COUNT - 1)], bench_element, elem_size);
+			bench_stop(&c, ops);
+		}
+		bench_end(&c);
+	}
+
+	VEC89_ARRAY_FREE(&v);
+	free(a.arr);
+}
+
+static void bench_pop(size_t elem_size, size_t size) {
+	bench_case c;
+	size_t repeats = bench_repeats(size), r, i;
+	unsigned char out[256];
+	vec v;
+	bench_array a;
+
+	bench_vec_fill(&v, elem_size, size);
+	bench_array_fill(&a, elem_size, size);
+
+	if (bench_begin(&c, "pop", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			for (r = 0; r < repeats; r++) {
+				v.count = size;
+				start = bench_now();
+				for (i = 0; i < size; i++) VEC89_POP_INTO(&v, out);
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats * size);
+			bench_sink += out[0];
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "pop", "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			for (r = 0; r < repeats; r++) {
+				a.count = size;
+				start = bench_now();
+				for (i = 0; i < size; i++) memcpy(out, a.arr + elem_size * --a.count, elem_size);
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats * size);
+			bench_sink += out[0];
+		}
+		bench_end(&c);
+	}
+
+	VEC89_ARRAY_FREE(&v);
+	free(a.arr);
+}
+
+/* Inserts and removes in batches of at most size / 8 + 1 elements, so the vector stays close to its size */
+static void bench_insert_remove(size_t elem_size, size_t size, int where) {
+	bench_case c;
+	size_t ops = bench_move_ops(elem_size, size, where), batch = size / 8 + 1, done, i;
+	vec v;
+	bench_array a;
+
+	bench_vec_fill(&v, elem_size, size);
+	bench_array_fill(&a, elem_size, size);
+	VEC89_RESERVE(&v, size + batch);
+	bench_array_reserve(&a, size + batch);
+
+	if (bench_begin(&c, bench_insert_names[where], "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			for (done = 0; done < ops; done += batch) {
+				size_t n = min(batch, ops - done);
+				start = bench_now();
+				for (i = 0; i < n; i++) VEC89_INSERT(&v, bench_position(where, v.count), bench_element);
+				elapsed += bench_elapsed(start);
+				v.count = size;
+			}
+			bench_record(&c, elapsed, ops);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, bench_insert_names[where], "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			for (done = 0; done < ops; done += batch) {
+				size_t n = min(batch, ops - done);
+				start = bench_now();
+				for (i = 0; i < n; i++) {
+					size_t idx = bench_position(where, a.count);
+					if (a.count >= a.capacity) bench_array_reserve(&a, a.count + 1);
+					memmove(a.arr + elem_size * (idx + 1), a.arr + elem_size * idx, elem_size * (a.count - idx));
+					memcpy(a.arr + elem_size * idx, bench_element, elem_size);
+					a.count++;
+				}
+				elapsed += bench_elapsed(start);
+				a.count = size;
+			}
+			bench_record(&c, elapsed, ops);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, bench_remove_names[where], "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			for (done = 0; done < ops; done += batch) {
+				size_t n = min(batch, ops - done);
+				v.count = size + n;
+				start = bench_now();
+				for (i = 0; i < n; i++) VEC89_REMOVE(&v, where == BENCH_TAIL ? v.count - 1 : bench_position(where, v.count));
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, ops);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, bench_remove_names[where], "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			for (done = 0; done < ops; done += batch) {
+				size_t n = min(batch, ops - done);
+				a.count = size + n;
+				start = bench_now();
+				for (i = 0; i < n; i++) {
+					size_t idx = where == BENCH_TAIL ? a.count - 1 : bench_position(where, a.count);
+					memmove(a.arr + elem_size * idx, a.arr + elem_size * (idx + 1), elem_size * (a.count - idx - 1));
+					a.count--;
+				}
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, ops);
+		}
+		bench_end(&c);
+	}
+
+	VEC89_ARRAY_FREE(&v);
+	free(a.arr);
+}
+
+static void bench_capacity(size_t elem_size, size_t size) {
+	bench_case c;
+	size_t repeats = bench_repeats(size), r;
+
+	if (bench_begin(&c, "reserve", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (r = 0; r < repeats; r++) {
+				vec v;
+				VEC89_INITIALIZATION_CAPACITY(&v, elem_size, 0);
+				VEC89_RESERVE(&v, size);
+				VEC89_ARRAY_FREE(&v);
+			}
+			bench_stop(&c, repeats);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "reserve", "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (r = 0; r < repeats; r++) {
+				void *arr = malloc(elem_size * size);
+				bench_sink += arr != NULL;
+				free(arr);
+			}
+			bench_stop(&c, repeats);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "expand", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			vec v;
+			bench_vec_fill(&v, elem_size, size);
+			for (r = 0; r < repeats; r++) {
+				VEC89_SHRINK_TO_FIT(&v);
+				start = bench_now();
+				VEC89_EXPAND(&v, 1);
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats);
+			VEC89_ARRAY_FREE(&v);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "shrink_to_fit", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			vec v;
+			bench_vec_fill(&v, elem_size, size);
+			for (r = 0; r < repeats; r++) {
+				VEC89_RESERVE(&v, size * 2);
+				start = bench_now();
+				VEC89_SHRINK_TO_FIT(&v);
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats);
+			VEC89_ARRAY_FREE(&v);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "shrink", "vec89", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			vec v;
+			bench_vec_fill(&v, elem_size, size);
+			for (r = 0; r < repeats; r++) {
+				VEC89_RESERVE(&v, size * 4);
+				start = bench_now();
+				VEC89_SHRINK(&v, 2);
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats);
+			VEC89_ARRAY_FREE(&v);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "expand", "array", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0, start;
+			bench_array a;
+			bench_array_fill(&a, elem_size, size);
+			for (r = 0; r < repeats; r++) {
+				a.arr = (unsigned char *)realloc(a.arr, elem_size * size);
+				start = bench_now();
+				a.arr = (unsigned char *)realloc(a.arr, elem_size * size * 2);
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats);
+			free(a.arr);
+		}
+		bench_end(&c);
+	}
+}
+
+void bench_core_suite(void) {
+	size_t state = 0x9E3779B97F4A7C15ULL & (size_t)-1, s, e, i;
+	int where;
+
+	bench_random_bytes(bench_element, sizeof(bench_element), &state);
+	for (e = 0; bench_elem_sizes[e] != 0; e++) {
+		for (s = 0; bench_sizes[s] != 0; s++) {
+			size_t elem_size = bench_elem_sizes[e], size = bench_sizes[s];
+			if (size > bench_settings.max_size || size > bench_settings.max_bytes / elem_size) continue;
+
+			for (i = 0; i < BENCH_INDEX_COUNT; i++) bench_indices[i] = bench_random(&state);
+			bench_push(elem_size, size);
+			bench_get_set(elem_size, size);
+			bench_pop(elem_size, size);
+			for (where = BENCH_HEAD; where <= BENCH_TAIL; where++) bench_insert_remove(elem_size, size, where);
+			bench_capacity(elem_size, size);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,1012 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+/*
+Features suite: allocators, typed vectors, growth policies, sorting and searching, sorted vectors, SIMD kernels,
+parallel algorithms, deques, segmented and columnar vectors, clones and snapshots, bit vectors, each next to the plain
+vec89 or libc code it replaces.
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../include/vec89.h"
+#include "../include/vec89_alloc.h"
+#include "../include/vec89_typed.h"
+#include "../include/vec89_algo.h"
+#ifdef VEC89_PARALLEL_NOTC89
+	#include "../include/vec89_parallel.h"
+#endif
+
+#define BENCH_SMALL_VECTORS 1000 /* Vectors created per sample of the allocator cases */
+#define BENCH_LOOKUPS 1000000	 /* Searches per sample of the binary search cases */
+#define BENCH_MERGE_BATCH 1000	 /* Elements per merge of the sorted vector batch case */
+
+#define BENCH_U32_LESS(a, b) ((a) < (b))
+
+/* 32 byte element of the typed cases, next to the 4 byte unsigned int and the 8 byte unsigned long long */
+typedef struct BENCH_BLOCK {
+	unsigned long long words[4];
+} bench_block;
+
+VEC89_DEFINE(bench_u32_vec, unsigned int)
+VEC89_DEFINE_SORT(bench_u32_vec, unsigned int, BENCH_U32_LESS)
+VEC89_DEFINE(bench_u64_vec, unsigned long long)
+VEC89_DEFINE(bench_block_vec, bench_block)
+
+static const size_t bench_feature_sizes[] = { 1000, 100000, 1000000, 10000000, 0 };
+static const size_t bench_simd_sizes[] = { 1, 2, 4, 8, 16, 0 };
+
+/* malloc based allocator that counts calls and the peak of live bytes, for the allocator and growth policy cases */
+typedef struct BENCH_COUNTING {
+	size_t live;
+	size_t peak;
+	size_t allocations;
+	size_t reallocations;
+} bench_counting;
+
+/* 64 byte row of the columnar cases, scans read the key and value fields only */
+typedef struct BENCH_ROW {
+	unsigned int key;
+	unsigned int flags;
+	double value;
+	char payload[48];
+} bench_row;
+
+static const vec89_soa_field bench_row_fields[] = {
+	{ offsetof(bench_row, key), sizeof(unsigned int) },
+	{ offsetof(bench_row, flags), sizeof(unsigned int) },
+	{ offsetof(bench_row, value), sizeof(double) },
+	{ offsetof(bench_row, payload), 48 }
+};
+#define BENCH_ROW_FIELDS (sizeof(bench_row_fields) / sizeof(bench_row_fields[0]))
+
+static void *bench_counting_alloc(void *context, size_t size) {
+	bench_counting *counting = (bench_counting *)context;
+	counting->live += size;
+	if (counting->live > counting->peak) counting->peak = counting->live;
+	counting->allocations++;
+	return malloc(size);
+}
+
+static void *bench_counting_realloc(void *context, void *block, size_t old_size, size_t new_size) {
+	bench_counting *counting = (bench_counting *)context;
+	/* Both blocks are live while realloc copies */
+	if (counting->live + new_size > counting->peak) counting->peak = counting->live + new_size;
+	counting->live = counting->live - old_size + new_size;
+	counting->reallocations++;
+	return realloc(block, new_size);
+}
+
+static void bench_counting_free(void *context, void *block, size_t size) {
+	bench_counting *counting = (bench_counting *)context;
+	counting->live -= size;
+	free(block);
+}
+
+static int bench_compare_u32(const void *a, const void *b) {
+	unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+	return (x > y) - (x < y);
+}
+
+static void bench_allocators(void) {
+	static const char *impls[] = { "malloc", "arena", "pool" };
+	bench_case c;
+	size_t impl, i, j;
+
+	for (impl = 0; impl < 3; impl++) {
+		if (!bench_begin(&c, "alloc_small_vectors", impls[impl], sizeof(int), 16, 1)) continue;
+		while (bench_more(&c)) {
+			static vec vectors[BENCH_SMALL_VECTORS];
+			bench_counting counting = { 0, 0, 0, 0 };
+			vec89_allocator counting_allocator;
+			vec89_arena arena;
+			vec89_pool pool;
+			const vec89_allocator *allocator = &counting_allocator;
+
+			counting_allocator.alloc_function = bench_counting_alloc;
+			counting_allocator.realloc_function = bench_counting_realloc;
+			counting_allocator.free_function = bench_counting_free;
+			counting_allocator.context = &counting;
+			if (impl == 1) {
+				VEC89_ARENA_INITIALIZATION(&arena, 0);
+				allocator = &arena.allocator;
+			} else if (impl == 2) {
+				VEC89_POOL_INITIALIZATION(&pool);
+				allocator = &pool.allocator;
+			}
+
+			bench_start(&c);
+			for (i = 0; i < BENCH_SMALL_VECTORS; i++) {
+				VEC89_INITIALIZATION_ALLOCATOR(&vectors[i], sizeof(int), allocator);
+				for (j = 0; j < 16; j++) VEC89_PUSH(&vectors[i], &j);
+			}
+			for (i = 0; i < BENCH_SMALL_VECTORS; i++) VEC89_ARRAY_FREE(&vectors[i]);
+			bench_stop(&c, BENCH_SMALL_VECTORS);
+
+			/* Every malloc and realloc of the baseline goes to the system allocator */
+			if (impl == 0) {
+				bench_metric(&c, "system_allocations", (double)(counting.allocations + counting.reallocations));
+			} else if (impl == 1) {
+				bench_metric(&c, "system_allocations", (double)arena.system_allocations);
+				VEC89_ARENA_DESTROY(&arena);
+			} else if (impl == 2) {
+				bench_metric(&c, "system_allocations", (double)pool.system_allocations);
+				VEC89_POOL_DESTROY(&pool);
+			}
+		}
+		bench_end(&c);
+	}
+}
+
+/*
+Defines bench_typed_<name>, the typed_push and typed_get cases of one element type, each generic vec89 call next to
+the VEC89_DEFINE function replacing it. set(value, i) stores i in a value of the type, key(value) reads it back.
+*/
+#define BENCH_DEFINE_TYPED(name, vec_type, T, set, key) \
+static void bench_typed_##name(size_t size) { \
+	bench_case c; \
+	size_t i, ops = bench_settings.min_ops * 10; \
+	T value; \
+	memset(&value, 0, sizeof(value)); \
+\
+	if (bench_begin(&c, "typed_push", "vec89", sizeof(T), size, 1)) { \
+		while (bench_more(&c)) { \
+			vec v; \
+			VEC89_INITIALIZATION(&v, sizeof(T)); \
+			bench_start(&c); \
+			for (i = 0; i < size; i++) { \
+				set(value, i); \
+				VEC89_PUSH(&v, &value); \
+			} \
+			bench_stop(&c, size); \
+			VEC89_ARRAY_FREE(&v); \
+		} \
+		bench_end(&c); \
+	} \
+\
+	if (bench_begin(&c, "typed_push", "vec89_define", sizeof(T), size, 1)) { \
+		while (bench_more(&c)) { \
+			vec_type v; \
+			vec_type##_init(&v); \
+			bench_start(&c); \
+			for (i = 0; i < size; i++) { \
+				set(value, i); \
+				vec_type##_push(&v, value); \
+			} \
+			bench_stop(&c, size); \
+			vec_type##_array_free(&v); \
+		} \
+		bench_end(&c); \
+	} \
+\
+	if (bench_begin(&c, "typed_get", "vec89", sizeof(T), size, 1)) { \
+		vec_type v; \
+		vec_type##_init(&v); \
+		for (i = 0; i < size; i++) { \
+			set(value, i); \
+			vec_type##_push(&v, value); \
+		} \
+		while (bench_more(&c)) { \
+			size_t sum = 0, idx = 0; \
+			bench_start(&c); \
+			for (i = 0; i < ops; i++) { \
+				void *element; \
+				VEC89_GET(&v.base, idx, &element); \
+				sum += key(*(T *)element); \
+				if (++idx == size) idx = 0; \
+			} \
+			bench_stop(&c, ops); \
+			bench_sink += sum; \
+		} \
+		bench_end(&c); \
+\
+		if (bench_begin(&c, "typed_get", "vec89_define", sizeof(T), size, 1)) { \
+			while (bench_more(&c)) { \
+				size_t sum = 0, idx = 0; \
+				bench_start(&c); \
+				for (i = 0; i < ops; i++) { \
+					vec_type##_get(&v, idx, &value); \
+					sum += key(value); \
+					if (++idx == size) idx = 0; \
+				} \
+				bench_stop(&c, ops); \
+				bench_sink += sum; \
+			} \
+			bench_end(&c); \
+		} \
+		vec_type##_array_free(&v); \
+	} \
+}
+
+#define BENCH_SET_U32(value, i) ((value) = (unsigned int)(i))
+#define BENCH_SET_U64(value, i) ((value) = (unsigned long long)(i))
+#define BENCH_SET_BLOCK(value, i) ((value).words[0] = (value).words[3] = (unsigned long long)(i))
+#define BENCH_KEY_INT(value) ((size_t)(value))
+#define BENCH_KEY_BLOCK(value) ((size_t)(value).words[0])
+
+BENCH_DEFINE_TYPED(u32, bench_u32_vec, unsigned int, BENCH_SET_U32, BENCH_KEY_INT)
+BENCH_DEFINE_TYPED(u64, bench_u64_vec, unsigned long long, BENCH_SET_U64, BENCH_KEY_INT)
+BENCH_DEFINE_TYPED(block, bench_block_vec, bench_block, BENCH_SET_BLOCK, BENCH_KEY_BLOCK)
+
+static void bench_typed(size_t size) {
+	bench_typed_u32(size);
+	bench_typed_u64(size);
+	bench_typed_block(size);
+}
+
+static void bench_growth(size_t size) {
+	static const char *impls[] = { "double", "factor_150", "linear_64m", "auto_shrink" };
+	bench_case c;
+	size_t impl, i;
+
+	for (impl = 0; impl < 4; impl++) {
+		vec89_growth_policy policy;
+		if (!bench_begin(&c, "growth_push_pop", impls[impl], sizeof(size_t), size, 1)) continue;
+
+		memset(&policy, 0, sizeof(policy));
+		if (impl == 1) policy.factor_percent = 150;
+		if (impl == 2) {
+			policy.linear_threshold = (size_t)1 << 26;
+			policy.linear_step = (size_t)1 << 26;
+		}
+		if (impl == 3) {
+			policy.shrink_threshold_percent = 25;
+			policy.shrink_target_percent = 50;
+		}
+
+		while (bench_more(&c)) {
+			bench_counting counting = { 0, 0, 0, 0 };
+			vec89_allocator allocator;
+			size_t grow_reallocations, out = 0;
+			vec v;
+
+			allocator.alloc_function = bench_counting_alloc;
+			allocator.realloc_function = bench_counting_realloc;
+			allocator.free_function = bench_counting_free;
+			allocator.context = &counting;
+			VEC89_INITIALIZATION_ALLOCATOR(&v, sizeof(size_t), &allocator);
+			if (impl > 0) VEC89_SET_GROWTH_POLICY(&v, &policy);
+
+			bench_start(&c);
+			for (i = 0; i < size; i++) VEC89_PUSH(&v, &i);
+			grow_reallocations = counting.reallocations;
+			for (i = 0; i < size; i++) VEC89_POP_INTO(&v, &out);
+			bench_stop(&c, size * 2);
+			bench_sink += out;
+
+			bench_metric(&c, "peak_bytes", (double)counting.peak);
+			bench_metric(&c, "grow_reallocations", (double)grow_reallocations);
+			bench_metric(&c, "capacity_after_drain_bytes", (double)(v.capacity * v.elem_size));
+			VEC89_ARRAY_FREE(&v);
+		}
+		bench_end(&c);
+	}
+}
+
+static void bench_sort(size_t size) {
+	static const char *impls[] = { "vec89_sort_key", "vec89_sort", "vec89_define_sort", "qsort" };
+	bench_case c;
+	size_t impl, i, state = 0x5DEECE66D;
+	unsigned int *data = (unsigned int *)malloc(sizeof(unsigned int) * size);
+	bench_u32_vec v;
+
+	if (data == NULL) return;
+	for (i = 0; i < size; i++) data[i] = (unsigned int)bench_random(&state);
+	bench_u32_vec_init(&v);
+	VEC89_PUSH_N(&v.base, data, size);
+
+	for (impl = 0; impl < 4; impl++) {
+		if (!bench_begin(&c, "sort_u32", impls[impl], sizeof(unsigned int), size, 1)) continue;
+		while (bench_more(&c)) {
+			memcpy(v.base.arr, data, sizeof(unsigned int) * size);
+			bench_start(&c);
+			if (impl == 0) VEC89_SORT_KEY(&v.base, 0, VEC89_KEY_UINT32);
+			else if (impl == 1) VEC89_SORT(&v.base, bench_compare_u32);
+			else if (impl == 2) bench_u32_vec_sort(&v);
+			else qsort(v.base.arr, size, sizeof(unsigned int), bench_compare_u32);
+			bench_stop(&c, size);
+		}
+		bench_end(&c);
+	}
+
+	/* v is sorted now, search it for random keys */
+	for (impl = 0; impl < 3; impl++) {
+		static const char *search_impls[] = { "vec89_lower_bound", "vec89_define_lower_bound", "bsearch" };
+		if (!bench_begin(&c, "search_u32", search_impls[impl], sizeof(unsigned int), size, 1)) continue;
+		while (bench_more(&c)) {
+			size_t found = 0, idx;
+			bench_start(&c);
+			for (i = 0; i < BENCH_LOOKUPS; i++) {
+				unsigned int key = data[i % size];
+				if (impl == 0) VEC89_LOWER_BOUND(&v.base, &key, bench_compare_u32, &idx);
+				else if (impl == 1) bench_u32_vec_lower_bound(&v, key, &idx);
+				else idx = (size_t)((unsigned int *)bsearch(&key, v.base.arr, size, sizeof(unsigned int), bench_compare_u32) - (unsigned int *)v.base.arr);
+				found += idx;
+			}
+			bench_stop(&c, BENCH_LOOKUPS);
+			bench_sink += found;
+		}
+		bench_end(&c);
+	}
+
+	bench_u32_vec_array_free(&v);
+	free(data);
+}
+
+static void bench_simd(size_t elem_size, size_t size) {
+	static const char *impls[] = { "vec89_find", "get_loop", "memcmp_loop" };
+	bench_case c;
+	unsigned char absent[16], element[16];
+	size_t impl, i;
+	vec v;
+
+	memset(element, 0x11, sizeof(element));
+	memset(absent, 0x22, sizeof(absent));
+	VEC89_INITIALIZATION(&v, elem_size);
+	VEC89_RESERVE(&v, size);
+	for (i = 0; i < size; i++) VEC89_PUSH(&v, element);
+
+	/* Scanning for an absent element touches every element */
+	for (impl = 0; impl < 3; impl++) {
+		if (!bench_begin(&c, "find_absent", impls[impl], elem_size, size, 1)) continue;
+		while (bench_more(&c)) {
+			size_t idx = 0;
+			bench_start(&c);
+			if (impl == 0) VEC89_FIND(&v, absent, &idx);
+			else if (impl == 1) {
+				for (idx = 0; idx < size; idx++) {
+					void *current;
+					VEC89_GET(&v, idx, &current);
+					if (memcmp(current, absent, elem_size) == 0) break;
+				}
+			} else {
+				for (idx = 0; idx < size; idx++) if (memcmp(v.arr + elem_size * idx, absent, elem_size) == 0) break;
+			}
+			bench_stop(&c, size);
+			bench_sink += idx;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "count", "vec89_count", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			size_t count = 0;
+			bench_start(&c);
+			VEC89_COUNT(&v, element, &count);
+			bench_stop(&c, size);
+			bench_sink += count;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "fill", "vec89_fill", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			VEC89_FILL(&v, 0, size, element);
+			bench_stop(&c, size);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "fill", "set_loop", elem_size, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (i = 0; i < size; i++) VEC89_SET(&v, i, element);
+			bench_stop(&c, size);
+		}
+		bench_end(&c);
+	}
+
+	VEC89_ARRAY_FREE(&v);
+}
+
+#ifdef VEC89_PARALLEL_NOTC89
+static void bench_reduce_sum(void *accumulator, const void *elements, size_t n, void *context) {
+	const size_t *values = (const size_t *)elements;
+	size_t sum = *(size_t *)accumulator, i;
+	(void)context;
+	for (i = 0; i < n; i++) sum += values[i];
+	*(size_t *)accumulator = sum;
+}
+
+static void bench_combine_sum(void *accumulator, const void *partial, void *context) {
+	(void)context;
+	*(size_t *)accumulator += *(const size_t *)partial;
+}
+
+static int bench_compare_size(const void *a, const void *b) {
+	size_t x = *(const size_t *)a, y = *(const size_t *)b;
+	return (x > y) - (x < y);
+}
+
+static void bench_parallel(size_t size) {
+	vec89_thread_pool pool;
+	size_t *data, threads, i, state = 0xC0FFEE;
+	bench_case c;
+	vec v;
+
+	data = (size_t *)malloc(sizeof(size_t) * size);
+	if (data == NULL) return;
+	for (i = 0; i < size; i++) data[i] = bench_random(&state);
+	VEC89_INITIALIZATION(&v, sizeof(size_t));
+	VEC89_PUSH_N(&v, data, size);
+	VEC89_THREAD_POOL_INITIALIZATION(&pool, bench_settings.max_threads);
+
+	if (bench_begin(&c, "reduce_sum", "loop", sizeof(size_t), size, 1)) {
+		while (bench_more(&c)) {
+			size_t sum = 0;
+			bench_start(&c);
+			for (i = 0; i < size; i++) sum += ((size_t *)v.arr)[i];
+			bench_stop(&c, size);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+	}
+
+	for (threads = 1; threads <= bench_settings.max_threads; threads *= 2) {
+		if (bench_begin(&c, "reduce_sum", "vec89_parallel", sizeof(size_t), size, threads)) {
+			while (bench_more(&c)) {
+				size_t sum = 0;
+				bench_start(&c);
+				VEC89_PARALLEL_REDUCE(&pool, &v, &sum, sizeof(sum), bench_reduce_sum, bench_combine_sum, NULL, threads);
+				bench_stop(&c, size);
+				bench_sink += sum;
+			}
+			bench_end(&c);
+		}
+
+		if (bench_begin(&c, "parallel_sort", "vec89_parallel", sizeof(size_t), size, threads)) {
+			while (bench_more(&c)) {
+				memcpy(v.arr, data, sizeof(size_t) * size);
+				bench_start(&c);
+				VEC89_PARALLEL_SORT(&pool, &v, bench_compare_size, threads);
+				bench_stop(&c, size);
+			}
+			bench_end(&c);
+		}
+	}
+
+	VEC89_THREAD_POOL_DESTROY(&pool);
+	VEC89_ARRAY_FREE(&v);
+	free(data);
+}
+#endif
+
+/* Sliding window: push at the back, pop at the front, at a steady size */
+static void bench_fifo(size_t size) {
+	bench_case c;
+	size_t ops = bench_settings.min_ops, i;
+
+	if (bench_begin(&c, "fifo", "vec89_deque", sizeof(size_t), size, 1)) {
+		vec89_deque deque;
+		VEC89_DEQUE_INITIALIZATION(&deque, sizeof(size_t), NULL);
+		for (i = 0; i < size; i++) VEC89_DEQUE_PUSH_BACK(&deque, &i);
+		while (bench_more(&c)) {
+			size_t out = 0;
+			bench_start(&c);
+			for (i = 0; i < ops; i++) {
+				VEC89_DEQUE_PUSH_BACK(&deque, &i);
+				VEC89_DEQUE_POP_FRONT(&deque, &out);
+			}
+			bench_stop(&c, ops);
+			bench_sink += out;
+		}
+		bench_end(&c);
+		VEC89_DEQUE_ARRAY_FREE(&deque);
+	}
+
+	/* A plain vector pays a shift of the whole window per pop, only run it on small windows */
+	if (size <= 100000 && bench_begin(&c, "fifo", "vec89_remove_head", sizeof(size_t), size, 1)) {
+		vec v;
+		size_t window_ops = ops / (size / 1000 + 1) + 1;
+		VEC89_INITIALIZATION(&v, sizeof(size_t));
+		for (i = 0; i < size; i++) VEC89_PUSH(&v, &i);
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (i = 0; i < window_ops; i++) {
+				VEC89_PUSH(&v, &i);
+				VEC89_REMOVE(&v, 0);
+			}
+			bench_stop(&c, window_ops);
+		}
+		bench_end(&c);
+		VEC89_ARRAY_FREE(&v);
+	}
+}
+
+static void bench_segmented(size_t size) {
+	bench_case c;
+	size_t ops = bench_settings.min_ops * 10, i;
+
+	if (bench_begin(&c, "push", "vec89_segmented", sizeof(size_t), size, 1)) {
+		while (bench_more(&c)) {
+			vec89_segmented v;
+			VEC89_SEGMENTED_INITIALIZATION(&v, sizeof(size_t), NULL);
+			bench_start(&c);
+			for (i = 0; i < size; i++) VEC89_SEGMENTED_PUSH(&v, &i);
+			bench_stop(&c, size);
+			VEC89_SEGMENTED_ARRAY_FREE(&v);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "get", "vec89_segmented", sizeof(size_t), size, 1)) {
+		vec89_segmented v;
+		size_t state = 0xBEEF;
+		VEC89_SEGMENTED_INITIALIZATION(&v, sizeof(size_t), NULL);
+		for (i = 0; i < size; i++) VEC89_SEGMENTED_PUSH(&v, &i);
+		while (bench_more(&c)) {
+			size_t sum = 0;
+			bench_start(&c);
+			for (i = 0; i < ops; i++) {
+				void *element;
+				VEC89_SEGMENTED_GET(&v, bench_random(&state) % size, &element);
+				sum += *(size_t *)element;
+			}
+			bench_stop(&c, ops);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+
+		if (bench_begin(&c, "scan", "vec89_segmented_segment", sizeof(size_t), size, 1)) {
+			while (bench_more(&c)) {
+				size_t sum = 0, segment, n;
+				void *elements;
+				bench_start(&c);
+				for (segment = 0; VEC89_SEGMENTED_SEGMENT(&v, segment, &elements, &n) == VEC89_SUCCESS; segment++) {
+					for (i = 0; i < n; i++) sum += ((size_t *)elements)[i];
+				}
+				bench_stop(&c, size);
+				bench_sink += sum;
+			}
+			bench_end(&c);
+		}
+		VEC89_SEGMENTED_ARRAY_FREE(&v);
+	}
+}
+
+static void bench_row_fill(bench_row *row, size_t i) {
+	memset(row, 0, sizeof(*row));
+	row->key = (unsigned int)i;
+	row->flags = (unsigned int)(i & 7);
+	row->value = (double)i * 0.5;
+}
+
+/* Array of structs against struct of arrays on the same 64 byte records */
+static void bench_soa(size_t size) {
+	bench_case c;
+	bench_row row;
+	size_t i;
+
+	if (bench_begin(&c, "push", "vec89_aos", sizeof(bench_row), size, 1)) {
+		while (bench_more(&c)) {
+			vec v;
+			VEC89_INITIALIZATION(&v, sizeof(bench_row));
+			bench_start(&c);
+			for (i = 0; i < size; i++) {
+				bench_row_fill(&row, i);
+				VEC89_PUSH(&v, &row);
+			}
+			bench_stop(&c, size);
+			VEC89_ARRAY_FREE(&v);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "push", "vec89_soa", sizeof(bench_row), size, 1)) {
+		while (bench_more(&c)) {
+			vec89_soa soa;
+			VEC89_SOA_INITIALIZATION(&soa, bench_row_fields, BENCH_ROW_FIELDS, sizeof(bench_row), NULL);
+			bench_start(&c);
+			for (i = 0; i < size; i++) {
+				bench_row_fill(&row, i);
+				VEC89_SOA_PUSH(&soa, &row);
+			}
+			bench_stop(&c, size);
+			VEC89_SOA_ARRAY_FREE(&soa);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "scan_field", "vec89_aos", sizeof(bench_row), size, 1)) {
+		vec v;
+		vec89_view view;
+		VEC89_INITIALIZATION(&v, sizeof(bench_row));
+		for (i = 0; i < size; i++) {
+			bench_row_fill(&row, i);
+			VEC89_PUSH(&v, &row);
+		}
+		VEC89_VIEW(&v, 0, VEC89_VIEW_END_OF_VECTOR, 0, &view);
+		while (bench_more(&c)) {
+			const bench_row *rows = VEC89_VIEW_DATA(&view, bench_row);
+			size_t sum = 0;
+			bench_start(&c);
+			for (i = 0; i < view.count; i++) sum += rows[i].key;
+			bench_stop(&c, size);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+
+		if (bench_begin(&c, "scan_2_fields", "vec89_aos", sizeof(bench_row), size, 1)) {
+			while (bench_more(&c)) {
+				const bench_row *rows = VEC89_VIEW_DATA(&view, bench_row);
+				double sum = 0;
+				bench_start(&c);
+				for (i = 0; i < view.count; i++) sum += rows[i].key * rows[i].value;
+				bench_stop(&c, size);
+				bench_sink += (size_t)sum;
+			}
+			bench_end(&c);
+		}
+		VEC89_VIEW_RELEASE(&view);
+		VEC89_ARRAY_FREE(&v);
+	}
+
+	if (bench_begin(&c, "scan_field", "vec89_soa", sizeof(bench_row), size, 1)) {
+		vec89_soa soa;
+		vec89_view views[BENCH_ROW_FIELDS];
+		VEC89_SOA_INITIALIZATION(&soa, bench_row_fields, BENCH_ROW_FIELDS, sizeof(bench_row), NULL);
+		for (i = 0; i < size; i++) {
+			bench_row_fill(&row, i);
+			VEC89_SOA_PUSH(&soa, &row);
+		}
+		VEC89_SOA_VIEW(&soa, 0, VEC89_VIEW_END_OF_VECTOR, 0, views);
+		while (bench_more(&c)) {
+			const unsigned int *keys = VEC89_VIEW_DATA(&views[0], unsigned int);
+			size_t sum = 0;
+			bench_start(&c);
+			for (i = 0; i < views[0].count; i++) sum += keys[i];
+			bench_stop(&c, size);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+
+		if (bench_begin(&c, "scan_2_fields", "vec89_soa", sizeof(bench_row), size, 1)) {
+			while (bench_more(&c)) {
+				const unsigned int *keys = VEC89_VIEW_DATA(&views[0], unsigned int);
+				const double *values = VEC89_VIEW_DATA(&views[2], double);
+				double sum = 0;
+				bench_start(&c);
+				for (i = 0; i < views[0].count; i++) sum += keys[i] * values[i];
+				bench_stop(&c, size);
+				bench_sink += (size_t)sum;
+			}
+			bench_end(&c);
+		}
+		VEC89_SOA_VIEW_RELEASE(&soa, views);
+		VEC89_SOA_ARRAY_FREE(&soa);
+	}
+
+	/* Reassembling rows is the price of the columnar layout */
+	if (bench_begin(&c, "gather", "vec89_soa", sizeof(bench_row), size, 1)) {
+		vec89_soa soa;
+		bench_row *rows = malloc(sizeof(bench_row) * size);
+		VEC89_SOA_INITIALIZATION(&soa, bench_row_fields, BENCH_ROW_FIELDS, sizeof(bench_row), NULL);
+		for (i = 0; i < size; i++) {
+			bench_row_fill(&row, i);
+			VEC89_SOA_PUSH(&soa, &row);
+		}
+		while (rows != NULL && bench_more(&c)) {
+			bench_start(&c);
+			VEC89_SOA_GATHER(&soa, 0, rows, size);
+			bench_stop(&c, size);
+			bench_sink += rows[size - 1].key;
+		}
+		bench_end(&c);
+		free(rows);
+		VEC89_SOA_ARRAY_FREE(&soa);
+	}
+}
+
+/* Handing a copy of a vector to a reader, by hand and with VEC89_CLONE/VEC89_SNAPSHOT */
+static void bench_clone(size_t size) {
+	bench_case c;
+	vec v;
+	size_t i;
+
+	VEC89_INITIALIZATION(&v, sizeof(size_t));
+	for (i = 0; i < size; i++) VEC89_PUSH(&v, &i);
+
+	if (bench_begin(&c, "clone", "vec89_memcpy", sizeof(size_t), size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				vec copy;
+				VEC89_INITIALIZATION(&copy, sizeof(size_t));
+				VEC89_RESERVE(&copy, size);
+				memcpy(copy.arr, v.arr, sizeof(size_t) * size);
+				copy.count = size;
+				VEC89_ARRAY_FREE(&copy);
+			}
+			bench_stop(&c, n);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "clone", "vec89_clone", sizeof(size_t), size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				vec copy;
+				VEC89_CLONE(&v, &copy);
+				VEC89_ARRAY_FREE(&copy);
+			}
+			bench_stop(&c, n);
+		}
+		bench_end(&c);
+	}
+
+	/* The first write pays for the copy that copy-on-write deferred */
+	if (bench_begin(&c, "clone_write", "vec89_clone", sizeof(size_t), size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				vec copy;
+				VEC89_CLONE(&v, &copy);
+				VEC89_SET(&copy, 0, &r);
+				VEC89_ARRAY_FREE(&copy);
+			}
+			bench_stop(&c, n);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "snapshot", "vec89_snapshot", sizeof(size_t), size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				vec89_snapshot snapshot;
+				VEC89_SNAPSHOT(&v, &snapshot);
+				bench_sink += snapshot.count;
+				VEC89_SNAPSHOT_RELEASE(&snapshot);
+			}
+			bench_stop(&c, n);
+		}
+		bench_end(&c);
+	}
+
+	VEC89_ARRAY_FREE(&v);
+}
+
+/* Flat map entry for the sorted vector cases */
+typedef struct BENCH_ENTRY {
+	unsigned int key;
+	unsigned int value;
+} bench_entry;
+
+static void bench_sorted(size_t size) {
+	static const char *impls[] = { "vec89_insert_unique", "vec89_merge", "vec89_merge_batches" };
+	bench_case c;
+	size_t impl, i, state = 0x5DEECE66D;
+	bench_entry *entries = (bench_entry *)malloc(sizeof(bench_entry) * size);
+	vec89_sorted map;
+
+	if (entries == NULL) return;
+	for (i = 0; i < size; i++) {
+		entries[i].key = (unsigned int)bench_random(&state);
+		entries[i].value = (unsigned int)i;
+	}
+
+	for (impl = 0; impl < 3; impl++) {
+		/* Inserting one element at a time moves half the array per insert */
+		if (impl == 0 && size > 100000) continue;
+		if (!bench_begin(&c, "sorted_build", impls[impl], sizeof(bench_entry), size, 1)) continue;
+		while (bench_more(&c)) {
+			VEC89_SORTED_INITIALIZATION(&map, sizeof(bench_entry), 0, VEC89_KEY_UINT32, NULL, NULL);
+			bench_start(&c);
+			if (impl == 0) {
+				for (i = 0; i < size; i++) VEC89_SORTED_INSERT_UNIQUE(&map, &entries[i], NULL);
+			} else if (impl == 1) {
+				VEC89_SORTED_MERGE(&map, entries, size, 1, NULL);
+			} else {
+				for (i = 0; i < size; i += BENCH_MERGE_BATCH) {
+					VEC89_SORTED_MERGE(&map, entries + i, size - i < BENCH_MERGE_BATCH ? size - i : BENCH_MERGE_BATCH, 1, NULL);
+				}
+			}
+			bench_stop(&c, size);
+			bench_sink += map.vec.count;
+			VEC89_SORTED_ARRAY_FREE(&map);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "sorted_find", "vec89_sorted", sizeof(bench_entry), size, 1)) {
+		VEC89_SORTED_INITIALIZATION(&map, sizeof(bench_entry), 0, VEC89_KEY_UINT32, NULL, NULL);
+		VEC89_SORTED_MERGE(&map, entries, size, 1, NULL);
+		while (bench_more(&c)) {
+			size_t found = 0, idx;
+			bench_start(&c);
+			for (i = 0; i < BENCH_LOOKUPS; i++) {
+				VEC89_SORTED_FIND(&map, &entries[i % size].key, &idx);
+				found += idx;
+			}
+			bench_stop(&c, BENCH_LOOKUPS);
+			bench_sink += found;
+		}
+		bench_end(&c);
+		VEC89_SORTED_ARRAY_FREE(&map);
+	}
+
+	free(entries);
+}
+
+/* Packed bits against one byte per flag, with a random bit pattern of density 1/8 */
+static void bench_bits(size_t size) {
+	bench_case c;
+	size_t i, state = 0x5DEECE66D;
+	unsigned char *flags = (unsigned char *)malloc(size), *other_flags = (unsigned char *)malloc(size);
+	vec89_bits bits, other;
+
+	if (flags == NULL || other_flags == NULL) {
+		free(flags);
+		free(other_flags);
+		return;
+	}
+	VEC89_BITS_INITIALIZATION(&bits, NULL);
+	VEC89_BITS_INITIALIZATION(&other, NULL);
+	for (i = 0; i < size; i++) {
+		flags[i] = (unsigned char)(bench_random(&state) % 8 == 0);
+		other_flags[i] = (unsigned char)(bench_random(&state) % 2);
+		VEC89_BITS_PUSH(&bits, (char)flags[i]);
+		VEC89_BITS_PUSH(&other, (char)other_flags[i]);
+	}
+
+	if (bench_begin(&c, "bits_push", "vec89_bytes", 1, size, 1)) {
+		while (bench_more(&c)) {
+			vec v;
+			VEC89_INITIALIZATION(&v, 1);
+			bench_start(&c);
+			for (i = 0; i < size; i++) VEC89_PUSH(&v, &flags[i]);
+			bench_stop(&c, size);
+			VEC89_ARRAY_FREE(&v);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "bits_push", "vec89_bits", 1, size, 1)) {
+		while (bench_more(&c)) {
+			vec89_bits pushed;
+			VEC89_BITS_INITIALIZATION(&pushed, NULL);
+			bench_start(&c);
+			for (i = 0; i < size; i++) VEC89_BITS_PUSH(&pushed, (char)flags[i]);
+			bench_stop(&c, size);
+			VEC89_BITS_ARRAY_FREE(&pushed);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "bits_popcount", "byte_loop", 1, size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r, total = 0;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				for (i = 0; i < size; i++) total += flags[i];
+			}
+			bench_stop(&c, n * size);
+			bench_sink += total;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "bits_popcount", "vec89_bits", 1, size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r, total = 0, count;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				VEC89_BITS_POPCOUNT(&bits, &count);
+				total += count;
+			}
+			bench_stop(&c, n * size);
+			bench_sink += total;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "bits_and", "byte_loop", 1, size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				for (i = 0; i < size; i++) flags[i] &= other_flags[i];
+			}
+			bench_stop(&c, n * size);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "bits_and", "vec89_bits", 1, size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r;
+			bench_start(&c);
+			for (r = 0; r < n; r++) VEC89_BITS_AND(&bits, &other);
+			bench_stop(&c, n * size);
+		}
+		bench_end(&c);
+	}
+
+	/* Walks every set bit, about one in sixteen once the AND cases ran */
+	if (bench_begin(&c, "bits_scan_set", "byte_loop", 1, size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r, total = 0;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				for (i = 0; i < size; i++) {
+					if (flags[i]) total += i;
+				}
+			}
+			bench_stop(&c, n * size);
+			bench_sink += total;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "bits_scan_set", "vec89_bits", 1, size, 1)) {
+		while (bench_more(&c)) {
+			size_t n = bench_repeats(size), r, total = 0, idx;
+			bench_start(&c);
+			for (r = 0; r < n; r++) {
+				for (VEC89_BITS_FIND_FIRST_SET(&bits, &idx); idx < size; VEC89_BITS_FIND_NEXT_SET(&bits, idx + 1, &idx)) total += idx;
+			}
+			bench_stop(&c, n * size);
+			bench_sink += total;
+		}
+		bench_end(&c);
+	}
+
+	VEC89_BITS_ARRAY_FREE(&bits);
+	VEC89_BITS_ARRAY_FREE(&other);
+	free(flags);
+	free(other_flags);
+}
+
+void bench_features_suite(void) {
+	size_t s, e;
+
+	bench_allocators();
+	for (s = 0; bench_feature_sizes[s] != 0; s++) {
+		size_t size = bench_feature_sizes[s];
+		if (size > bench_settings.max_size) continue;
+
+		bench_typed(size);
+		bench_growth(size);
+		bench_sort(size);
+		bench_sorted(size);
+		for (e = 0; bench_simd_sizes[e] != 0; e++) bench_simd(bench_simd_sizes[e], size);
+#ifdef VEC89_PARALLEL_NOTC89
+		bench_parallel(size);
+#endif
+		bench_fifo(size);
+		bench_soa(size);
+		bench_clone(size);
+		bench_bits(size);
+		bench_segmented(size);
+	}
+}
\ No newline at end of file
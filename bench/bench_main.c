@@ -0,0 +1,329 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+/*
+vec89_bench: microbenchmarks of every vec89 operation against raw arrays and std::vector.
+The report is JSON on stdout (or --output), progress goes to stderr. Run "vec89_bench --help" for the options.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+#include "bench.h"
+#include "../include/vec89.h"
+
+#if defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89) && defined(VEC89_READ_SCALABLE_NOTC89)
+	#define BENCH_CONFIG "thread_safe_rw"
+#elif defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89)
+	#define BENCH_CONFIG "thread_safe"
+#elif defined(VEC89_COPY_ON_WRITE_NOTC89)
+	#define BENCH_CONFIG "copy_on_write"
+#else
+	#define BENCH_CONFIG "plain"
+#endif
+
+#if defined(__clang__)
+	#define BENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+	#define BENCH_COMPILER "gcc " __VERSION__
+#elif defined(_MSC_VER)
+	#define BENCH_COMPILER "msvc"
+#else
+	#define BENCH_COMPILER "unknown"
+#endif
+
+bench_settings_t bench_settings = {
+	1000000,			 /* max_size */
+	(size_t)1 << 28,	 /* max_bytes */
+	11,					 /* samples */
+	100000,				 /* min_ops */
+	8,					 /* max_threads */
+	NULL				 /* filter */
+};
+
+volatile size_t bench_sink;
+
+const size_t bench_sizes[] = { 10, 1000, 100000, 1000000, 10000000, 100000000, 0 };
+const size_t bench_elem_sizes[] = { 1, 4, 8, 16, 64, 256, 0 };
+
+double bench_timer_overhead;
+
+static FILE *bench_output;
+static size_t bench_result_count;
+
+static int bench_compare_double(const void *a, const void *b) {
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+double bench_now(void) {
+#ifdef _WIN32
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+size_t bench_peak_rss_kb(void) {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+	#ifdef __APPLE__
+	return (size_t)usage.ru_maxrss / 1024; /* Bytes on macOS */
+	#else
+	return (size_t)usage.ru_maxrss;
+	#endif
+#endif
+}
+
+int bench_begin(bench_case *c, const char *name, const char *impl, size_t elem_size, size_t size, size_t threads) {
+	if (bench_settings.filter != NULL && strstr(name, bench_settings.filter) == NULL) return 0;
+	if (size > bench_settings.max_size || threads > bench_settings.max_threads) return 0;
+	if (elem_size != 0 && size > bench_settings.max_bytes / elem_size) return 0;
+
+	c->name = name;
+	c->impl = impl;
+	c->elem_size = elem_size;
+	c->size = size;
+	c->threads = threads;
+	c->sample_count = 0;
+	c->metric_count = 0;
+	return 1;
+}
+
+int bench_more(bench_case *c) {
+	return c->sample_count < bench_settings.samples;
+}
+
+void bench_start(bench_case *c) {
+	c->start = bench_now();
+}
+
+void bench_stop(bench_case *c, size_t ops) {
+	bench_record(c, bench_elapsed(c->start), ops);
+}
+
+double bench_elapsed(double start) {
+	double elapsed = bench_now() - start - bench_timer_overhead;
+	return elapsed > 0 ? elapsed : 0;
+}
+
+void bench_record(bench_case *c, double elapsed, size_t ops) {
+	if (c->sample_count >= BENCH_MAX_SAMPLES) return;
+	c->samples[c->sample_count++] = elapsed / (double)(ops > 0 ? ops : 1);
+}
+
+/* Median cost of one bench_now call, subtracted from every timed interval */
+static void bench_calibrate(void) {
+	double costs[BENCH_MAX_SAMPLES];
+	size_t i, j;
+	for (i = 0; i < BENCH_MAX_SAMPLES; i++) {
+		double start = bench_now();
+		for (j = 0; j < 100; j++) bench_sink += (size_t)bench_now();
+		costs[i] = (bench_now() - start) / 101;
+	}
+	qsort(costs, BENCH_MAX_SAMPLES, sizeof(double), bench_compare_double);
+	bench_timer_overhead = costs[BENCH_MAX_SAMPLES / 2];
+}
+
+void bench_metric(bench_case *c, const char *name, double value) {
+	size_t i;
+	/* Every sample reports its metrics again, the last sample's values are kept */
+	for (i = 0; i < c->metric_count; i++) {
+		if (strcmp(c->metric_names[i], name) == 0) {
+			c->metric_values[i] = value;
+			return;
+		}
+	}
+	if (c->metric_count >= BENCH_MAX_METRICS) return;
+	c->metric_names[c->metric_count] = name;
+	c->metric_values[c->metric_count] = value;
+	c->metric_count++;
+}
+
+/* Nearest-rank percentile of sorted samples */
+static double bench_percentile(const double *sorted, size_t n, size_t percent) {
+	size_t rank = (percent * n + 99) / 100;
+	if (rank == 0) rank = 1;
+	return sorted[rank - 1];
+}
+
+void bench_end(bench_case *c) {
+	double sorted[BENCH_MAX_SAMPLES], sum = 0;
+	size_t i, n = c->sample_count;
+	if (n == 0) return;
+
+	memcpy(sorted, c->samples, sizeof(double) * n);
+	qsort(sorted, n, sizeof(double), bench_compare_double);
+	for (i = 0; i < n; i++) sum += sorted[i];
+
+	fprintf(bench_output, "%s\n    {\"name\": \"%s\", \"impl\": \"%s\", \"elem_size\": %lu, \"size\": %lu, \"threads\": %lu, \"samples\": %lu, ",
+		bench_result_count > 0 ? "," : "", c->name, c->impl, (unsigned long)c->elem_size, (unsigned long)c->size, (unsigned long)c->threads, (unsigned long)n);
+	fprintf(bench_output, "\"ns_per_op\": %.3f, \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"peak_rss_kb\": %lu",
+		sum / (double)n, sorted[0], bench_percentile(sorted, n, 50), bench_percentile(sorted, n, 90), bench_percentile(sorted, n, 99), (unsigned long)bench_peak_rss_kb());
+	if (c->metric_count > 0) {
+		fprintf(bench_output, ", \"metrics\": {");
+		for (i = 0; i < c->metric_count; i++) fprintf(bench_output, "%s\"%s\": %.3f", i > 0 ? ", " : "", c->metric_names[i], c->metric_values[i]);
+		fprintf(bench_output, "}");
+	}
+	fprintf(bench_output, "}");
+	fflush(bench_output);
+	bench_result_count++;
+
+	fprintf(stderr, "%-24s %-20s %4luB x %-10lu t%-2lu %12.3f ns/op (p50 %.3f)\n",
+		c->name, c->impl, (unsigned long)c->elem_size, (unsigned long)c->size, (unsigned long)c->threads, sum / (double)n, bench_percentile(sorted, n, 50));
+}
+
+size_t bench_repeats(size_t size) {
+	if (size == 0 || size >= bench_settings.min_ops) return 1;
+	return bench_settings.min_ops / size;
+}
+
+size_t bench_random(size_t *state) {
+	/* xorshift64* on 64-bit size_t, xorshift32 otherwise */
+	size_t x = *state;
+	if (sizeof(size_t) >= 8) {
+		x ^= x >> 12;
+		x ^= x << 25;
+		x ^= x >> 27;
+		*state = x;
+		return (size_t)((unsigned long long)x * 2685821657736338717ULL >> 16);
+	}
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+void bench_random_bytes(void *out, size_t n, size_t *state) {
+	unsigned char *bytes = (unsigned char *)out;
+	size_t i;
+	for (i = 0; i < n; i++) bytes[i] = (unsigned char)(bench_random(state) >> 8);
+}
+
+static size_t bench_parse_size(const char *text) {
+	char *end;
+	double value = strtod(text, &end);
+	if (*end == 'k' || *end == 'K') value *= 1e3;
+	else if (*end == 'm' || *end == 'M') value *= 1e6;
+	else if (*end == 'g' || *end == 'G') value *= 1e9;
+	return value < 0 ? 0 : (size_t)value;
+}
+
+static void bench_usage(const char *program) {
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  --quick             sizes up to 100k, 5 samples\n"
+		"  --full              sizes up to 100M, arrays up to 4G\n"
+		"  --max-size N        largest element count (default 1M, suffixes k/M/G)\n"
+		"  --max-bytes N       skip cases with larger arrays (default 256M)\n"
+		"  --samples N         timed samples per case (default 11)\n"
+		"  --threads N         largest thread count of contention cases (default 8)\n"
+		"  --filter NAME       only run cases whose name contains NAME\n"
+		"  --suite NAME        only run the core, threads, features or std_vector suite\n"
+		"  --output FILE       write the JSON report to FILE instead of stdout\n",
+		program);
+}
+
+int main(int argc, char **argv) {
+	const char *suite = NULL, *output_path = NULL;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+		if (strcmp(argv[i], "--quick") == 0) {
+			bench_settings.max_size = 100000;
+			bench_settings.samples = 5;
+		} else if (strcmp(argv[i], "--full") == 0) {
+			bench_settings.max_size = 100000000;
+			bench_settings.max_bytes = sizeof(size_t) >= 8 ? ((size_t)1 << 31) * 2 : (size_t)-1;
+		} else if (value != NULL && strcmp(argv[i], "--max-size") == 0) {
+			bench_settings.max_size = bench_parse_size(value), i++;
+		} else if (value != NULL && strcmp(argv[i], "--max-bytes") == 0) {
+			bench_settings.max_bytes = bench_parse_size(value), i++;
+		} else if (value != NULL && strcmp(argv[i], "--samples") == 0) {
+			bench_settings.samples = bench_parse_size(value), i++;
+		} else if (value != NULL && strcmp(argv[i], "--threads") == 0) {
+			bench_settings.max_threads = bench_parse_size(value), i++;
+		} else if (value != NULL && strcmp(argv[i], "--filter") == 0) {
+			bench_settings.filter = value, i++;
+		} else if (value != NULL && strcmp(argv[i], "--suite") == 0) {
+			suite = value, i++;
+		} else if (value != NULL && strcmp(argv[i], "--output") == 0) {
+			output_path = value, i++;
+		} else {
+			bench_usage(argv[0]);
+			return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+		}
+	}
+	if (bench_settings.samples == 0) bench_settings.samples = 1;
+	if (bench_settings.samples > BENCH_MAX_SAMPLES) bench_settings.samples = BENCH_MAX_SAMPLES;
+	if (bench_settings.max_threads == 0) bench_settings.max_threads = 1;
+
+	bench_calibrate();
+	bench_output = stdout;
+	if (output_path != NULL) {
+		bench_output = fopen(output_path, "w");
+		if (bench_output == NULL) {
+			fprintf(stderr, "can't open %s\n", output_path);
+			return 1;
+		}
+	}
+
+	fprintf(bench_output, "{\n  \"benchmark\": \"vec89_bench\",\n  \"config\": \"%s\",\n  \"compiler\": \"%s\",\n  \"unix_time\": %lu,\n  \"timer_overhead_ns\": %.3f,\n",
+		BENCH_CONFIG, BENCH_COMPILER, (unsigned long)time(NULL), bench_timer_overhead);
+	fprintf(bench_output, "  \"settings\": {\"max_size\": %lu, \"max_bytes\": %lu, \"samples\": %lu, \"min_ops\": %lu, \"max_threads\": %lu},\n  \"results\": [",
+		(unsigned long)bench_settings.max_size, (unsigned long)bench_settings.max_bytes, (unsigned long)bench_settings.samples,
+		(unsigned long)bench_settings.min_ops, (unsigned long)bench_settings.max_threads);
+
+	if (suite == NULL || strcmp(suite, "core") == 0) bench_core_suite();
+#ifdef VEC89_BENCH_STD_VECTOR
+	if (suite == NULL || strcmp(suite, "std_vector") == 0) bench_std_vector_suite();
+#endif
+	if (suite == NULL || strcmp(suite, "threads") == 0) bench_threads_suite();
+	if (suite == NULL || strcmp(suite, "features") == 0) bench_features_suite();
+
+	fprintf(bench_output, "\n  ],\n  \"peak_rss_kb\": %lu\n}\n", (unsigned long)bench_peak_rss_kb());
+	if (bench_output != stdout) fclose(bench_output);
+	return 0;
+}
\ No newline at end of file
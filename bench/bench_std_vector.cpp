@@ -0,0 +1,208 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+/*
+std::vector baseline for the core suite. Elements are fixed-size byte arrays so every element size of the sweep
+gets its own instantiation with a compile-time size, which is the best case for std::vector.
+*/
+
+#include <cstring>
+#include <vector>
+
+#include "bench.h"
+
+namespace {
+
+const std::size_t index_count = 4096;
+
+template <std::size_t N>
+struct element {
+	unsigned char bytes[N];
+};
+
+template <std::size_t N>
+void run(std::size_t size) {
+	typedef element<N> T;
+	std::vector<std::size_t> indices(index_count);
+	std::size_t state = 0x9E3779B9, i, r;
+	std::size_t repeats = bench_repeats(size);
+	T value;
+	bench_case c;
+
+	std::memset(value.bytes, 0x5A, N);
+	for (i = 0; i < index_count; i++) indices[i] = bench_random(&state) % size;
+
+	if (bench_begin(&c, "push", "std_vector", N, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (r = 0; r < repeats; r++) {
+				std::vector<T> v;
+				for (i = 0; i < size; i++) v.push_back(value);
+				bench_sink += v.size();
+			}
+			bench_stop(&c, repeats * size);
+		}
+		bench_end(&c);
+	}
+
+	std::vector<T> v(size, value);
+	std::size_t ops = bench_settings.min_ops * 10;
+
+	if (bench_begin(&c, "get", "std_vector", N, size, 1)) {
+		while (bench_more(&c)) {
+			std::size_t sum = 0;
+			bench_start(&c);
+			for (i = 0; i < ops; i++) sum += v[indices[i & (index_count - 1)]].bytes[0];
+			bench_stop(&c, ops);
+			bench_sink += sum;
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "set", "std_vector", N, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (i = 0; i < ops; i++) v[indices[i & (index_count - 1)]] = value;
+			bench_stop(&c, ops);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "pop", "std_vector", N, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0;
+			T out = value;
+			for (r = 0; r < repeats; r++) {
+				v.resize(size, value);
+				double start = bench_now();
+				for (i = 0; i < size; i++) {
+					out = v.back();
+					v.pop_back();
+				}
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats * size);
+			bench_sink += out.bytes[0];
+		}
+		bench_end(&c);
+	}
+
+	/* Same batching as the core suite, see bench_insert_remove */
+	static const char *insert_names[] = { "insert_head", "insert_middle", "insert_tail" };
+	static const char *remove_names[] = { "remove_head", "remove_middle", "remove_tail" };
+	std::size_t batch = size / 8 + 1;
+	v.resize(size, value);
+	v.reserve(size + batch);
+
+	for (int where = 0; where < 3; where++) {
+		std::size_t moved = where == 0 ? N * size : where == 1 ? N * size / 2 : N;
+		std::size_t where_ops = (std::size_t(1) << 26) / moved;
+		if (where_ops > bench_settings.min_ops) where_ops = bench_settings.min_ops;
+		if (where_ops == 0) where_ops = 1;
+
+		if (bench_begin(&c, insert_names[where], "std_vector", N, size, 1)) {
+			while (bench_more(&c)) {
+				double elapsed = 0;
+				for (std::size_t done = 0; done < where_ops; done += batch) {
+					std::size_t n = batch < where_ops - done ? batch : where_ops - done;
+					double start = bench_now();
+					for (i = 0; i < n; i++) v.insert(v.begin() + (where == 0 ? 0 : where == 1 ? v.size() / 2 : v.size()), value);
+					elapsed += bench_elapsed(start);
+					v.resize(size);
+				}
+				bench_record(&c, elapsed, where_ops);
+			}
+			bench_end(&c);
+		}
+
+		if (bench_begin(&c, remove_names[where], "std_vector", N, size, 1)) {
+			while (bench_more(&c)) {
+				double elapsed = 0;
+				for (std::size_t done = 0; done < where_ops; done += batch) {
+					std::size_t n = batch < where_ops - done ? batch : where_ops - done;
+					v.resize(size + n, value);
+					double start = bench_now();
+					for (i = 0; i < n; i++) {
+						std::size_t idx = where == 0 ? 0 : where == 1 ? v.size() / 2 : v.size() - 1;
+						v.erase(v.begin() + idx);
+					}
+					elapsed += bench_elapsed(start);
+				}
+				bench_record(&c, elapsed, where_ops);
+			}
+			bench_end(&c);
+		}
+	}
+
+	if (bench_begin(&c, "reserve", "std_vector", N, size, 1)) {
+		while (bench_more(&c)) {
+			bench_start(&c);
+			for (r = 0; r < repeats; r++) {
+				std::vector<T> reserved;
+				reserved.reserve(size);
+				bench_sink += reserved.capacity();
+			}
+			bench_stop(&c, repeats);
+		}
+		bench_end(&c);
+	}
+
+	if (bench_begin(&c, "shrink_to_fit", "std_vector", N, size, 1)) {
+		while (bench_more(&c)) {
+			double elapsed = 0;
+			for (r = 0; r < repeats; r++) {
+				v.reserve(size * 2);
+				double start = bench_now();
+				v.shrink_to_fit();
+				elapsed += bench_elapsed(start);
+			}
+			bench_record(&c, elapsed, repeats);
+		}
+		bench_end(&c);
+	}
+}
+
+void run_size(std::size_t elem_size, std::size_t size) {
+	switch (elem_size) {
+	case 1: run<1>(size); break;
+	case 4: run<4>(size); break;
+	case 8: run<8>(size); break;
+	case 16: run<16>(size); break;
+	case 64: run<64>(size); break;
+	case 256: run<256>(size); break;
+	default: break;
+	}
+}
+
+}
+
+extern "C" void bench_std_vector_suite(void) {
+	for (std::size_t e = 0; bench_elem_sizes[e] != 0; e++) {
+		for (std::size_t s = 0; bench_sizes[s] != 0; s++) {
+			std::size_t elem_size = bench_elem_sizes[e], size = bench_sizes[s];
+			if (size > bench_settings.max_size || size > bench_settings.max_bytes / elem_size) continue;
+			run_size(elem_size, size);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+/*
+Threads suite: contention on one shared vector. Cases report wall time divided by the operations of all threads,
+so a lock that scales keeps ns/op falling as threads are added. Locked cases only run in thread-safe builds, compare
+the thread_safe and thread_safe_rw reports for the reader-writer lock.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
+
+#include "bench.h"
+#include "../include/vec89.h"
+
+#define min(a, b) ((a) > (b) ? (b) : (a))
+
+#ifdef VEC89_ATOMIC_LOAD
+
+#define BENCH_MAX_THREADS 64
+#define BENCH_SHARED_SIZE 100000 /* Elements of the vector readers and writers share */
+
+/* Operations of all threads per sample, push cases end with this many elements so it's capped by max_size */
+#define BENCH_THREAD_OPS min(bench_settings.min_ops * 10, bench_settings.max_size)
+
+#define BENCH_KIND_PUSH 0
+#define BENCH_KIND_GET 1
+#define BENCH_KIND_MIXED 2
+#define BENCH_KIND_READ_SECTION 3
+#define BENCH_KIND_PRIVATE_PUSH 4
+#define BENCH_KIND_CONCURRENT_PUSH 5
+
+typedef struct BENCH_WORKER {
+	int kind;
+	size_t ops;
+	size_t seed;
+	void *target;	/* Shared vector, or NULL for private work */
+	size_t *go;		/* Workers spin until this is non-zero */
+#ifdef _WIN32
+	HANDLE thread;
+#else
+	pthread_t thread;
+#endif
+} bench_worker;
+
+static void bench_worker_run(bench_worker *w) {
+	size_t i, sum = 0, value = 0, seed = w->seed;
+
+	while (!VEC89_ATOMIC_LOAD(w->go)) VEC89_CPU_RELAX();
+
+	switch (w->kind) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	case BENCH_KIND_PUSH:
+		for (i = 0; i < w->ops; i++) VEC89_PUSH((vec_p)w->target, &i);
+		break;
+	case BENCH_KIND_GET:
+		for (i = 0; i < w->ops; i++) {
+			VEC89_GET_COPY((vec_p)w->target, bench_random(&seed) % BENCH_SHARED_SIZE, &value);
+			sum += value;
+		}
+		break;
+	case BENCH_KIND_MIXED:
+		for (i = 0; i < w->ops; i++) {
+			size_t r = bench_random(&seed);
+			if (r % 10 == 0) VEC89_SET((vec_p)w->target, (r >> 8) % BENCH_SHARED_SIZE, &i);
+			else VEC89_GET_COPY((vec_p)w->target, (r >> 8) % BENCH_SHARED_SIZE, &value);
+			sum += value;
+		}
+		break;
+	case BENCH_KIND_READ_SECTION:
+		/* One operation reads 64 consecutive elements under a single lock acquisition */
+		for (i = 0; i < w->ops; i++) {
+			const void *arr;
+			size_t count, first = bench_random(&seed) % (BENCH_SHARED_SIZE - 64), j;
+			VEC89_READ_BEGIN((vec_p)w->target, &arr, &count);
+			for (j = 0; j < 64; j++) sum += ((const size_t *)arr)[first + j];
+			VEC89_READ_END((vec_p)w->target);
+		}
+		break;
+#endif
+#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+	case BENCH_KIND_CONCURRENT_PUSH:
+		for (i = 0; i < w->ops; i++) VEC89_CONCURRENT_PUSH((vec89_concurrent_p)w->target, &i, NULL);
+		break;
+#endif
+	case BENCH_KIND_PRIVATE_PUSH: {
+		size_t capacity = 16, count = 0;
+		size_t *arr = (size_t *)malloc(sizeof(size_t) * capacity);
+		for (i = 0; i < w->ops && arr != NULL; i++) {
+			if (count == capacity) {
+				size_t *grown = (size_t *)realloc(arr, sizeof(size_t) * capacity * 2);
+				if (grown == NULL) break;
+				arr = grown;
+				capacity *= 2;
+			}
+			arr[count++] = i;
+		}
+		sum += count;
+		free(arr);
+		break;
+	}
+	default:
+		break;
+	}
+
+	w->seed = seed;
+	bench_sink += sum + value;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI bench_worker_main(LPVOID argument) {
+	bench_worker_run((bench_worker *)argument);
+	return 0;
+}
+#else
+static void *bench_worker_main(void *argument) {
+	bench_worker_run((bench_worker *)argument);
+	return NULL;
+}
+#endif
+
+/* Runs threads workers of a kind doing total_ops operations together, returns the wall time of the parallel part */
+static double bench_run_threads(int kind, void *target, size_t threads, size_t total_ops) {
+	bench_worker workers[BENCH_MAX_THREADS];
+	size_t go = 0, i;
+	double start;
+
+	for (i = 0; i < threads; i++) {
+		workers[i].kind = kind;
+		workers[i].ops = total_ops / threads;
+		workers[i].seed = 0x2545F491 + i * 7919;
+		workers[i].target = target;
+		workers[i].go = &go;
+#ifdef _WIN32
+		workers[i].thread = CreateThread(NULL, 0, bench_worker_main, &workers[i], 0, NULL);
+#else
+		pthread_create(&workers[i].thread, NULL, bench_worker_main, &workers[i]);
+#endif
+	}
+
+	start = bench_now();
+	VEC89_ATOMIC_STORE(&go, 1);
+	for (i = 0; i < threads; i++) {
+#ifdef _WIN32
+		WaitForSingleObject(workers[i].thread, INFINITE);
+		CloseHandle(workers[i].thread);
+#else
+		pthread_join(workers[i].thread, NULL);
+#endif
+	}
+	return bench_elapsed(start);
+}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+static void bench_shared_fill(vec_p v) {
+	size_t i;
+	VEC89_INITIALIZATION(v, sizeof(size_t));
+	VEC89_RESERVE(v, BENCH_SHARED_SIZE);
+	for (i = 0; i < BENCH_SHARED_SIZE; i++) VEC89_PUSH(v, &i);
+}
+
+static void bench_locked(const char *name, const char *impl, int kind, char policy, size_t threads) {
+	bench_case c;
+	size_t ops = BENCH_THREAD_OPS;
+
+	if (!bench_begin(&c, name, impl, sizeof(size_t), kind == BENCH_KIND_PUSH ? ops : BENCH_SHARED_SIZE, threads)) return;
+	while (bench_more(&c)) {
+		vec v;
+		if (kind == BENCH_KIND_PUSH) VEC89_INITIALIZATION(&v, sizeof(size_t));
+		else bench_shared_fill(&v);
+		VEC89_SET_LOCK_POLICY(&v, policy);
+		bench_record(&c, bench_run_threads(kind, &v, threads, ops), ops - ops % threads);
+		VEC89_ARRAY_FREE(&v);
+	}
+	bench_end(&c);
+}
+#endif
+
+void bench_threads_suite(void) {
+	size_t threads, ops = BENCH_THREAD_OPS;
+	bench_case c;
+
+	for (threads = 1; threads <= bench_settings.max_threads && threads <= BENCH_MAX_THREADS; threads *= 2) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		bench_locked("mt_push", "vec89_mutex", BENCH_KIND_PUSH, VEC89_LOCK_POLICY_MUTEX, threads);
+		bench_locked("mt_push", "vec89_adaptive", BENCH_KIND_PUSH, VEC89_LOCK_POLICY_ADAPTIVE, threads);
+		bench_locked("mt_push", "vec89_spin", BENCH_KIND_PUSH, VEC89_LOCK_POLICY_SPIN, threads);
+		bench_locked("mt_get", "vec89", BENCH_KIND_GET, VEC89_LOCK_POLICY_DEFAULT, threads);
+		bench_locked("mt_get_set_90_10", "vec89", BENCH_KIND_MIXED, VEC89_LOCK_POLICY_DEFAULT, threads);
+		bench_locked("mt_read_section_64", "vec89", BENCH_KIND_READ_SECTION, VEC89_LOCK_POLICY_DEFAULT, threads);
+#endif
+#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+		if (bench_begin(&c, "mt_push", "vec89_concurrent", sizeof(size_t), ops, threads)) {
+			while (bench_more(&c)) {
+				vec89_concurrent v;
+				VEC89_CONCURRENT_INITIALIZATION(&v, sizeof(size_t), NULL);
+				bench_record(&c, bench_run_threads(BENCH_KIND_CONCURRENT_PUSH, &v, threads, ops), ops - ops % threads);
+				VEC89_CONCURRENT_ARRAY_FREE(&v);
+			}
+			bench_end(&c);
+		}
+#endif
+		if (bench_begin(&c, "mt_push", "array_per_thread", sizeof(size_t), ops, threads)) {
+			while (bench_more(&c)) bench_record(&c, bench_run_threads(BENCH_KIND_PRIVATE_PUSH, NULL, threads, ops), ops - ops % threads);
+			bench_end(&c);
+		}
+	}
+}
+
+#else
+
+void bench_threads_suite(void) {
+	/* Needs the atomics enabled by VEC89_CONCURRENT_APPEND_NOTC89 or VEC89_PARALLEL_NOTC89 */
+}
+
+#endif
\ No newline at end of file
@@ -22,451 +22,3741 @@
 	*	SOFTWARE.
 */
 
+#if (defined(VEC89_MMAP_NOTC89) || defined(VEC89_FILE_BACKED_NOTC89)) && !defined(_GNU_SOURCE)
+	#define _GNU_SOURCE /* mremap, pread, pwrite */
+#endif
+#if defined(VEC89_STATS) && defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89) && !defined(_MSC_VER) && defined(__STRICT_ANSI__) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+	#define _POSIX_C_SOURCE 200112L /* clock_gettime */
+#endif
+
 #include "vec89.h"
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(VEC89_STATS) && defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89) && !defined(_MSC_VER)
+	#include <time.h>
+#endif
+
+#ifdef VEC89_MMAP_NOTC89
+	#ifndef __linux__
+		#error "VEC89_MMAP_NOTC89 requires Linux (mremap)"
+	#endif
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+#ifdef VEC89_FILE_BACKED_NOTC89
+	#ifdef _WIN32
+		#error "VEC89_FILE_BACKED_NOTC89 requires a POSIX system (mmap)"
+	#endif
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
 #define min(a, b) ((a) > (b) ? (b) : (a))
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
 #define MALLOC_FUNCTION(Size) malloc(Size)
 #define REALLOC_FUNCTION(Block, Size) realloc(Block, Size)
+#define FREE_FUNCTION(Block) free(Block)
 
-char VEC89_INITIALIZATION(vec_p vec, size_t element_size) {
-	if (vec == NULL || element_size == 0 || VEC89_DEFAULT_CAPACITY < 0) return VEC89_INVALID_ARGUMENTS;
+/* Vectors without an attached allocator skip the indirect call and use the functions above */
+#define VEC89_ALLOCATE(vec, Size) ((vec)->allocator != NULL ? (vec)->allocator->alloc_function((vec)->allocator->context, Size) : MALLOC_FUNCTION(Size))
+#define VEC89_REALLOCATE(vec, Block, OldSize, NewSize) ((vec)->allocator != NULL ? (vec)->allocator->realloc_function((vec)->allocator->context, Block, OldSize, NewSize) : REALLOC_FUNCTION(Block, NewSize))
+#define VEC89_DEALLOCATE(vec, Block, Size) ((vec)->allocator != NULL ? (vec)->allocator->free_function((vec)->allocator->context, Block, Size) : FREE_FUNCTION(Block))
+
+#define VEC89_SIZE_MAX ((size_t)-1)
+
+#ifdef VEC89_STATS
+#define VEC89_STATS_ADD(vec, Field, Amount) ((vec)->stats.Field += (Amount))
+
+static vec_p vec89_stats_registry;			/* Most recently initialized live vector */
+static vec89_stats_hook vec89_stats_hook_function;
+static void *vec89_stats_hook_context;
+#ifdef VEC89_ATOMIC_EXCHANGE
+static size_t vec89_stats_registry_spin;	/* Guards the registry */
+#endif
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+/* Monotonic clock in nanoseconds for lock wait times */
+static size_t vec89_stats_now(void) {
+#ifdef _MSC_VER
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (size_t)(counter.QuadPart / frequency.QuadPart * 1000000000 + counter.QuadPart % frequency.QuadPart * 1000000000 / frequency.QuadPart);
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (size_t)now.tv_sec * 1000000000 + (size_t)now.tv_nsec;
+#endif
+}
+#endif
+#else
+#define VEC89_STATS_ADD(vec, Field, Amount) ((void)0)
+#endif
+
+#ifdef VEC89_MMAP_NOTC89
+static size_t vec89_page_round(size_t size) {
+	static size_t page_size = 0;
+	if (page_size == 0) page_size = (size_t)sysconf(_SC_PAGESIZE);
+	if (size > VEC89_SIZE_MAX - (page_size - 1)) return 0;
+	return (size + page_size - 1) & ~(page_size - 1);
+}
+
+static void *vec89_map(size_t size) {
+	void *block = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (block == MAP_FAILED) return NULL;
+#ifdef VEC89_MMAP_HUGEPAGE
+	madvise(block, size, MADV_HUGEPAGE);
+#endif
+	return block;
+}
+
+/*
+Moves a large array into its own mapping or resizes a mapped one. Mapped arrays grow and shrink with mremap,
+the kernel moves page tables instead of copying elements and shrinking returns the tail pages.
+Arrays that drop below the threshold go back to the heap. Returns NULL if the vector should use the heap.
+*/
+static void *vec89_array_remap(vec_p vec, size_t new_size, char *out_failed) {
+	size_t old_size = vec->elem_size * vec->capacity;
+	*out_failed = 0;
+
+	if (!vec->mapped) {
+		if (vec->allocator != NULL || vec->mmap_threshold == 0 || new_size < vec->mmap_threshold) return NULL;
+
+		size_t map_size = vec89_page_round(new_size);
+		void *block = map_size > 0 ? vec89_map(map_size) : NULL;
+		if (block == NULL) return NULL; /* Fall back to the heap */
+
+		memcpy(block, vec->arr, vec->elem_size * min(vec->count, new_size / vec->elem_size));
+		VEC89_DEALLOCATE(vec, vec->arr, old_size);
+		vec->mapped = 1;
+		return block;
+	}
+
+	if (new_size < vec->mmap_threshold / 2) {
+		void *heap_block = VEC89_ALLOCATE(vec, new_size);
+		if (heap_block == NULL) {
+			*out_failed = 1;
+			return NULL;
+		}
+		memcpy(heap_block, vec->arr, vec->elem_size * min(vec->count, new_size / vec->elem_size));
+		munmap(vec->arr, vec89_page_round(old_size));
+		vec->mapped = 0;
+		return heap_block;
+	}
+
+	size_t old_map_size = vec89_page_round(old_size);
+	size_t new_map_size = vec89_page_round(new_size);
+	if (new_map_size == 0) {
+		*out_failed = 1;
+		return NULL;
+	}
+	if (new_map_size == old_map_size) return vec->arr;
+
+	void *block = mremap(vec->arr, old_map_size, new_map_size, MREMAP_MAYMOVE);
+	if (block == MAP_FAILED) {
+		*out_failed = 1;
+		return NULL;
+	}
+#ifdef VEC89_MMAP_HUGEPAGE
+	madvise(block, new_map_size, MADV_HUGEPAGE);
+#endif
+	return block;
+}
+#endif
+
+#ifdef VEC89_FILE_BACKED_NOTC89
+#define VEC89_FILE_HEADER(vec) ((vec89_file_header *)((vec)->arr - VEC89_FILE_HEADER_SIZE))
+
+/*
+Resizes the file of a file-backed vector and maps it again. The new mapping is made before the old one is dropped,
+both view the same pages, so nothing is copied. Returns NULL on failure, the old array is then left untouched.
+*/
+static void *vec89_file_remap(vec_p vec, size_t new_size) {
+	if (vec->file_mode == VEC89_FILE_READ_ONLY || new_size > VEC89_SIZE_MAX - VEC89_FILE_HEADER_SIZE) return NULL;
+
+	size_t old_file_size = VEC89_FILE_HEADER_SIZE + vec->elem_size * vec->capacity;
+	size_t new_file_size = VEC89_FILE_HEADER_SIZE + new_size;
+
+	if (new_file_size > old_file_size && ftruncate(vec->file, (off_t)new_file_size) != 0) return NULL;
+
+	char *block = mmap(NULL, new_file_size, PROT_READ | PROT_WRITE, MAP_SHARED, vec->file, 0);
+	if (block == MAP_FAILED) {
+		if (new_file_size > old_file_size) (void)ftruncate(vec->file, (off_t)old_file_size);
+		return NULL;
+	}
+
+	munmap(vec->arr - VEC89_FILE_HEADER_SIZE, old_file_size);
+	if (new_file_size < old_file_size) (void)ftruncate(vec->file, (off_t)new_file_size);
+
+	/* The count is only written by syncs, a shrink clamps it so the file still opens if the process dies before the next one */
+	vec89_file_header *header = (vec89_file_header *)block;
+	header->capacity = new_size / vec->elem_size;
+	header->count = min(header->count, header->capacity);
+	return block + VEC89_FILE_HEADER_SIZE;
+}
+#endif
+
+#ifdef VEC89_SMALL_BUFFER_NOTC89
+/* The inline buffer isn't owned by the allocator, the elements leave it once they outgrow it */
+#define VEC89_BORROWED(vec) ((vec)->arr == (vec)->small.bytes)
+#define VEC89_BORROWED_SIZE(vec) VEC89_SMALL_BUFFER_SIZE
+#else
+/* Vectors initialized with a capacity of 0 share this array until their first allocation */
+static char vec89_empty_array[1];
+#define VEC89_BORROWED(vec) ((vec)->arr == vec89_empty_array)
+#define VEC89_BORROWED_SIZE(vec) 0
+#endif
+
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+/* Non-zero if the array is shared with clones or snapshots and must be copied before it is written */
+#define VEC89_SHARED(vec) ((vec)->shared != NULL)
+
+/* Drops a reference to a shared array, the last one frees the array and its count. Works on vectors and snapshots */
+#define VEC89_COW_RELEASE(owner) do { \
+	if (VEC89_ATOMIC_FETCH_SUB((owner)->shared, 1) == 1) { \
+		VEC89_DEALLOCATE(owner, (owner)->shared, sizeof(size_t)); \
+		VEC89_DEALLOCATE(owner, (void *)(owner)->arr, (owner)->elem_size * (owner)->capacity); \
+	} \
+	(owner)->shared = NULL; \
+} while (0)
+
+/* Takes over a shared array whose other owners all let go. The caller must hold the lock. */
+static void vec89_cow_take(vec_p vec) {
+	VEC89_DEALLOCATE(vec, vec->shared, sizeof(size_t));
+	vec->shared = NULL;
+}
+
+/* Only heap arrays are shared, the inline buffer, mappings and files belong to one vector */
+static char vec89_cow_shareable(vec_p vec) {
+	if (VEC89_BORROWED(vec)) return 0;
+#ifdef VEC89_MMAP_NOTC89
+	if (vec->mapped) return 0;
+#endif
+#ifdef VEC89_FILE_BACKED_NOTC89
+	if (vec->file >= 0) return 0;
+#endif
+	return 1;
+}
+
+/* Adds a reference to the vector's array, the count is created when the array is first shared. The caller must hold the lock. */
+static char vec89_cow_share(vec_p vec) {
+	if (vec->shared == NULL) {
+		size_t *shared = VEC89_ALLOCATE(vec, sizeof(size_t));
+		if (shared == NULL) return VEC89_MEMORY_ERROR;
+		*shared = 1;
+		vec->shared = shared;
+	}
+	VEC89_ATOMIC_FETCH_ADD(vec->shared, 1);
+	return VEC89_SUCCESS;
+}
+#else
+#define VEC89_SHARED(vec) 0
+#endif
+
+/*
+Reallocates the array to new_size bytes. Returns NULL on failure, the old array is then left untouched.
+*/
+static void *vec89_array_realloc(vec_p vec, size_t new_size) {
+#ifdef VEC89_FILE_BACKED_NOTC89
+	if (vec->file >= 0) return vec89_file_remap(vec, new_size);
+#endif
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	if (vec->shared != NULL) {
+		if (VEC89_ATOMIC_LOAD(vec->shared) > 1) {
+			/* Others still read the array, the resized array is a private copy */
+			void *copy_block = VEC89_ALLOCATE(vec, new_size);
+			if (copy_block == NULL) return NULL;
+			memcpy(copy_block, vec->arr, min(vec->elem_size * vec->count, new_size));
+			VEC89_COW_RELEASE(vec);
+			return copy_block;
+		}
+		vec89_cow_take(vec);
+	}
+#endif
+	if (VEC89_BORROWED(vec)) {
+		if (new_size <= VEC89_BORROWED_SIZE(vec)) return vec->arr;
+
+		void *heap_block = VEC89_ALLOCATE(vec, new_size);
+		if (heap_block != NULL) memcpy(heap_block, vec->arr, vec->elem_size * vec->count);
+		return heap_block;
+	}
+#ifdef VEC89_SMALL_BUFFER_NOTC89
+	/* Shrinking into the inline buffer returns the heap block */
+	if (new_size <= VEC89_SMALL_BUFFER_SIZE
+#ifdef VEC89_MMAP_NOTC89
+		&& !vec->mapped
+#endif
+		) {
+		memcpy(vec->small.bytes, vec->arr, vec->elem_size * min(vec->count, new_size / vec->elem_size));
+		VEC89_DEALLOCATE(vec, vec->arr, vec->elem_size * vec->capacity);
+		return vec->small.bytes;
+	}
+#endif
+#ifdef VEC89_MMAP_NOTC89
+	char failed;
+	void *mapped_block = vec89_array_remap(vec, new_size, &failed);
+	if (mapped_block != NULL || failed) return mapped_block;
+#endif
+	return VEC89_REALLOCATE(vec, vec->arr, vec->elem_size * vec->capacity, new_size);
+}
+
+/*
+Frees the array.
+*/
+static void vec89_array_release(vec_p vec) {
+#ifdef VEC89_FILE_BACKED_NOTC89
+	if (vec->file >= 0) {
+		if (vec->file_mode != VEC89_FILE_READ_ONLY) VEC89_FILE_HEADER(vec)->count = vec->count;
+		munmap(vec->arr - VEC89_FILE_HEADER_SIZE, VEC89_FILE_HEADER_SIZE + vec->elem_size * vec->capacity);
+		close(vec->file);
+		vec->file = -1;
+		return;
+	}
+#endif
+#ifdef VEC89_MMAP_NOTC89
+	if (vec->mapped) {
+		munmap(vec->arr, vec89_page_round(vec->elem_size * vec->capacity));
+		vec->mapped = 0;
+		return;
+	}
+#endif
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	if (vec->shared != NULL) {
+		VEC89_COW_RELEASE(vec);
+		return;
+	}
+#endif
+	if (VEC89_BORROWED(vec)) return;
+	VEC89_DEALLOCATE(vec, vec->arr, vec->elem_size * vec->capacity);
+}
+
+/*
+Reallocates the array to hold capacity elements, the array is left untouched on failure.
+The caller must hold the lock.
+*/
+static char vec89_array_resize(vec_p vec, size_t capacity) {
+#ifdef VEC89_STATS
+	char *old_arr = vec->arr;
+	size_t old_capacity = vec->capacity;
+#ifdef VEC89_MMAP_NOTC89
+	char was_mapped = vec->mapped;
+#endif
+#endif
+	void *arr_block = vec89_array_realloc(vec, vec->elem_size * capacity);
+	if (arr_block == NULL) return VEC89_MEMORY_ERROR;
+
+	vec->arr = arr_block;
+	vec->capacity = capacity;
+
+#ifdef VEC89_STATS
+	/* Mappings that stay mappings are moved by mremap without copying */
+	char copied = vec->arr != old_arr;
+#ifdef VEC89_MMAP_NOTC89
+	if (was_mapped && vec->mapped) copied = 0;
+#endif
+#ifdef VEC89_FILE_BACKED_NOTC89
+	if (vec->file >= 0) copied = 0;
+#endif
+	vec->stats.reallocs++;
+	if (copied) vec->stats.realloc_bytes += vec->elem_size * min(vec->count, capacity);
+	vec->stats.peak_capacity = max(vec->stats.peak_capacity, capacity);
+
+	vec89_stats_hook hook = vec89_stats_hook_function;
+	if (hook != NULL) hook(vec, old_capacity, capacity, vec89_stats_hook_context);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+/*
+Returns the capacity the growth policy picks to hold at least required elements.
+Without a policy the capacity doubles. Saturates at required instead of overflowing.
+*/
+static size_t vec89_next_capacity(vec_p vec, size_t required) {
+	const vec89_growth_policy *policy = vec->growth;
+	size_t target_capacity = vec->capacity > 0 ? vec->capacity : 1;
+
+	while (target_capacity < required) {
+		size_t step;
+		if (policy == NULL) {
+			step = target_capacity;
+		} else if (policy->linear_threshold > 0 && target_capacity >= policy->linear_threshold / vec->elem_size) {
+			/* Past the threshold every step adds the same amount, jump straight to the last one */
+			step = max(policy->linear_step / vec->elem_size, 1);
+			step = max(step, policy->min_step);
+			size_t steps = (required - target_capacity + step - 1) / step;
+			if (steps > (VEC89_SIZE_MAX - target_capacity) / step) return required;
+			return target_capacity + steps * step;
+		} else {
+			size_t extra_percent = policy->factor_percent > 100 ? policy->factor_percent - 100 : 100;
+			step = target_capacity / 100 * extra_percent + target_capacity % 100 * extra_percent / 100;
+			step = max(step, policy->min_step);
+		}
+		step = max(step, 1);
+
+		if (step > VEC89_SIZE_MAX - target_capacity) return required;
+		target_capacity += step;
+	}
+
+	return target_capacity;
+}
+
+/*
+Grows the array so it can hold at least required elements, following the vector's growth policy.
+The array is reallocated at most once. The caller must hold the lock.
+*/
+static char vec89_grow(vec_p vec, size_t required) {
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	/* Growing is always followed by a write, so a shared array is copied even if it has room */
+	if (vec->shared != NULL) {
+		if (VEC89_ATOMIC_LOAD(vec->shared) == 1) vec89_cow_take(vec);
+		else if (required <= vec->capacity) return vec89_array_resize(vec, vec->capacity);
+	}
+#endif
+	if (required <= vec->capacity) return VEC89_SUCCESS;
+
+	size_t target_capacity = vec89_next_capacity(vec, required);
+	if (target_capacity > VEC89_SIZE_MAX / vec->elem_size) return VEC89_MEMORY_ERROR;
+
+	return vec89_array_resize(vec, target_capacity);
+}
+
+/* Gives the vector its own array before elements are written in place. The caller must hold the lock. */
+static char vec89_cow_detach(vec_p vec) {
+	return vec89_grow(vec, vec->count);
+}
+
+/*
+Shrinks the array after a removal if the growth policy enables auto-shrink and the occupancy fell below the threshold.
+The new capacity leaves room so the vector doesn't grow again right away. A failed shrink is ignored.
+The caller must hold the lock.
+*/
+static void vec89_auto_shrink(vec_p vec) {
+	const vec89_growth_policy *policy = vec->growth;
+	if (policy == NULL || policy->shrink_threshold_percent == 0) return;
+	if (vec->capacity <= policy->shrink_min_capacity) return;
+	if (vec->count >= vec->capacity / 100 * policy->shrink_threshold_percent + vec->capacity % 100 * policy->shrink_threshold_percent / 100) return;
+
+	size_t target_capacity = vec->count / policy->shrink_target_percent * 100 + vec->count % policy->shrink_target_percent * 100 / policy->shrink_target_percent;
+	target_capacity = max(target_capacity, policy->shrink_min_capacity);
+	target_capacity = max(target_capacity, vec->count);
+	target_capacity = max(target_capacity, 1);
+	if (target_capacity >= vec->capacity) return;
+
+	vec89_array_resize(vec, target_capacity);
+}
+
+#if defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89) || (defined(VEC89_STATS) && defined(VEC89_ATOMIC_EXCHANGE))
+static void vec89_spin_acquire(size_t *spin) {
+	size_t backoff = 1;
+	while (VEC89_ATOMIC_EXCHANGE(spin, 1) != 0) {
+		/* Wait on plain loads so the cache line isn't bounced by failed exchanges */
+		while (VEC89_ATOMIC_LOAD(spin) != 0) {
+			if (backoff < VEC89_SPIN_LIMIT) {
+				size_t i;
+				for (i = 0; i < backoff; i++) VEC89_CPU_RELAX();
+				backoff <<= 1;
+			} else {
+				VEC89_THREAD_YIELD();
+			}
+		}
+	}
+}
+#endif
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+/* Its address identifies the calling thread as a lock scope owner */
+#ifdef _MSC_VER
+static __declspec(thread) char vec89_thread_marker;
+#else
+static __thread char vec89_thread_marker;
+#endif
+
+static void vec89_lock_init(vec89_lock *lock, char policy) {
+	VEC89_MUTEX_INIT(&lock->mutex);
+	lock->spin = 0;
+	lock->owner = NULL;
+	lock->depth = 0;
+	lock->policy = policy;
+#ifdef VEC89_STATS
+	lock->acquisitions = 0;
+	lock->contentions = 0;
+	lock->wait_ns = 0;
+#endif
+}
+
+static void vec89_lock_destroy(vec89_lock *lock) {
+	VEC89_MUTEX_DESTROY(&lock->mutex);
+}
+
+#ifdef VEC89_STATS
+/* Takes the lock if it is free, without waiting */
+static char vec89_lock_raw_try_acquire(vec89_lock *lock, char shared) {
+	switch (lock->policy) {
+	case VEC89_LOCK_POLICY_SPIN:
+		return VEC89_ATOMIC_EXCHANGE(&lock->spin, 1) == 0;
+	case VEC89_LOCK_POLICY_ADAPTIVE:
+	case VEC89_LOCK_POLICY_MUTEX:
+		return shared ? VEC89_MUTEX_TRY_READ_LOCK(&lock->mutex) : VEC89_MUTEX_TRY_LOCK(&lock->mutex);
+	default:
+		return 1;
+	}
+}
+#endif
+
+/* Takes the lock according to the policy, ignoring lock scopes */
+static void vec89_lock_raw_acquire(vec89_lock *lock, char shared) {
+	size_t i;
+#ifdef VEC89_STATS
+	/* Readers count concurrently, so the counters are updated atomically */
+	VEC89_ATOMIC_FETCH_ADD(&lock->acquisitions, 1);
+	if (vec89_lock_raw_try_acquire(lock, shared)) return;
+	VEC89_ATOMIC_FETCH_ADD(&lock->contentions, 1);
+	size_t wait_start = vec89_stats_now();
+#endif
+	switch (lock->policy) {
+	case VEC89_LOCK_POLICY_SPIN:
+		vec89_spin_acquire(&lock->spin);
+		break;
+	case VEC89_LOCK_POLICY_ADAPTIVE:
+		for (i = 0; i < VEC89_LOCK_ADAPTIVE_TRIES; i++) {
+			if (shared ? VEC89_MUTEX_TRY_READ_LOCK(&lock->mutex) : VEC89_MUTEX_TRY_LOCK(&lock->mutex)) break;
+			VEC89_CPU_RELAX();
+		}
+		if (i < VEC89_LOCK_ADAPTIVE_TRIES) break;
+		/* fall through */
+	case VEC89_LOCK_POLICY_MUTEX:
+		if (shared) VEC89_MUTEX_READ_LOCK(&lock->mutex);
+		else VEC89_MUTEX_LOCK(&lock->mutex);
+		break;
+	default:
+		break;
+	}
+#ifdef VEC89_STATS
+	VEC89_ATOMIC_FETCH_ADD(&lock->wait_ns, vec89_stats_now() - wait_start);
+#endif
+}
+
+static void vec89_lock_raw_release(vec89_lock *lock, char shared) {
+	switch (lock->policy) {
+	case VEC89_LOCK_POLICY_SPIN:
+		VEC89_ATOMIC_STORE(&lock->spin, 0);
+		break;
+	case VEC89_LOCK_POLICY_ADAPTIVE:
+	case VEC89_LOCK_POLICY_MUTEX:
+		if (shared) VEC89_MUTEX_READ_UNLOCK(&lock->mutex);
+		else VEC89_MUTEX_UNLOCK(&lock->mutex);
+		break;
+	default:
+		break;
+	}
+}
+
+void VEC89_LOCK_ACQUIRE(vec89_lock *lock, char shared) {
+	if (lock->policy == VEC89_LOCK_POLICY_NONE) return;
+	/* Only the scope owner can see itself as owner, it already holds the lock exclusively */
+	if (VEC89_ATOMIC_LOAD_PTR(&lock->owner) == &vec89_thread_marker) {
+		lock->depth++;
+		return;
+	}
+	vec89_lock_raw_acquire(lock, shared);
+}
+
+void VEC89_LOCK_RELEASE(vec89_lock *lock, char shared) {
+	if (lock->policy == VEC89_LOCK_POLICY_NONE) return;
+	if (VEC89_ATOMIC_LOAD_PTR(&lock->owner) == &vec89_thread_marker) {
+		lock->depth--;
+		return;
+	}
+	vec89_lock_raw_release(lock, shared);
+}
+#endif
+
+#ifdef VEC89_STATS
+#ifdef VEC89_ATOMIC_EXCHANGE
+#define VEC89_STATS_REGISTRY_LOCK() vec89_spin_acquire(&vec89_stats_registry_spin)
+#define VEC89_STATS_REGISTRY_UNLOCK() VEC89_ATOMIC_STORE(&vec89_stats_registry_spin, 0)
+#else
+#define VEC89_STATS_REGISTRY_LOCK() ((void)0)
+#define VEC89_STATS_REGISTRY_UNLOCK() ((void)0)
+#endif
+
+/* Counters written by VEC89_STATS_DUMP, in output order */
+static const struct {
+	const char *name;
+	size_t offset;
+} vec89_stats_fields[] = {
+	{ "pushes", offsetof(vec89_stats, pushes) },
+	{ "pops", offsetof(vec89_stats, pops) },
+	{ "inserts", offsetof(vec89_stats, inserts) },
+	{ "removes", offsetof(vec89_stats, removes) },
+	{ "reallocs", offsetof(vec89_stats, reallocs) },
+	{ "realloc_bytes", offsetof(vec89_stats, realloc_bytes) },
+	{ "memmove_bytes", offsetof(vec89_stats, memmove_bytes) },
+	{ "peak_capacity", offsetof(vec89_stats, peak_capacity) },
+	{ "lock_acquisitions", offsetof(vec89_stats, lock_acquisitions) },
+	{ "lock_contentions", offsetof(vec89_stats, lock_contentions) },
+	{ "lock_wait_ns", offsetof(vec89_stats, lock_wait_ns) }
+};
+
+/* Zeroes the counters and links the vector at the head of the registry */
+static void vec89_stats_register(vec_p vec) {
+	memset(&vec->stats, 0, sizeof(vec->stats));
+	vec->stats.peak_capacity = vec->capacity;
+	vec->stats_name = NULL;
+	vec->stats_prev = NULL;
+
+	VEC89_STATS_REGISTRY_LOCK();
+	vec->stats_next = vec89_stats_registry;
+	if (vec89_stats_registry != NULL) vec89_stats_registry->stats_prev = vec;
+	vec89_stats_registry = vec;
+	VEC89_STATS_REGISTRY_UNLOCK();
+}
+
+/* Unlinks the vector, does nothing for vectors that aren't linked */
+static void vec89_stats_unregister(vec_p vec) {
+	VEC89_STATS_REGISTRY_LOCK();
+	if (vec->stats_prev != NULL || vec89_stats_registry == vec) {
+		if (vec->stats_prev != NULL) vec->stats_prev->stats_next = vec->stats_next;
+		else vec89_stats_registry = vec->stats_next;
+		if (vec->stats_next != NULL) vec->stats_next->stats_prev = vec->stats_prev;
+		vec->stats_prev = NULL;
+		vec->stats_next = NULL;
+	}
+	VEC89_STATS_REGISTRY_UNLOCK();
+}
 
+/* Copies the counters without locking the vector, the lock counters are merged in */
+static void vec89_stats_snapshot(vec_p vec, vec89_stats *out_stats) {
+	*out_stats = vec->stats;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK_TYPE *vec89_lock = malloc(sizeof(VEC89_LOCK_TYPE));
-	if (vec89_lock == NULL) return VEC89_MEMORY_ERROR;
+	out_stats->lock_acquisitions = VEC89_ATOMIC_LOAD(&vec->lock.acquisitions);
+	out_stats->lock_contentions = VEC89_ATOMIC_LOAD(&vec->lock.contentions);
+	out_stats->lock_wait_ns = VEC89_ATOMIC_LOAD(&vec->lock.wait_ns);
+#endif
+}
+
+static void vec89_stats_write_string(FILE *stream, const char *string) {
+	fputc('"', stream);
+	for (; *string != '\0'; string++) {
+		unsigned char c = (unsigned char)*string;
+		if (c == '"' || c == '\\') fprintf(stream, "\\%c", c);
+		else if (c < 0x20) fprintf(stream, "\\u%04x", (unsigned int)c);
+		else fputc(c, stream);
+	}
+	fputc('"', stream);
+}
+#endif
 
-	VEC89_LOCK_INIT(vec89_lock);
-	VEC89_LOCK(vec89_lock);
-	vec->lock = vec89_lock;
+static char vec89_initialize(vec_p vec, size_t element_size, size_t capacity, const vec89_allocator *allocator) {
+	if (vec == NULL || element_size == 0) return VEC89_INVALID_ARGUMENTS;
+	if (allocator != NULL && (allocator->alloc_function == NULL || allocator->realloc_function == NULL || allocator->free_function == NULL)) return VEC89_INVALID_ARGUMENTS;
+	if (capacity > 0 && element_size > VEC89_SIZE_MAX / capacity) return VEC89_MEMORY_ERROR;
+
+	vec->allocator = allocator;
+	vec->growth = NULL;
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	vec->shared = NULL;
+#endif
+#ifdef VEC89_MMAP_NOTC89
+	vec->mapped = 0;
+	vec->mmap_threshold = VEC89_MMAP_THRESHOLD;
+#endif
+#ifdef VEC89_FILE_BACKED_NOTC89
+	vec->file = -1;
+	vec->file_mode = VEC89_FILE_READ_WRITE;
+#endif
+
+#ifdef VEC89_SMALL_BUFFER_NOTC89
+	if (element_size * capacity <= VEC89_SMALL_BUFFER_SIZE) {
+		vec->arr = vec->small.bytes;
+		capacity = VEC89_SMALL_BUFFER_SIZE / element_size;
+	}
+#else
+	if (capacity == 0) vec->arr = vec89_empty_array;
 #endif
+	else {
+		void *arr_block = VEC89_ALLOCATE(vec, element_size * capacity);
+		if (arr_block == NULL) return VEC89_MEMORY_ERROR;
+		vec->arr = arr_block;
+	}
+
+	vec->capacity = capacity;
+	vec->elem_size = element_size;
+	vec->count = 0;
 
-	void *arr_block = MALLOC_FUNCTION(element_size * VEC89_DEFAULT_CAPACITY);
-	if (arr_block == NULL) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_LOCK_DESTROY(vec->lock);
-		free(vec->lock);
-		vec->lock = NULL;
+	vec89_lock_init(&vec->lock, VEC89_LOCK_POLICY_DEFAULT);
+#endif
+#ifdef VEC89_STATS
+	vec89_stats_register(vec);
+#endif
+	
+	return VEC89_SUCCESS;
+}
+
+char VEC89_INITIALIZATION(vec_p vec, size_t element_size) {
+	return VEC89_INITIALIZATION_ALLOCATOR(vec, element_size, NULL);
+}
+
+char VEC89_INITIALIZATION_ALLOCATOR(vec_p vec, size_t element_size, const vec89_allocator *allocator) {
+	if (VEC89_DEFAULT_CAPACITY < 0) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_SMALL_BUFFER_NOTC89
+	return vec89_initialize(vec, element_size, 0, allocator);
+#else
+	return vec89_initialize(vec, element_size, VEC89_DEFAULT_CAPACITY, allocator);
 #endif
+}
+
+char VEC89_INITIALIZATION_CAPACITY(vec_p vec, size_t element_size, size_t capacity) {
+	return vec89_initialize(vec, element_size, capacity, NULL);
+}
+
+#ifdef VEC89_FILE_BACKED_NOTC89
+char VEC89_FILE_OPEN(vec_p vec, const char *path, size_t element_size, char mode) {
+	if (vec == NULL || path == NULL || mode < VEC89_FILE_READ_ONLY || mode > VEC89_FILE_CREATE) return VEC89_INVALID_ARGUMENTS;
+	if (mode == VEC89_FILE_CREATE && (element_size == 0 || element_size > (VEC89_SIZE_MAX - VEC89_FILE_HEADER_SIZE) / VEC89_DEFAULT_CAPACITY)) return VEC89_INVALID_ARGUMENTS;
+
+	int file;
+	if (mode == VEC89_FILE_CREATE) file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	else file = open(path, mode == VEC89_FILE_READ_ONLY ? O_RDONLY : O_RDWR);
+	if (file < 0) return VEC89_FAILURE;
+
+	vec89_file_header header;
+	if (mode == VEC89_FILE_CREATE) {
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, VEC89_FILE_MAGIC, sizeof(header.magic));
+		header.version = VEC89_FILE_VERSION;
+		header.header_size = VEC89_FILE_HEADER_SIZE;
+		header.elem_size = element_size;
+		header.count = 0;
+		header.capacity = VEC89_DEFAULT_CAPACITY;
+
+		if (ftruncate(file, (off_t)(VEC89_FILE_HEADER_SIZE + element_size * VEC89_DEFAULT_CAPACITY)) != 0 || pwrite(file, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+			close(file);
+			return VEC89_FAILURE;
+		}
+	} else {
+		struct stat file_stat;
+		if (pread(file, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || fstat(file, &file_stat) != 0 ||
+			memcmp(header.magic, VEC89_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != VEC89_FILE_VERSION ||
+			header.header_size != VEC89_FILE_HEADER_SIZE || header.elem_size == 0 || header.count > header.capacity ||
+			(element_size != 0 && header.elem_size != element_size) ||
+			header.capacity > (VEC89_SIZE_MAX - VEC89_FILE_HEADER_SIZE) / header.elem_size ||
+			(uint64_t)file_stat.st_size < VEC89_FILE_HEADER_SIZE + header.elem_size * header.capacity) {
+			close(file);
+			return VEC89_FAILURE;
+		}
+	}
+
+	/* Read-only vectors are mapped privately, writes through SET stay in the process */
+	size_t file_size = VEC89_FILE_HEADER_SIZE + (size_t)(header.elem_size * header.capacity);
+	char *block = mmap(NULL, file_size, PROT_READ | PROT_WRITE, mode == VEC89_FILE_READ_ONLY ? MAP_PRIVATE : MAP_SHARED, file, 0);
+	if (block == MAP_FAILED) {
+		close(file);
 		return VEC89_MEMORY_ERROR;
 	}
 
-	vec->arr = arr_block;
-	vec->capacity = VEC89_DEFAULT_CAPACITY;
+	vec->arr = block + VEC89_FILE_HEADER_SIZE;
+	vec->capacity = (size_t)header.capacity;
+	vec->elem_size = (size_t)header.elem_size;
+	vec->count = (size_t)header.count;
+	vec->allocator = NULL;
+	vec->growth = NULL;
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	vec->shared = NULL;
+#endif
+#ifdef VEC89_MMAP_NOTC89
+	vec->mapped = 0;
+	vec->mmap_threshold = 0;
+#endif
+	vec->file = file;
+	vec->file_mode = mode == VEC89_FILE_CREATE ? VEC89_FILE_READ_WRITE : mode;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock_init(&vec->lock, VEC89_LOCK_POLICY_DEFAULT);
+#endif
+#ifdef VEC89_STATS
+	vec89_stats_register(vec);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_FILE_SYNC(vec_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL || vec->file < 0 || vec->file_mode == VEC89_FILE_READ_ONLY) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	VEC89_FILE_HEADER(vec)->count = vec->count;
+	char result = msync(vec->arr - VEC89_FILE_HEADER_SIZE, VEC89_FILE_HEADER_SIZE + vec->elem_size * vec->capacity, MS_SYNC) == 0 ? VEC89_SUCCESS : VEC89_FAILURE;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return result;
+}
+#endif
+
+void VEC89_ARRAY_FREE(vec_p vec) {
+	if (vec == NULL) return;
+#ifdef VEC89_STATS
+	vec89_stats_unregister(vec);
+#endif
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	vec89_array_release(vec);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+	vec89_lock_destroy(&vec->lock);
+#endif
+	return;
+}
+
+void VEC89_FREE(vec_p vec) {
+	if (vec == NULL) return;
+#ifdef VEC89_STATS
+	vec89_stats_unregister(vec);
+#endif
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	vec89_array_release(vec);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+	vec89_lock_destroy(&vec->lock);
+#endif
+	free(vec);
+	return;
+}
+
+char VEC89_SET_LOCK_POLICY(vec_p vec, char policy) {
+	if (vec == NULL || policy < VEC89_LOCK_POLICY_NONE || policy > VEC89_LOCK_POLICY_MUTEX) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	if (vec->lock.depth != 0) return VEC89_FAILURE;
+	vec->lock.policy = policy;
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_LOCK_SCOPE_BEGIN(vec_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock *lock = &vec->lock;
+	if (lock->policy == VEC89_LOCK_POLICY_NONE) return VEC89_SUCCESS;
+
+	if (VEC89_ATOMIC_LOAD_PTR(&lock->owner) == &vec89_thread_marker) {
+		lock->depth++;
+		return VEC89_SUCCESS;
+	}
+
+	vec89_lock_raw_acquire(lock, 0);
+	lock->depth = 1;
+	VEC89_ATOMIC_STORE_PTR(&lock->owner, (void *)&vec89_thread_marker);
+#endif
+	return VEC89_SUCCESS;
+}
+
+void VEC89_LOCK_SCOPE_END(vec_p vec) {
+	if (vec == NULL) return;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock *lock = &vec->lock;
+	if (VEC89_ATOMIC_LOAD_PTR(&lock->owner) != &vec89_thread_marker) return;
+
+	if (--lock->depth == 0) {
+		VEC89_ATOMIC_STORE_PTR(&lock->owner, NULL);
+		vec89_lock_raw_release(lock, 0);
+	}
+#endif
+	return;
+}
+
+#ifdef VEC89_STATS
+char VEC89_STATS_GET(vec_p vec, vec89_stats *out_stats) {
+	if (vec == NULL || out_stats == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&vec->lock);
+#endif
+	vec89_stats_snapshot(vec, out_stats);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_STATS_RESET(vec_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	memset(&vec->stats, 0, sizeof(vec->stats));
+	vec->stats.peak_capacity = vec->capacity;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_ATOMIC_STORE(&vec->lock.acquisitions, 0);
+	VEC89_ATOMIC_STORE(&vec->lock.contentions, 0);
+	VEC89_ATOMIC_STORE(&vec->lock.wait_ns, 0);
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_STATS_SET_NAME(vec_p vec, const char *name) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+	/* Set under the registry lock so a concurrent dump sees either name */
+	VEC89_STATS_REGISTRY_LOCK();
+	vec->stats_name = name;
+	VEC89_STATS_REGISTRY_UNLOCK();
+	return VEC89_SUCCESS;
+}
+
+char VEC89_STATS_DUMP(FILE *stream, char format) {
+	if (stream == NULL || (format != VEC89_STATS_TEXT && format != VEC89_STATS_JSON)) return VEC89_INVALID_ARGUMENTS;
+
+	VEC89_STATS_REGISTRY_LOCK();
+	if (format == VEC89_STATS_JSON) fputc('[', stream);
+
+	vec_p vec;
+	for (vec = vec89_stats_registry; vec != NULL; vec = vec->stats_next) {
+		vec89_stats stats;
+		vec89_stats_snapshot(vec, &stats);
+
+		size_t i;
+		if (format == VEC89_STATS_JSON) {
+			fputs(vec == vec89_stats_registry ? "\n\t{\"name\": " : ",\n\t{\"name\": ", stream);
+			if (vec->stats_name != NULL) vec89_stats_write_string(stream, vec->stats_name);
+			else fputs("null", stream);
+			fprintf(stream, ", \"address\": \"%p\", \"elem_size\": %lu, \"count\": %lu, \"capacity\": %lu",
+				(void *)vec, (unsigned long)vec->elem_size, (unsigned long)vec->count, (unsigned long)vec->capacity);
+			for (i = 0; i < sizeof(vec89_stats_fields) / sizeof(vec89_stats_fields[0]); i++) {
+				fprintf(stream, ", \"%s\": %lu", vec89_stats_fields[i].name, (unsigned long)*(const size_t *)((const char *)&stats + vec89_stats_fields[i].offset));
+			}
+			fputc('}', stream);
+		} else {
+			if (vec->stats_name != NULL) fprintf(stream, "%s (%p):", vec->stats_name, (void *)vec);
+			else fprintf(stream, "%p:", (void *)vec);
+			fprintf(stream, " elem_size=%lu count=%lu capacity=%lu", (unsigned long)vec->elem_size, (unsigned long)vec->count, (unsigned long)vec->capacity);
+			for (i = 0; i < sizeof(vec89_stats_fields) / sizeof(vec89_stats_fields[0]); i++) {
+				fprintf(stream, " %s=%lu", vec89_stats_fields[i].name, (unsigned long)*(const size_t *)((const char *)&stats + vec89_stats_fields[i].offset));
+			}
+			fputc('\n', stream);
+		}
+	}
+
+	if (format == VEC89_STATS_JSON) fputs(vec89_stats_registry != NULL ? "\n]\n" : "]\n", stream);
+	VEC89_STATS_REGISTRY_UNLOCK();
+
+	return ferror(stream) ? VEC89_FAILURE : VEC89_SUCCESS;
+}
+
+void VEC89_STATS_SET_HOOK(vec89_stats_hook hook, void *context) {
+	vec89_stats_hook_context = context;
+	vec89_stats_hook_function = hook;
+}
+#endif
+
+char VEC89_SET_GROWTH_POLICY(vec_p vec, const vec89_growth_policy *policy) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+	if (policy != NULL && policy->shrink_threshold_percent > 0 && (policy->shrink_target_percent <= policy->shrink_threshold_percent || policy->shrink_target_percent > 100)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	vec->growth = policy;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SET_MMAP_THRESHOLD(vec_p vec, size_t threshold) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_MMAP_NOTC89
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	vec->mmap_threshold = threshold;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+#else
+	(void)threshold;
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_CLEAR(vec_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	vec->count = 0;
+	vec89_auto_shrink(vec);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_RESERVE(vec_p vec, size_t capacity) {
+	if (vec == NULL || capacity == 0) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL || capacity < vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (capacity == vec->capacity) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+	if (capacity > VEC89_SIZE_MAX / vec->elem_size) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	if (vec89_array_resize(vec, capacity) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_EXPAND(vec_p vec, size_t n) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (n == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+
+	/* An empty array doubles from a single element */
+	size_t capacity = max(vec->capacity, 1);
+	if (n >= sizeof(size_t) * 8 || capacity > (VEC89_SIZE_MAX / vec->elem_size) >> n) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	size_t target_capacity = capacity << n;
+
+	if (vec89_array_resize(vec, target_capacity) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SHRINK(vec_p vec, size_t n) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (n == 0 || vec->capacity <= 1 || vec->capacity <= vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+
+	size_t target_capacity = vec->capacity;
+	size_t i;
+	for (i = 0; i < n; i++) {
+		if (target_capacity <= 1 || target_capacity / 2 < vec->count) break;
+		target_capacity /= 2;
+	}
+
+	if (vec89_array_resize(vec, target_capacity) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SHRINK_TO_FIT(vec_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (vec->capacity == 0 || vec->capacity == vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+
+	if (vec89_array_resize(vec, max(vec->count, 1)) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_PUSH(vec_p vec, const void *element) {
+	if (vec == NULL || element == NULL ) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	
+	if (vec->count >= vec->capacity || VEC89_SHARED(vec)) {
+		char result = vec89_grow(vec, vec->count + 1);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&vec->lock);
+#endif
+			return result;
+		}
+	}
+
+	memcpy(vec->arr + vec->count * vec->elem_size, element, vec->elem_size);
+	vec->count++;
+	VEC89_STATS_ADD(vec, pushes, 1);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_POP(vec_p vec, void **out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (vec->count == 0) {
+		*out_element = NULL;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+
+	*out_element = MALLOC_FUNCTION(vec->elem_size);
+	if (*out_element == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	memcpy(*out_element, vec->arr + vec->elem_size * (vec->count - 1), vec->elem_size);
+	vec->count--;
+	VEC89_STATS_ADD(vec, pops, 1);
+	vec89_auto_shrink(vec);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SET(vec_p vec, size_t idx, const void *element) {
+	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx >= vec->capacity) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+	if (VEC89_SHARED(vec) && vec89_cow_detach(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	memcpy(vec->arr + vec->elem_size * idx, element, vec->elem_size);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_REMOVE(vec_p vec, size_t idx) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx >= vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (idx == vec->count - 1) {
+		vec->count--;
+		VEC89_STATS_ADD(vec, removes, 1);
+		vec89_auto_shrink(vec);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+
+	if (VEC89_SHARED(vec) && vec89_cow_detach(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+	memmove(vec->arr + vec->elem_size * idx, vec->arr + vec->elem_size * (idx + 1), vec->elem_size * (vec->count - (idx + 1)));
+	VEC89_STATS_ADD(vec, memmove_bytes, vec->elem_size * (vec->count - (idx + 1)));
+	vec->count--;
+	VEC89_STATS_ADD(vec, removes, 1);
+	vec89_auto_shrink(vec);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_INSERT(vec_p vec, size_t idx, const void *element) {
+	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx > vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (vec->count >= vec->capacity || VEC89_SHARED(vec)) {
+		char result = vec89_grow(vec, vec->count + 1);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&vec->lock);
+#endif
+			return result;
+		}
+	}
+
+	if (idx >= vec->count) {
+		memcpy(vec->arr + vec->elem_size * vec->count, element, vec->elem_size);
+		vec->count++;
+		VEC89_STATS_ADD(vec, inserts, 1);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+	
+	memmove(vec->arr + vec->elem_size * (idx + 1), vec->arr + vec->elem_size * idx, vec->elem_size * (vec->count - idx));
+	memcpy(vec->arr + vec->elem_size * idx, element, vec->elem_size);
+	VEC89_STATS_ADD(vec, memmove_bytes, vec->elem_size * (vec->count - idx));
+
+	vec->count++;
+	VEC89_STATS_ADD(vec, inserts, 1);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_GET(vec_p vec, size_t idx, void **out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx >= vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	*out_element = vec->arr + vec->elem_size * idx;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_PUSH_N(vec_p vec, const void *elements, size_t n) {
+	if (vec == NULL || (elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (n == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+	if (n > VEC89_SIZE_MAX - vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	char result = vec89_grow(vec, vec->count + n);
+	if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return result;
+	}
+
+	memcpy(vec->arr + vec->elem_size * vec->count, elements, vec->elem_size * n);
+	vec->count += n;
+	VEC89_STATS_ADD(vec, pushes, n);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_INSERT_RANGE(vec_p vec, size_t idx, const void *elements, size_t n) {
+	if (vec == NULL || (elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx > vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+	if (n == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+	if (n > VEC89_SIZE_MAX - vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	char result = vec89_grow(vec, vec->count + n);
+	if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return result;
+	}
+
+	if (idx < vec->count) {
+		memmove(vec->arr + vec->elem_size * (idx + n), vec->arr + vec->elem_size * idx, vec->elem_size * (vec->count - idx));
+		VEC89_STATS_ADD(vec, memmove_bytes, vec->elem_size * (vec->count - idx));
+	}
+	memcpy(vec->arr + vec->elem_size * idx, elements, vec->elem_size * n);
+	vec->count += n;
+	VEC89_STATS_ADD(vec, inserts, n);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_REMOVE_RANGE(vec_p vec, size_t idx, size_t n) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx > vec->count || n > vec->count - idx) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (n > 0 && idx + n < vec->count) {
+		if (VEC89_SHARED(vec) && vec89_cow_detach(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&vec->lock);
+#endif
+			return VEC89_MEMORY_ERROR;
+		}
+		memmove(vec->arr + vec->elem_size * idx, vec->arr + vec->elem_size * (idx + n), vec->elem_size * (vec->count - (idx + n)));
+		VEC89_STATS_ADD(vec, memmove_bytes, vec->elem_size * (vec->count - (idx + n)));
+	}
+	vec->count -= n;
+	VEC89_STATS_ADD(vec, removes, n);
+	vec89_auto_shrink(vec);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SWAP_REMOVE(vec_p vec, size_t idx) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx >= vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (idx != vec->count - 1 && VEC89_SHARED(vec) && vec89_cow_detach(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+	vec->count--;
+	if (idx != vec->count) {
+		memcpy(vec->arr + vec->elem_size * idx, vec->arr + vec->elem_size * vec->count, vec->elem_size);
+	}
+	VEC89_STATS_ADD(vec, removes, 1);
+	vec89_auto_shrink(vec);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+#define VEC89_COMPACT_REMOVE_IF 0
+#define VEC89_COMPACT_RETAIN 1
+#define VEC89_COMPACT_DEDUP 2
+
+/* Returns non-zero if the element at idx is removed, elements are only moved below the one before idx so comparing with it is safe */
+static char vec89_compact_drops(vec_p vec, size_t idx, char mode, vec89_predicate_function predicate, vec89_equal_function equal, void *context) {
+	const char *element = vec->arr + vec->elem_size * idx;
+
+	if (mode == VEC89_COMPACT_DEDUP) {
+		if (idx == 0) return 0;
+		if (equal == NULL) return memcmp(element - vec->elem_size, element, vec->elem_size) == 0;
+		return equal(element - vec->elem_size, element, context) != 0;
+	}
+	if (mode == VEC89_COMPACT_RETAIN) return predicate(element, context) == 0;
+	return predicate(element, context) != 0;
+}
+
+/* Single pass compaction, each run of kept elements is moved down with one memmove */
+static char vec89_compact(vec_p vec, char mode, vec89_predicate_function predicate, vec89_equal_function equal, void *context, size_t *out_removed) {
+	size_t read = 0, write = 0;
+	if (vec == NULL || (mode != VEC89_COMPACT_DEDUP && predicate == NULL)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (VEC89_SHARED(vec) && vec89_cow_detach(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	while (read < vec->count) {
+		size_t run = read;
+		while (read < vec->count && !vec89_compact_drops(vec, read, mode, predicate, equal, context)) read++;
+		if (read > run) {
+			if (write != run) {
+				memmove(vec->arr + vec->elem_size * write, vec->arr + vec->elem_size * run, vec->elem_size * (read - run));
+				VEC89_STATS_ADD(vec, memmove_bytes, vec->elem_size * (read - run));
+			}
+			write += read - run;
+		}
+		while (read < vec->count && vec89_compact_drops(vec, read, mode, predicate, equal, context)) read++;
+	}
+
+	if (out_removed != NULL) *out_removed = vec->count - write;
+	VEC89_STATS_ADD(vec, removes, vec->count - write);
+	vec->count = write;
+	vec89_auto_shrink(vec);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_REMOVE_IF(vec_p vec, vec89_predicate_function predicate, void *context, size_t *out_removed) {
+	return vec89_compact(vec, VEC89_COMPACT_REMOVE_IF, predicate, NULL, context, out_removed);
+}
+
+char VEC89_RETAIN(vec_p vec, vec89_predicate_function predicate, void *context, size_t *out_removed) {
+	return vec89_compact(vec, VEC89_COMPACT_RETAIN, predicate, NULL, context, out_removed);
+}
+
+char VEC89_DEDUP(vec_p vec, vec89_equal_function equal, void *context, size_t *out_removed) {
+	return vec89_compact(vec, VEC89_COMPACT_DEDUP, NULL, equal, context, out_removed);
+}
+
+char VEC89_APPEND_VEC(vec_p vec, vec_p other) {
+	if (vec == NULL || other == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	/* Lock in address order so two vectors appending to each other can't deadlock */
+	vec89_lock *first_lock = &vec->lock;
+	vec89_lock *second_lock = NULL;
+	if (vec != other) {
+		if ((char *)vec < (char *)other) {
+			second_lock = &other->lock;
+		} else {
+			first_lock = &other->lock;
+			second_lock = &vec->lock;
+		}
+	}
+	VEC89_LOCK(first_lock);
+	if (second_lock != NULL) VEC89_LOCK(second_lock);
+#endif
+	if (vec->arr == NULL || other->arr == NULL || vec->elem_size != other->elem_size) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		if (second_lock != NULL) VEC89_UNLOCK(second_lock);
+		VEC89_UNLOCK(first_lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	size_t n = other->count;
+	if (n > VEC89_SIZE_MAX - vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		if (second_lock != NULL) VEC89_UNLOCK(second_lock);
+		VEC89_UNLOCK(first_lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	/* other->arr is read after growing, appending a vector to itself is fine */
+	char result = vec89_grow(vec, vec->count + n);
+	if (result == VEC89_SUCCESS && n > 0) {
+		memcpy(vec->arr + vec->elem_size * vec->count, other->arr, vec->elem_size * n);
+		vec->count += n;
+		VEC89_STATS_ADD(vec, pushes, n);
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	if (second_lock != NULL) VEC89_UNLOCK(second_lock);
+	VEC89_UNLOCK(first_lock);
+#endif
+
+	return result;
+}
+
+char VEC89_POP_INTO(vec_p vec, void *out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (vec->count == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	vec->count--;
+	memcpy(out_element, vec->arr + vec->elem_size * vec->count, vec->elem_size);
+	VEC89_STATS_ADD(vec, pops, 1);
+	vec89_auto_shrink(vec);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_POP_N(vec_p vec, void *out_elements, size_t n) {
+	if (vec == NULL || (out_elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (n > vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	vec->count -= n;
+	if (n > 0) memcpy(out_elements, vec->arr + vec->elem_size * vec->count, vec->elem_size * n);
+	VEC89_STATS_ADD(vec, pops, n);
+	vec89_auto_shrink(vec);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_PEEK(vec_p vec, void **out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	*out_element = vec->count > 0 ? vec->arr + vec->elem_size * (vec->count - 1) : NULL;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&vec->lock);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+char VEC89_GET_COPY(vec_p vec, size_t idx, void *out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx >= vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	memcpy(out_element, vec->arr + vec->elem_size * idx, vec->elem_size);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_READ_BEGIN(vec_p vec, const void **out_arr, size_t *out_count) {
+	if (vec == NULL || out_arr == NULL || out_count == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	*out_arr = vec->arr;
+	*out_count = vec->count;
+
+	/* The lock stays held until VEC89_READ_END */
+	return VEC89_SUCCESS;
+}
+
+void VEC89_READ_END(vec_p vec) {
+	if (vec == NULL) return;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&vec->lock);
+#endif
+	return;
+}
+
+char VEC89_VIEW(vec_p vec, size_t begin, size_t end, char writable, vec89_view *out_view) {
+	if (vec == NULL || out_view == NULL || begin > end) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK_ACQUIRE(&vec->lock, !writable);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_LOCK_RELEASE(&vec->lock, !writable);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (end == VEC89_VIEW_END_OF_VECTOR) end = max(vec->count, begin);
+	if (end > vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_LOCK_RELEASE(&vec->lock, !writable);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+	if (writable && VEC89_SHARED(vec) && vec89_cow_detach(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_LOCK_RELEASE(&vec->lock, !writable);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	out_view->data = vec->arr + vec->elem_size * begin;
+	out_view->stride = vec->elem_size;
+	out_view->count = end - begin;
+	out_view->vec = vec;
+	out_view->writable = writable != 0;
+
+	/* The lock stays held until VEC89_VIEW_RELEASE */
+	return VEC89_SUCCESS;
+}
+
+void VEC89_VIEW_RELEASE(vec89_view *view) {
+	if (view == NULL || view->vec == NULL) return;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK_RELEASE(&view->vec->lock, !view->writable);
+#endif
+	view->vec = NULL;
+	return;
+}
+
+char VEC89_GET_N(vec_p vec, size_t idx, void *out_elements, size_t n) {
+	if (vec == NULL || (out_elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx > vec->count || n > vec->count - idx) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (n > 0) memcpy(out_elements, vec->arr + vec->elem_size * idx, vec->elem_size * n);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SET_N(vec_p vec, size_t idx, const void *elements, size_t n) {
+	if (vec == NULL || (elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx > vec->count || n > vec->count - idx) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (n > 0 && VEC89_SHARED(vec) && vec89_cow_detach(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+	if (n > 0) memcpy(vec->arr + vec->elem_size * idx, elements, vec->elem_size * n);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_CLONE(vec_p vec, vec_p out_clone) {
+	if (vec == NULL || out_clone == NULL || vec == out_clone) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	char result;
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	if (vec89_cow_shareable(vec)) {
+		result = vec89_initialize(out_clone, vec->elem_size, 0, vec->allocator);
+		if (result == VEC89_SUCCESS && vec89_cow_share(vec) != VEC89_SUCCESS) {
+			VEC89_ARRAY_FREE(out_clone);
+			result = VEC89_MEMORY_ERROR;
+		}
+		if (result == VEC89_SUCCESS) {
+			/* The clone's empty array is borrowed, so replacing it leaks nothing */
+			out_clone->arr = vec->arr;
+			out_clone->capacity = vec->capacity;
+			out_clone->count = vec->count;
+			out_clone->growth = vec->growth;
+			out_clone->shared = vec->shared;
+		}
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return result;
+	}
+#endif
+
+	result = vec89_initialize(out_clone, vec->elem_size, vec->count, vec->allocator);
+	if (result == VEC89_SUCCESS) {
+		if (vec->count > 0) memcpy(out_clone->arr, vec->arr, vec->elem_size * vec->count);
+		out_clone->count = vec->count;
+		out_clone->growth = vec->growth;
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return result;
+}
+
+char VEC89_DETACH(vec_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	char result = VEC89_SHARED(vec) ? vec89_cow_detach(vec) : VEC89_SUCCESS;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return result;
+}
+
+char VEC89_SNAPSHOT(vec_p vec, vec89_snapshot *out_snapshot) {
+	if (vec == NULL || out_snapshot == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (vec->arr == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	out_snapshot->count = vec->count;
+	out_snapshot->elem_size = vec->elem_size;
+	out_snapshot->allocator = vec->allocator;
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	out_snapshot->shared = NULL;
+	if (vec89_cow_shareable(vec)) {
+		if (vec89_cow_share(vec) != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&vec->lock);
+#endif
+			return VEC89_MEMORY_ERROR;
+		}
+		out_snapshot->arr = vec->arr;
+		out_snapshot->capacity = vec->capacity;
+		out_snapshot->shared = vec->shared;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_SUCCESS;
+	}
+#endif
+
+	out_snapshot->arr = NULL;
+	out_snapshot->capacity = 0;
+	if (vec->count > 0) {
+		char *arr_block = VEC89_ALLOCATE(vec, vec->elem_size * vec->count);
+		if (arr_block == NULL) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&vec->lock);
+#endif
+			return VEC89_MEMORY_ERROR;
+		}
+		memcpy(arr_block, vec->arr, vec->elem_size * vec->count);
+		out_snapshot->arr = arr_block;
+		out_snapshot->capacity = vec->count;
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+void VEC89_SNAPSHOT_RELEASE(vec89_snapshot *snapshot) {
+	if (snapshot == NULL) return;
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	if (snapshot->shared != NULL) VEC89_COW_RELEASE(snapshot);
+	else if (snapshot->arr != NULL) VEC89_DEALLOCATE(snapshot, (void *)snapshot->arr, snapshot->elem_size * snapshot->capacity);
+#else
+	if (snapshot->arr != NULL) VEC89_DEALLOCATE(snapshot, (void *)snapshot->arr, snapshot->elem_size * snapshot->capacity);
+#endif
+	snapshot->arr = NULL;
+	snapshot->count = 0;
+	snapshot->capacity = 0;
+	return;
+}
+
+#define VEC89_DEQUE_SLOT(deque, idx) (((deque)->head + (idx)) & ((deque)->capacity - 1))
+#define VEC89_DEQUE_ELEMENT(deque, idx) ((deque)->arr + (deque)->elem_size * VEC89_DEQUE_SLOT(deque, idx))
+
+/* Grows the ring buffer to the given power of two capacity and unwraps the elements that wrapped around the old end */
+static char vec89_deque_grow(vec89_deque_p deque, size_t capacity) {
+	size_t old_capacity = deque->capacity;
+	void *arr_block;
+
+	if (capacity > VEC89_SIZE_MAX / deque->elem_size) return VEC89_MEMORY_ERROR;
+
+	if (deque->arr == NULL) arr_block = VEC89_ALLOCATE(deque, deque->elem_size * capacity);
+	else arr_block = VEC89_REALLOCATE(deque, deque->arr, deque->elem_size * old_capacity, deque->elem_size * capacity);
+	if (arr_block == NULL) return VEC89_MEMORY_ERROR;
+
+	deque->arr = arr_block;
+	deque->capacity = capacity;
+
+	if (deque->head + deque->count > old_capacity) {
+		size_t head_part = old_capacity - deque->head;
+		size_t wrapped_part = deque->count - head_part;
+
+		/* Move whichever part is smaller, the new capacity is at least twice the old one so both fit */
+		if (wrapped_part <= head_part) {
+			memcpy(deque->arr + deque->elem_size * old_capacity, deque->arr, deque->elem_size * wrapped_part);
+		}
+		else {
+			memcpy(deque->arr + deque->elem_size * (capacity - head_part), deque->arr + deque->elem_size * deque->head, deque->elem_size * head_part);
+			deque->head = capacity - head_part;
+		}
+	}
+
+	return VEC89_SUCCESS;
+}
+
+static char vec89_deque_reserve(vec89_deque_p deque, size_t capacity) {
+	size_t new_capacity = deque->capacity != 0 ? deque->capacity : VEC89_DEQUE_MIN_CAPACITY;
+
+	if (capacity <= deque->capacity) return VEC89_SUCCESS;
+	while (new_capacity < capacity) {
+		if (new_capacity > VEC89_SIZE_MAX / 2) return VEC89_MEMORY_ERROR;
+		new_capacity *= 2;
+	}
+
+	return vec89_deque_grow(deque, new_capacity);
+}
+
+/* Moves n elements from logical index src to dst, one contiguous run of the ring buffer at a time, in the order that is safe for overlap */
+static void vec89_deque_move(vec89_deque_p deque, size_t dst, size_t src, size_t n) {
+	size_t run;
+
+	if (dst < src) {
+		while (n > 0) {
+			size_t src_slot = VEC89_DEQUE_SLOT(deque, src), dst_slot = VEC89_DEQUE_SLOT(deque, dst);
+			run = min(n, min(deque->capacity - src_slot, deque->capacity - dst_slot));
+			memmove(deque->arr + deque->elem_size * dst_slot, deque->arr + deque->elem_size * src_slot, deque->elem_size * run);
+			src += run;
+			dst += run;
+			n -= run;
+		}
+	}
+	else {
+		while (n > 0) {
+			size_t src_end = VEC89_DEQUE_SLOT(deque, src + n - 1) + 1, dst_end = VEC89_DEQUE_SLOT(deque, dst + n - 1) + 1;
+			run = min(n, min(src_end, dst_end));
+			memmove(deque->arr + deque->elem_size * (dst_end - run), deque->arr + deque->elem_size * (src_end - run), deque->elem_size * run);
+			n -= run;
+		}
+	}
+}
+
+/* Reverses the order of the elements in [first, last) of the ring buffer */
+static void vec89_deque_reverse(vec89_deque_p deque, size_t first, size_t last) {
+	while (first + 1 < last) {
+		unsigned char *a = (unsigned char *)deque->arr + deque->elem_size * first;
+		unsigned char *b = (unsigned char *)deque->arr + deque->elem_size * (last - 1);
+		size_t i;
+		for (i = 0; i < deque->elem_size; i++) {
+			unsigned char temp = a[i];
+			a[i] = b[i];
+			b[i] = temp;
+		}
+		first++;
+		last--;
+	}
+}
+
+char VEC89_DEQUE_INITIALIZATION(vec89_deque_p deque, size_t element_size, const vec89_allocator *allocator) {
+	if (deque == NULL || element_size == 0) return VEC89_INVALID_ARGUMENTS;
+
+	deque->arr = NULL;
+	deque->capacity = 0;
+	deque->elem_size = element_size;
+	deque->head = 0;
+	deque->count = 0;
+	deque->allocator = allocator;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock_init(&deque->lock, VEC89_LOCK_POLICY_DEFAULT);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+void VEC89_DEQUE_ARRAY_FREE(vec89_deque_p deque) {
+	if (deque == NULL) return;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+	if (deque->arr != NULL) VEC89_DEALLOCATE(deque, deque->arr, deque->elem_size * deque->capacity);
+	deque->arr = NULL;
+	deque->capacity = 0;
+	deque->head = 0;
+	deque->count = 0;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+	vec89_lock_destroy(&deque->lock);
+#endif
+	return;
+}
+
+char VEC89_DEQUE_RESERVE(vec89_deque_p deque, size_t capacity) {
+	char result;
+	if (deque == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+
+	result = vec89_deque_reserve(deque, capacity);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return result;
+}
+
+char VEC89_DEQUE_CLEAR(vec89_deque_p deque) {
+	if (deque == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+
+	deque->head = 0;
+	deque->count = 0;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_PUSH_BACK(vec89_deque_p deque, const void *element) {
+	if (deque == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+
+	if (deque->count >= deque->capacity) {
+		char result = vec89_deque_reserve(deque, deque->count + 1);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&deque->lock);
+#endif
+			return result;
+		}
+	}
+
+	memcpy(VEC89_DEQUE_ELEMENT(deque, deque->count), element, deque->elem_size);
+	deque->count++;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_PUSH_FRONT(vec89_deque_p deque, const void *element) {
+	if (deque == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+
+	if (deque->count >= deque->capacity) {
+		char result = vec89_deque_reserve(deque, deque->count + 1);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&deque->lock);
+#endif
+			return result;
+		}
+	}
+
+	deque->head = (deque->head - 1) & (deque->capacity - 1);
+	memcpy(deque->arr + deque->elem_size * deque->head, element, deque->elem_size);
+	deque->count++;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_POP_BACK(vec89_deque_p deque, void *out_element) {
+	if (deque == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+	if (deque->count == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&deque->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	deque->count--;
+	if (out_element != NULL) memcpy(out_element, VEC89_DEQUE_ELEMENT(deque, deque->count), deque->elem_size);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_POP_FRONT(vec89_deque_p deque, void *out_element) {
+	if (deque == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+	if (deque->count == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&deque->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (out_element != NULL) memcpy(out_element, deque->arr + deque->elem_size * deque->head, deque->elem_size);
+	deque->head = (deque->head + 1) & (deque->capacity - 1);
+	deque->count--;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_GET(vec89_deque_p deque, size_t idx, void **out_element) {
+	if (deque == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&deque->lock);
+#endif
+	if (idx >= deque->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&deque->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	*out_element = VEC89_DEQUE_ELEMENT(deque, idx);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_SET(vec89_deque_p deque, size_t idx, const void *element) {
+	if (deque == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+	if (idx >= deque->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&deque->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	memcpy(VEC89_DEQUE_ELEMENT(deque, idx), element, deque->elem_size);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_INSERT(vec89_deque_p deque, size_t idx, const void *element) {
+	if (deque == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+	if (idx > deque->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&deque->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (deque->count >= deque->capacity) {
+		char result = vec89_deque_reserve(deque, deque->count + 1);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&deque->lock);
+#endif
+			return result;
+		}
+	}
+
+	/* Shift the shorter side, the front moves one slot towards the head and the back one slot towards the tail */
+	if (idx < deque->count - idx) {
+		deque->head = (deque->head - 1) & (deque->capacity - 1);
+		vec89_deque_move(deque, 0, 1, idx);
+	}
+	else {
+		vec89_deque_move(deque, idx + 1, idx, deque->count - idx);
+	}
+	memcpy(VEC89_DEQUE_ELEMENT(deque, idx), element, deque->elem_size);
+	deque->count++;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_REMOVE(vec89_deque_p deque, size_t idx) {
+	if (deque == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+	if (idx >= deque->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&deque->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (idx < deque->count - 1 - idx) {
+		vec89_deque_move(deque, 1, 0, idx);
+		deque->head = (deque->head + 1) & (deque->capacity - 1);
+	}
+	else {
+		vec89_deque_move(deque, idx, idx + 1, deque->count - 1 - idx);
+	}
+	deque->count--;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_DEQUE_LINEARIZE(vec89_deque_p deque, void **out_arr) {
+	if (deque == NULL || out_arr == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&deque->lock);
+#endif
+
+	if (deque->count == 0) deque->head = 0;
+	else if (deque->head + deque->count > deque->capacity) {
+		/* Rotate the whole buffer left by head in place */
+		vec89_deque_reverse(deque, 0, deque->head);
+		vec89_deque_reverse(deque, deque->head, deque->capacity);
+		vec89_deque_reverse(deque, 0, deque->capacity);
+		deque->head = 0;
+	}
+	*out_arr = deque->arr != NULL ? deque->arr + deque->elem_size * deque->head : NULL;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&deque->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+/* Sets the row count of the vector and every column. The caller must hold the lock. */
+static void vec89_soa_set_count(vec89_soa_p soa, size_t count) {
+	size_t field;
+	for (field = 0; field < soa->field_count; field++) soa->columns[field].count = count;
+	soa->count = count;
+}
+
+/* Grows every column so it can hold at least required rows. The caller must hold the lock. */
+static char vec89_soa_reserve(vec89_soa_p soa, size_t required) {
+	size_t field;
+	for (field = 0; field < soa->field_count; field++) {
+		char result = vec89_grow(&soa->columns[field], required);
+		if (result != VEC89_SUCCESS) return result;
+	}
+	return VEC89_SUCCESS;
+}
+
+/* Copies n fields of size bytes between strided arrays. Common sizes get constant size copies the compiler turns into moves. */
+static void vec89_soa_copy_field(char *dest, size_t dest_stride, const char *src, size_t src_stride, size_t size, size_t n) {
+	size_t i;
+	switch (size) {
+	case 1: for (i = 0; i < n; i++, dest += dest_stride, src += src_stride) *dest = *src; break;
+	case 2: for (i = 0; i < n; i++, dest += dest_stride, src += src_stride) memcpy(dest, src, 2); break;
+	case 4: for (i = 0; i < n; i++, dest += dest_stride, src += src_stride) memcpy(dest, src, 4); break;
+	case 8: for (i = 0; i < n; i++, dest += dest_stride, src += src_stride) memcpy(dest, src, 8); break;
+	case 16: for (i = 0; i < n; i++, dest += dest_stride, src += src_stride) memcpy(dest, src, 16); break;
+	default: for (i = 0; i < n; i++, dest += dest_stride, src += src_stride) memcpy(dest, src, size); break;
+	}
+}
+
+/* Copies n rows of the caller's layout into the columns at idx, one column at a time. The caller must hold the lock. */
+static void vec89_soa_scatter(vec89_soa_p soa, size_t idx, const char *rows, size_t n) {
+	size_t field;
+	for (field = 0; field < soa->field_count; field++) {
+		size_t size = soa->fields[field].size;
+		vec89_soa_copy_field(soa->columns[field].arr + size * idx, size, rows + soa->fields[field].offset, soa->row_size, size, n);
+	}
+}
+
+/* Copies n rows starting at idx from the columns into rows of the caller's layout. The caller must hold the lock. */
+static void vec89_soa_gather(vec89_soa_p soa, size_t idx, char *rows, size_t n) {
+	size_t field;
+	for (field = 0; field < soa->field_count; field++) {
+		size_t size = soa->fields[field].size;
+		vec89_soa_copy_field(rows + soa->fields[field].offset, soa->row_size, soa->columns[field].arr + size * idx, size, size, n);
+	}
+}
+
+char VEC89_SOA_INITIALIZATION(vec89_soa_p soa, const vec89_soa_field *fields, size_t field_count, size_t row_size, const vec89_allocator *allocator) {
+	if (soa == NULL || fields == NULL || field_count == 0 || row_size == 0) return VEC89_INVALID_ARGUMENTS;
+	if (allocator != NULL && (allocator->alloc_function == NULL || allocator->realloc_function == NULL || allocator->free_function == NULL)) return VEC89_INVALID_ARGUMENTS;
+
+	size_t field;
+	for (field = 0; field < field_count; field++) {
+		if (fields[field].size == 0 || fields[field].size > row_size || fields[field].offset > row_size - fields[field].size) return VEC89_INVALID_ARGUMENTS;
+	}
+	if (field_count > VEC89_SIZE_MAX / (sizeof(vec89) + sizeof(vec89_soa_field))) return VEC89_MEMORY_ERROR;
+
+	soa->allocator = allocator;
+
+	/* The columns and the schema share one block, the columns first so both stay aligned */
+	char *block = VEC89_ALLOCATE(soa, (sizeof(vec89) + sizeof(vec89_soa_field)) * field_count);
+	if (block == NULL) return VEC89_MEMORY_ERROR;
+	soa->columns = (vec89 *)block;
+	soa->fields = (vec89_soa_field *)(block + sizeof(vec89) * field_count);
+	memcpy(soa->fields, fields, sizeof(vec89_soa_field) * field_count);
+
+	for (field = 0; field < field_count; field++) {
+		/* Empty columns don't allocate, so this can't fail after the checks above */
+		vec89_initialize(&soa->columns[field], fields[field].size, 0, allocator);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		/* Columns are only reached through the columnar vector, whose lock guards all of them */
+		soa->columns[field].lock.policy = VEC89_LOCK_POLICY_NONE;
+#endif
+	}
+
+	soa->field_count = field_count;
+	soa->row_size = row_size;
+	soa->count = 0;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock_init(&soa->lock, VEC89_LOCK_POLICY_DEFAULT);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+void VEC89_SOA_ARRAY_FREE(vec89_soa_p soa) {
+	if (soa == NULL) return;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	if (soa->columns != NULL) {
+		size_t field;
+		for (field = 0; field < soa->field_count; field++) VEC89_ARRAY_FREE(&soa->columns[field]);
+		VEC89_DEALLOCATE(soa, soa->columns, (sizeof(vec89) + sizeof(vec89_soa_field)) * soa->field_count);
+	}
+	soa->columns = NULL;
+	soa->fields = NULL;
+	soa->field_count = 0;
+	soa->count = 0;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+	vec89_lock_destroy(&soa->lock);
+#endif
+	return;
+}
+
+char VEC89_SOA_CLEAR(vec89_soa_p soa) {
+	if (soa == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	vec89_soa_set_count(soa, 0);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_RESERVE(vec89_soa_p soa, size_t capacity) {
+	if (soa == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	char result = vec89_soa_reserve(soa, capacity);
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return result;
+}
+
+char VEC89_SOA_PUSH(vec89_soa_p soa, const void *row) {
+	return VEC89_SOA_PUSH_N(soa, row, 1);
+}
+
+char VEC89_SOA_PUSH_N(vec89_soa_p soa, const void *rows, size_t n) {
+	if (soa == NULL || (rows == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	if (n > VEC89_SIZE_MAX - soa->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return VEC89_MEMORY_ERROR;
+	}
+
+	char result = vec89_soa_reserve(soa, soa->count + n);
+	if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return result;
+	}
+
+	vec89_soa_scatter(soa, soa->count, rows, n);
+	vec89_soa_set_count(soa, soa->count + n);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_POP_INTO(vec89_soa_p soa, void *out_row) {
+	if (soa == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	if (soa->count == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (out_row != NULL) vec89_soa_gather(soa, soa->count - 1, out_row, 1);
+	vec89_soa_set_count(soa, soa->count - 1);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_GET(vec89_soa_p soa, size_t idx, void *out_row) {
+	return VEC89_SOA_GATHER(soa, idx, out_row, 1);
+}
+
+char VEC89_SOA_SET(vec89_soa_p soa, size_t idx, const void *row) {
+	return VEC89_SOA_SCATTER(soa, idx, row, 1);
+}
+
+char VEC89_SOA_GET_FIELD(vec89_soa_p soa, size_t idx, size_t field, void *out_value) {
+	if (soa == NULL || out_value == NULL || field >= soa->field_count) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&soa->lock);
+#endif
+	if (idx >= soa->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&soa->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	memcpy(out_value, soa->columns[field].arr + soa->fields[field].size * idx, soa->fields[field].size);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_SET_FIELD(vec89_soa_p soa, size_t idx, size_t field, const void *value) {
+	if (soa == NULL || value == NULL || field >= soa->field_count) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	if (idx >= soa->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	memcpy(soa->columns[field].arr + soa->fields[field].size * idx, value, soa->fields[field].size);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_INSERT(vec89_soa_p soa, size_t idx, const void *row) {
+	if (soa == NULL || row == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	if (idx > soa->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	char result = vec89_soa_reserve(soa, soa->count + 1);
+	if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return result;
+	}
+
+	size_t field;
+	for (field = 0; field < soa->field_count; field++) {
+		size_t size = soa->fields[field].size;
+		char *column = soa->columns[field].arr;
+		memmove(column + size * (idx + 1), column + size * idx, size * (soa->count - idx));
+	}
+	vec89_soa_scatter(soa, idx, row, 1);
+	vec89_soa_set_count(soa, soa->count + 1);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_REMOVE(vec89_soa_p soa, size_t idx) {
+	if (soa == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	if (idx >= soa->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	size_t field;
+	for (field = 0; field < soa->field_count; field++) {
+		size_t size = soa->fields[field].size;
+		char *column = soa->columns[field].arr;
+		memmove(column + size * idx, column + size * (idx + 1), size * (soa->count - 1 - idx));
+	}
+	vec89_soa_set_count(soa, soa->count - 1);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_GATHER(vec89_soa_p soa, size_t idx, void *out_rows, size_t n) {
+	if (soa == NULL || (out_rows == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&soa->lock);
+#endif
+	if (idx > soa->count || n > soa->count - idx) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&soa->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	vec89_soa_gather(soa, idx, out_rows, n);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_SCATTER(vec89_soa_p soa, size_t idx, const void *rows, size_t n) {
+	if (soa == NULL || (rows == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&soa->lock);
+#endif
+	if (idx > soa->count || n > soa->count - idx) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&soa->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	vec89_soa_scatter(soa, idx, rows, n);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&soa->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SOA_VIEW(vec89_soa_p soa, size_t begin, size_t end, char writable, vec89_view *out_views) {
+	if (soa == NULL || out_views == NULL || begin > end) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK_ACQUIRE(&soa->lock, !writable);
+#endif
+	if (end == VEC89_VIEW_END_OF_VECTOR) end = max(soa->count, begin);
+	if (end > soa->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_LOCK_RELEASE(&soa->lock, !writable);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	size_t field;
+	for (field = 0; field < soa->field_count; field++) {
+		out_views[field].data = soa->columns[field].arr + soa->fields[field].size * begin;
+		out_views[field].stride = soa->fields[field].size;
+		out_views[field].count = end - begin;
+		/* No owning vector, the columnar vector's lock is released as a whole by VEC89_SOA_VIEW_RELEASE */
+		out_views[field].vec = NULL;
+		out_views[field].writable = writable != 0;
+	}
+
+	/* The lock stays held until VEC89_SOA_VIEW_RELEASE */
+	return VEC89_SUCCESS;
+}
+
+void VEC89_SOA_VIEW_RELEASE(vec89_soa_p soa, vec89_view *views) {
+	if (soa == NULL || views == NULL) return;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK_RELEASE(&soa->lock, !views[0].writable);
+#endif
+	return;
+}
+
+#define VEC89_BITS_WORDS(count) ((count) / VEC89_BITS_PER_WORD + ((count) % VEC89_BITS_PER_WORD != 0)) /* Words holding count bits */
+#define VEC89_BITS_MASK(idx) ((size_t)1 << ((idx) % VEC89_BITS_PER_WORD))
+
+#define VEC89_BITS_OP_AND 0
+#define VEC89_BITS_OP_OR 1
+#define VEC89_BITS_OP_XOR 2
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define VEC89_POPCNT_X86
+#endif
+
+/* Branch-free popcount of one word, the constants are built from the width of size_t */
+VEC89_INLINE size_t vec89_word_popcount(size_t word) {
+	const size_t ones = ~(size_t)0;
+	word -= (word >> 1) & (ones / 3);
+	word = (word & (ones / 15 * 3)) + ((word >> 2) & (ones / 15 * 3));
+	word = (word + (word >> 4)) & (ones / 255 * 15);
+	return (word * (ones / 255)) >> (sizeof(size_t) - 1) * 8;
+}
+
+/* Index of the lowest set bit, word != 0 */
+VEC89_INLINE size_t vec89_word_ctz(size_t word) {
+#if defined(__GNUC__)
+	return (size_t)(sizeof(size_t) == sizeof(unsigned long long) ? __builtin_ctzll(word) : __builtin_ctz((unsigned int)word));
+#else
+	size_t result = 0;
+	while (!(word & 1)) {
+		word >>= 1;
+		result++;
+	}
+	return result;
+#endif
+}
+
+#ifdef VEC89_POPCNT_X86
+/* Checked once, racing threads store the same value */
+static int vec89_has_popcnt(void) {
+	static volatile int has = -1;
+	if (has < 0) {
+		__builtin_cpu_init();
+		has = __builtin_cpu_supports("popcnt") != 0;
+	}
+	return has;
+}
+
+/* Four independent sums keep several popcnt instructions in flight */
+__attribute__((target("popcnt"))) static size_t vec89_popcount_words_popcnt(const size_t *words, size_t n) {
+	size_t i, sums[4] = { 0, 0, 0, 0 };
+	for (i = 0; i + 4 <= n; i += 4) {
+		sums[0] += (size_t)__builtin_popcountll(words[i]);
+		sums[1] += (size_t)__builtin_popcountll(words[i + 1]);
+		sums[2] += (size_t)__builtin_popcountll(words[i + 2]);
+		sums[3] += (size_t)__builtin_popcountll(words[i + 3]);
+	}
+	for (; i < n; i++) sums[0] += (size_t)__builtin_popcountll(words[i]);
+	return sums[0] + sums[1] + sums[2] + sums[3];
+}
+#endif
+
+static size_t vec89_popcount_words(const size_t *words, size_t n) {
+	size_t i, count = 0;
+#ifdef VEC89_POPCNT_X86
+	if (vec89_has_popcnt()) return vec89_popcount_words_popcnt(words, n);
+#endif
+	for (i = 0; i < n; i++) count += vec89_word_popcount(words[i]);
+	return count;
+}
+
+static char vec89_bits_reserve(vec89_bits_p bits, size_t capacity) {
+	size_t required = VEC89_BITS_WORDS(capacity), new_capacity = bits->capacity != 0 ? bits->capacity : VEC89_BITS_MIN_CAPACITY;
+	void *words_block;
+
+	if (required <= bits->capacity) return VEC89_SUCCESS;
+	while (new_capacity < required) {
+		if (new_capacity > VEC89_SIZE_MAX / 2) return VEC89_MEMORY_ERROR;
+		new_capacity *= 2;
+	}
+	if (new_capacity > VEC89_SIZE_MAX / sizeof(size_t)) return VEC89_MEMORY_ERROR;
+
+	if (bits->words == NULL) words_block = VEC89_ALLOCATE(bits, sizeof(size_t) * new_capacity);
+	else words_block = VEC89_REALLOCATE(bits, bits->words, sizeof(size_t) * bits->capacity, sizeof(size_t) * new_capacity);
+	if (words_block == NULL) return VEC89_MEMORY_ERROR;
+
+	bits->words = words_block;
+	bits->capacity = new_capacity;
+	return VEC89_SUCCESS;
+}
+
+/* Clears the bits of the last word past count */
+static void vec89_bits_mask_tail(vec89_bits_p bits) {
+	if (bits->count % VEC89_BITS_PER_WORD != 0) bits->words[bits->count / VEC89_BITS_PER_WORD] &= VEC89_BITS_MASK(bits->count) - 1;
+}
+
+char VEC89_BITS_INITIALIZATION(vec89_bits_p bits, const vec89_allocator *allocator) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	bits->words = NULL;
+	bits->capacity = 0;
+	bits->count = 0;
+	bits->allocator = allocator;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock_init(&bits->lock, VEC89_LOCK_POLICY_DEFAULT);
+#endif
+
+	return VEC89_SUCCESS;
+}
+
+void VEC89_BITS_ARRAY_FREE(vec89_bits_p bits) {
+	if (bits == NULL) return;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+	if (bits->words != NULL) VEC89_DEALLOCATE(bits, bits->words, sizeof(size_t) * bits->capacity);
+	bits->words = NULL;
+	bits->capacity = 0;
+	bits->count = 0;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+	vec89_lock_destroy(&bits->lock);
+#endif
+	return;
+}
+
+char VEC89_BITS_RESERVE(vec89_bits_p bits, size_t capacity) {
+	char result;
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+
+	result = vec89_bits_reserve(bits, capacity);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return result;
+}
+
+char VEC89_BITS_RESIZE(vec89_bits_p bits, size_t count, char value) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+
+	if (count > bits->count) {
+		char result = vec89_bits_reserve(bits, count);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&bits->lock);
+#endif
+			return result;
+		}
+
+		/* The tail of the old last word is already zero, so only ones need to be written into it */
+		size_t i, fill = value ? ~(size_t)0 : 0;
+		if (value && bits->count % VEC89_BITS_PER_WORD != 0) bits->words[bits->count / VEC89_BITS_PER_WORD] |= ~(VEC89_BITS_MASK(bits->count) - 1);
+		for (i = VEC89_BITS_WORDS(bits->count); i < VEC89_BITS_WORDS(count); i++) bits->words[i] = fill;
+	}
+	bits->count = count;
+	if (count > 0) vec89_bits_mask_tail(bits);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_PUSH(vec89_bits_p bits, char value) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+
+	if (bits->count % VEC89_BITS_PER_WORD == 0) {
+		char result = vec89_bits_reserve(bits, bits->count + 1);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&bits->lock);
+#endif
+			return result;
+		}
+		bits->words[bits->count / VEC89_BITS_PER_WORD] = 0;
+	}
+
+	if (value) bits->words[bits->count / VEC89_BITS_PER_WORD] |= VEC89_BITS_MASK(bits->count);
+	bits->count++;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_POP(vec89_bits_p bits, char *out_value) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+	if (bits->count == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&bits->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	bits->count--;
+	size_t *word = &bits->words[bits->count / VEC89_BITS_PER_WORD];
+	if (out_value != NULL) *out_value = (*word & VEC89_BITS_MASK(bits->count)) != 0;
+	*word &= ~VEC89_BITS_MASK(bits->count);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_GET(vec89_bits_p bits, size_t idx, char *out_value) {
+	if (bits == NULL || out_value == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&bits->lock);
+#endif
+	if (idx >= bits->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&bits->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	*out_value = (bits->words[idx / VEC89_BITS_PER_WORD] & VEC89_BITS_MASK(idx)) != 0;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_SET(vec89_bits_p bits, size_t idx, char value) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+	if (idx >= bits->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&bits->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (value) bits->words[idx / VEC89_BITS_PER_WORD] |= VEC89_BITS_MASK(idx);
+	else bits->words[idx / VEC89_BITS_PER_WORD] &= ~VEC89_BITS_MASK(idx);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_INSERT(vec89_bits_p bits, size_t idx, char value) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+	if (idx > bits->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&bits->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	if (bits->count % VEC89_BITS_PER_WORD == 0) {
+		char result = vec89_bits_reserve(bits, bits->count + 1);
+		if (result != VEC89_SUCCESS) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+			VEC89_UNLOCK(&bits->lock);
+#endif
+			return result;
+		}
+		bits->words[bits->count / VEC89_BITS_PER_WORD] = 0;
+	}
+
+	/* Every word above idx takes the top bit of the word below it, the word holding idx keeps the bits below idx */
+	size_t *words = bits->words, first = idx / VEC89_BITS_PER_WORD, w;
+	size_t low = VEC89_BITS_MASK(idx) - 1;
+	for (w = bits->count / VEC89_BITS_PER_WORD; w > first; w--) words[w] = (words[w] << 1) | (words[w - 1] >> (VEC89_BITS_PER_WORD - 1));
+	words[first] = (words[first] & low) | ((words[first] & ~low) << 1);
+	if (value) words[first] |= VEC89_BITS_MASK(idx);
+	bits->count++;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_REMOVE(vec89_bits_p bits, size_t idx) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+	if (idx >= bits->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&bits->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	/* Mirror of VEC89_BITS_INSERT, every word takes the bottom bit of the word above it */
+	size_t *words = bits->words, first = idx / VEC89_BITS_PER_WORD, last = (bits->count - 1) / VEC89_BITS_PER_WORD, w;
+	size_t low = VEC89_BITS_MASK(idx) - 1;
+	words[first] = (words[first] & low) | ((words[first] >> 1) & ~low);
+	for (w = first; w < last; w++) {
+		words[w] |= words[w + 1] << (VEC89_BITS_PER_WORD - 1);
+		words[w + 1] >>= 1;
+	}
+	bits->count--;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+/* Applies op word by word, one plain loop per operation so each vectorizes */
+static char vec89_bits_combine(vec89_bits_p bits, vec89_bits_p other, char op) {
+	if (bits == NULL || other == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	/* Locked in address order, like VEC89_APPEND_VEC */
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	if (bits == other) VEC89_LOCK(&bits->lock);
+	else if (bits < other) {
+		VEC89_LOCK(&bits->lock);
+		VEC89_READ_LOCK(&other->lock);
+	}
+	else {
+		VEC89_READ_LOCK(&other->lock);
+		VEC89_LOCK(&bits->lock);
+	}
+#endif
+
+	char result = VEC89_SUCCESS;
+	if (bits->count != other->count) result = VEC89_INVALID_ARGUMENTS;
+	else {
+		size_t *words = bits->words, i, n = VEC89_BITS_WORDS(bits->count);
+		const size_t *source = other->words;
+		switch (op) {
+			case VEC89_BITS_OP_AND: for (i = 0; i < n; i++) words[i] &= source[i]; break;
+			case VEC89_BITS_OP_OR: for (i = 0; i < n; i++) words[i] |= source[i]; break;
+			default: for (i = 0; i < n; i++) words[i] ^= source[i]; break;
+		}
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	if (bits != other) VEC89_READ_UNLOCK(&other->lock);
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return result;
+}
+
+char VEC89_BITS_AND(vec89_bits_p bits, vec89_bits_p other) {
+	return vec89_bits_combine(bits, other, VEC89_BITS_OP_AND);
+}
+
+char VEC89_BITS_OR(vec89_bits_p bits, vec89_bits_p other) {
+	return vec89_bits_combine(bits, other, VEC89_BITS_OP_OR);
+}
+
+char VEC89_BITS_XOR(vec89_bits_p bits, vec89_bits_p other) {
+	return vec89_bits_combine(bits, other, VEC89_BITS_OP_XOR);
+}
+
+char VEC89_BITS_NOT(vec89_bits_p bits) {
+	if (bits == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&bits->lock);
+#endif
+
+	size_t *words = bits->words, i, n = VEC89_BITS_WORDS(bits->count);
+	for (i = 0; i < n; i++) words[i] = ~words[i];
+	if (n > 0) vec89_bits_mask_tail(bits);
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_POPCOUNT(vec89_bits_p bits, size_t *out_count) {
+	if (bits == NULL || out_count == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&bits->lock);
+#endif
+
+	*out_count = vec89_popcount_words(bits->words, VEC89_BITS_WORDS(bits->count));
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_RANK(vec89_bits_p bits, size_t idx, size_t *out_rank) {
+	if (bits == NULL || out_rank == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&bits->lock);
+#endif
+	if (idx > bits->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&bits->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	size_t rank = vec89_popcount_words(bits->words, idx / VEC89_BITS_PER_WORD);
+	if (idx % VEC89_BITS_PER_WORD != 0) rank += vec89_word_popcount(bits->words[idx / VEC89_BITS_PER_WORD] & (VEC89_BITS_MASK(idx) - 1));
+	*out_rank = rank;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_BITS_FIND_FIRST_SET(vec89_bits_p bits, size_t *out_idx) {
+	return VEC89_BITS_FIND_NEXT_SET(bits, 0, out_idx);
+}
+
+char VEC89_BITS_FIND_NEXT_SET(vec89_bits_p bits, size_t idx, size_t *out_idx) {
+	if (bits == NULL || out_idx == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_LOCK(&bits->lock);
+#endif
+	if (idx > bits->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_READ_UNLOCK(&bits->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+
+	/* The bits past count are zero, so a set bit found in the last word is always inside the vector */
+	size_t w = idx / VEC89_BITS_PER_WORD, n = VEC89_BITS_WORDS(bits->count);
+	*out_idx = bits->count;
+	if (w < n) {
+		size_t word = bits->words[w] & ~(VEC89_BITS_MASK(idx) - 1);
+		while (word == 0 && ++w < n) word = bits->words[w];
+		if (word != 0) *out_idx = w * VEC89_BITS_PER_WORD + vec89_word_ctz(word);
+	}
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_READ_UNLOCK(&bits->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+static size_t vec89_floor_log2(size_t value) {
+#if defined(__GNUC__)
+	return sizeof(size_t) * 8 - 1 - (size_t)(sizeof(size_t) == sizeof(unsigned long long) ? __builtin_clzll(value) : __builtin_clz((unsigned int)value));
+#else
+	size_t result = 0;
+	while (value >>= 1) result++;
+	return result;
+#endif
+}
+
+/*
+Maps idx to its segment and the offset inside it, for segment k holding first_segment << k elements.
+first_segment is a power of two constant, so the division is a shift. Returns 0 if idx is past the last segment
+*/
+static char vec89_segment_locate(size_t idx, size_t first_segment, size_t segment_count, size_t *out_segment, size_t *out_offset) {
+	size_t segment = vec89_floor_log2(idx / first_segment + 1);
+	if (segment >= segment_count) return 0;
+
+	*out_segment = segment;
+	*out_offset = idx - first_segment * (((size_t)1 << segment) - 1);
+	return 1;
+}
+
+#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+
+/* Returns the segment, allocating it if no thread did yet. Returns NULL if the allocation failed */
+static char *vec89_concurrent_segment(vec89_concurrent_p vec, size_t segment) {
+	char *segment_block = VEC89_ATOMIC_LOAD_PTR(&vec->segments[segment]);
+	if (segment_block != NULL) return segment_block;
+
+	size_t segment_capacity = (size_t)VEC89_CONCURRENT_FIRST_SEGMENT << segment;
+	if (segment_capacity > VEC89_SIZE_MAX / vec->elem_size) return NULL;
+
+	segment_block = VEC89_ALLOCATE(vec, vec->elem_size * segment_capacity);
+	if (segment_block == NULL) return NULL;
+
+	/* Another thread may have installed the segment first, keep theirs */
+	if (!VEC89_ATOMIC_CAS_PTR(&vec->segments[segment], NULL, segment_block)) {
+		VEC89_DEALLOCATE(vec, segment_block, vec->elem_size * segment_capacity);
+		segment_block = VEC89_ATOMIC_LOAD_PTR(&vec->segments[segment]);
+	}
+
+	return segment_block;
+}
+
+char VEC89_CONCURRENT_INITIALIZATION(vec89_concurrent_p vec, size_t element_size, const vec89_allocator *allocator) {
+	if (vec == NULL || element_size == 0) return VEC89_INVALID_ARGUMENTS;
+	if (allocator != NULL && (allocator->alloc_function == NULL || allocator->realloc_function == NULL || allocator->free_function == NULL)) return VEC89_INVALID_ARGUMENTS;
+
+	size_t i;
+	for (i = 0; i < VEC89_CONCURRENT_SEGMENT_COUNT; i++) vec->segments[i] = NULL;
 	vec->elem_size = element_size;
+	vec->reserved = 0;
 	vec->count = 0;
+	vec->failed = 0;
+	vec->allocator = allocator;
 
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
-#endif
-	
 	return VEC89_SUCCESS;
 }
 
-void VEC89_ARRAY_FREE(vec_p vec) {
+void VEC89_CONCURRENT_ARRAY_FREE(vec89_concurrent_p vec) {
 	if (vec == NULL) return;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	free(vec->arr);
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
-#endif
-	return;
-}
 
-void VEC89_FREE(vec_p vec) {
-	if (vec == NULL) return;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	free(vec->arr);
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK_TYPE *lock_pointer = vec->lock;
-#endif
-	free(vec);
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK_DESTROY(lock_pointer);
-	free(lock_pointer);
-#endif
+	size_t i;
+	for (i = 0; i < VEC89_CONCURRENT_SEGMENT_COUNT; i++) {
+		if (vec->segments[i] == NULL) continue;
+		VEC89_DEALLOCATE(vec, vec->segments[i], vec->elem_size * ((size_t)VEC89_CONCURRENT_FIRST_SEGMENT << i));
+		vec->segments[i] = NULL;
+	}
 	return;
 }
 
-char VEC89_CLEAR(vec_p vec) {
+char VEC89_CONCURRENT_RESERVE(vec89_concurrent_p vec, size_t capacity) {
 	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	vec->count = 0;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
-#endif
+	if (capacity == 0) return VEC89_SUCCESS;
+
+	size_t last_segment, offset;
+	if (!vec89_segment_locate(capacity - 1, VEC89_CONCURRENT_FIRST_SEGMENT, VEC89_CONCURRENT_SEGMENT_COUNT, &last_segment, &offset)) return VEC89_MEMORY_ERROR;
+
+	size_t i;
+	for (i = 0; i <= last_segment; i++) {
+		if (vec89_concurrent_segment(vec, i) == NULL) return VEC89_MEMORY_ERROR;
+	}
+
 	return VEC89_SUCCESS;
 }
 
-char VEC89_RESERVE(vec_p vec, size_t capacity) {
-	if (vec == NULL || capacity == 0) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL || capacity < vec->count) {
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
-#endif
-		return VEC89_INVALID_ARGUMENTS;
-	}
-	if (capacity == vec->capacity) {
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
-#endif
-		return VEC89_SUCCESS;
-	}
+char VEC89_CONCURRENT_PUSH(vec89_concurrent_p vec, const void *element, size_t *out_idx) {
+	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+	if (VEC89_ATOMIC_LOAD(&vec->failed)) return VEC89_MEMORY_ERROR;
 
-	void *arr_block = REALLOC_FUNCTION(vec->arr, vec->elem_size * capacity);
-	if (arr_block == NULL) {
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
-#endif
+	size_t idx = VEC89_ATOMIC_FETCH_ADD(&vec->reserved, 1);
+	size_t segment, offset;
+	char *segment_block = NULL;
+
+	if (vec89_segment_locate(idx, VEC89_CONCURRENT_FIRST_SEGMENT, VEC89_CONCURRENT_SEGMENT_COUNT, &segment, &offset)) segment_block = vec89_concurrent_segment(vec, segment);
+	if (segment_block == NULL) {
+		/* The index can't be filled, stop every writer waiting to publish behind it */
+		VEC89_ATOMIC_STORE(&vec->failed, 1);
 		return VEC89_MEMORY_ERROR;
 	}
 
-	vec->arr = arr_block;
-	vec->capacity = capacity;
+	memcpy(segment_block + vec->elem_size * offset, element, vec->elem_size);
 
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
-#endif
+	/* Publish in index order, writers of earlier indices finish first. Yield in case they were preempted */
+	size_t spins = 0;
+	while (VEC89_ATOMIC_LOAD(&vec->count) != idx) {
+		if (VEC89_ATOMIC_LOAD(&vec->failed)) return VEC89_MEMORY_ERROR;
+		if (++spins < VEC89_SPIN_LIMIT) {
+			VEC89_CPU_RELAX();
+		} else {
+			VEC89_THREAD_YIELD();
+		}
+	}
+	VEC89_ATOMIC_STORE(&vec->count, idx + 1);
 
+	if (out_idx != NULL) *out_idx = idx;
 	return VEC89_SUCCESS;
 }
 
-char VEC89_EXPAND(vec_p vec, size_t n) {
-	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL) {
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+char VEC89_CONCURRENT_GET(vec89_concurrent_p vec, size_t idx, void **out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+	if (idx >= VEC89_ATOMIC_LOAD(&vec->count)) return VEC89_ARRAY_OUT_OF_INDEX;
+
+	size_t segment, offset;
+	if (!vec89_segment_locate(idx, VEC89_CONCURRENT_FIRST_SEGMENT, VEC89_CONCURRENT_SEGMENT_COUNT, &segment, &offset)) return VEC89_ARRAY_OUT_OF_INDEX;
+
+	*out_element = vec->segments[segment] + vec->elem_size * offset;
+	return VEC89_SUCCESS;
+}
+
+size_t VEC89_CONCURRENT_COUNT(vec89_concurrent_p vec) {
+	if (vec == NULL) return 0;
+	return VEC89_ATOMIC_LOAD(&vec->count);
+}
 #endif
-		return VEC89_INVALID_ARGUMENTS;
+
+/* Logical index of the first element of a segment */
+#define VEC89_SEGMENTED_BEGIN(segment) (VEC89_SEGMENTED_FIRST_SEGMENT * (((size_t)1 << (segment)) - 1))
+#define VEC89_SEGMENTED_CAPACITY(segment) ((size_t)VEC89_SEGMENTED_FIRST_SEGMENT << (segment))
+
+/* Returns the element at idx, idx must be below the capacity */
+static char *vec89_segmented_element(vec89_segmented_p vec, size_t idx) {
+	size_t segment = 0, offset = 0;
+	vec89_segment_locate(idx, VEC89_SEGMENTED_FIRST_SEGMENT, VEC89_SEGMENTED_SEGMENT_COUNT, &segment, &offset);
+	return vec->segments[segment] + vec->elem_size * offset;
+}
+
+/* Allocates segments until capacity elements fit */
+static char vec89_segmented_reserve(vec89_segmented_p vec, size_t capacity) {
+	while (vec->capacity < capacity) {
+		size_t segment_capacity = VEC89_SEGMENTED_CAPACITY(vec->segment_count);
+		char *segment_block;
+
+		if (vec->segment_count >= VEC89_SEGMENTED_SEGMENT_COUNT || segment_capacity > VEC89_SIZE_MAX / vec->elem_size) return VEC89_MEMORY_ERROR;
+		segment_block = VEC89_ALLOCATE(vec, vec->elem_size * segment_capacity);
+		if (segment_block == NULL) return VEC89_MEMORY_ERROR;
+
+		vec->segments[vec->segment_count++] = segment_block;
+		vec->capacity += segment_capacity;
 	}
-	if (n == 0) return VEC89_SUCCESS;
+	return VEC89_SUCCESS;
+}
 
-	size_t target_capacity = vec->capacity << n;
+/* Moves the elements in [idx, count) up by one, last segment first. count must be below the capacity */
+static void vec89_segmented_shift_up(vec89_segmented_p vec, size_t idx) {
+	size_t first = 0, offset = 0, segment = 0;
+	vec89_segment_locate(idx, VEC89_SEGMENTED_FIRST_SEGMENT, VEC89_SEGMENTED_SEGMENT_COUNT, &first, &offset);
+	vec89_segment_locate(vec->count, VEC89_SEGMENTED_FIRST_SEGMENT, VEC89_SEGMENTED_SEGMENT_COUNT, &segment, &offset);
+
+	for (;; segment--) {
+		size_t begin = VEC89_SEGMENTED_BEGIN(segment), end = begin + VEC89_SEGMENTED_CAPACITY(segment);
+		size_t lo = max(idx, begin), hi = min(vec->count, end);
+
+		if (lo < hi) {
+			/* The last element of a full segment crosses into the next one, which was already shifted */
+			if (hi == end) {
+				memcpy(vec->segments[segment + 1], vec->segments[segment] + vec->elem_size * (hi - 1 - begin), vec->elem_size);
+				hi--;
+			}
+			memmove(vec->segments[segment] + vec->elem_size * (lo + 1 - begin), vec->segments[segment] + vec->elem_size * (lo - begin), vec->elem_size * (hi - lo));
+		}
+		if (segment == first) break;
+	}
+}
 
-	void *arr_block = REALLOC_FUNCTION(vec->arr, vec->elem_size * target_capacity);
-	if (arr_block == NULL) {
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
-#endif
-		return VEC89_MEMORY_ERROR;
+/* Moves the elements in [idx + 1, count) down by one, first segment first */
+static void vec89_segmented_shift_down(vec89_segmented_p vec, size_t idx) {
+	size_t segment = 0, offset = 0;
+	vec89_segment_locate(idx, VEC89_SEGMENTED_FIRST_SEGMENT, VEC89_SEGMENTED_SEGMENT_COUNT, &segment, &offset);
+
+	for (; segment < vec->segment_count; segment++) {
+		size_t begin = VEC89_SEGMENTED_BEGIN(segment), end = begin + VEC89_SEGMENTED_CAPACITY(segment);
+		size_t lo = max(idx + 1, begin), hi = min(vec->count, end);
+
+		if (lo < hi) {
+			/* The first element of a segment crosses into the previous one */
+			if (lo == begin) {
+				memcpy(vec->segments[segment - 1] + vec->elem_size * (VEC89_SEGMENTED_CAPACITY(segment - 1) - 1), vec->segments[segment], vec->elem_size);
+				lo++;
+			}
+			memmove(vec->segments[segment] + vec->elem_size * (lo - 1 - begin), vec->segments[segment] + vec->elem_size * (lo - begin), vec->elem_size * (hi - lo));
+		}
+		if (end >= vec->count) break;
 	}
+}
 
-	vec->arr = arr_block;
-	vec->capacity = target_capacity;
+char VEC89_SEGMENTED_INITIALIZATION(vec89_segmented_p vec, size_t element_size, const vec89_allocator *allocator) {
+	size_t i;
+	if (vec == NULL || element_size == 0) return VEC89_INVALID_ARGUMENTS;
+	if (allocator != NULL && (allocator->alloc_function == NULL || allocator->realloc_function == NULL || allocator->free_function == NULL)) return VEC89_INVALID_ARGUMENTS;
 
+	for (i = 0; i < VEC89_SEGMENTED_SEGMENT_COUNT; i++) vec->segments[i] = NULL;
+	vec->segment_count = 0;
+	vec->capacity = 0;
+	vec->elem_size = element_size;
+	vec->count = 0;
+	vec->allocator = allocator;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	vec89_lock_init(&vec->lock, VEC89_LOCK_POLICY_DEFAULT);
 #endif
 
 	return VEC89_SUCCESS;
 }
 
-char VEC89_SHRINK(vec_p vec, size_t n) {
-	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL) {
+void VEC89_SEGMENTED_ARRAY_FREE(vec89_segmented_p vec) {
+	if (vec == NULL) return;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-		return VEC89_INVALID_ARGUMENTS;
+	while (vec->segment_count > 0) {
+		vec->segment_count--;
+		VEC89_DEALLOCATE(vec, vec->segments[vec->segment_count], vec->elem_size * VEC89_SEGMENTED_CAPACITY(vec->segment_count));
+		vec->segments[vec->segment_count] = NULL;
 	}
-	if (n == 0 || vec->capacity <= 1 || vec->capacity <= vec->count) {
+	vec->capacity = 0;
+	vec->count = 0;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
+	vec89_lock_destroy(&vec->lock);
 #endif
-		return VEC89_SUCCESS;
-	}
-
-	size_t target_capacity = vec->capacity;
-	size_t i;
-	for (i = 0; i < n; i++) {
-		if (target_capacity <= 1 || target_capacity <= vec->count) break;
-		target_capacity /= 2;
-	}
+	return;
+}
 
-	void *arr_block = REALLOC_FUNCTION(vec->arr, vec->elem_size * target_capacity);
-	if (arr_block == NULL) {
+char VEC89_SEGMENTED_CLEAR(vec89_segmented_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-		return VEC89_MEMORY_ERROR;
-	}
 
-	vec->arr = arr_block;
-	vec->capacity = target_capacity;
+	vec->count = 0;
 
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
-
 	return VEC89_SUCCESS;
 }
 
-char VEC89_SHRINK_TO_FIT(vec_p vec) {
+char VEC89_SEGMENTED_RESERVE(vec89_segmented_p vec, size_t capacity) {
+	char result;
 	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-	if (vec->arr == NULL) {
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
-#endif
-		return VEC89_INVALID_ARGUMENTS;
-	}
-	if (vec->capacity == 0 || vec->capacity == vec->count) {
+
+	result = vec89_segmented_reserve(vec, capacity);
+
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
-		return VEC89_SUCCESS;
-	}
+	return result;
+}
 
-	void *arr_block = REALLOC_FUNCTION(vec->arr, vec->elem_size * max(vec->count, 1));
-	if (arr_block == NULL) {
+char VEC89_SEGMENTED_SHRINK_TO_FIT(vec89_segmented_p vec) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-		return VEC89_MEMORY_ERROR;
-	}
 
-	vec->arr = arr_block;
-	vec->capacity = max(vec->count, 1);
+	while (vec->segment_count > 0 && VEC89_SEGMENTED_BEGIN(vec->segment_count - 1) >= vec->count) {
+		vec->segment_count--;
+		VEC89_DEALLOCATE(vec, vec->segments[vec->segment_count], vec->elem_size * VEC89_SEGMENTED_CAPACITY(vec->segment_count));
+		vec->segments[vec->segment_count] = NULL;
+		vec->capacity -= VEC89_SEGMENTED_CAPACITY(vec->segment_count);
+	}
 
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
-
 	return VEC89_SUCCESS;
 }
 
-char VEC89_PUSH(vec_p vec, const void *element) {
-	if (vec == NULL || element == NULL ) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL) {
+char VEC89_SEGMENTED_PUSH(vec89_segmented_p vec, const void *element) {
+	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-		return VEC89_INVALID_ARGUMENTS;
-	}
-	
-	if (vec->count >= vec->capacity) {
-		size_t target_capacity = vec->capacity * 2;
 
-		void *arr_block = REALLOC_FUNCTION(vec->arr, vec->elem_size * target_capacity);
-		if (arr_block == NULL) {
+	if (vec->count >= vec->capacity) {
+		char result = vec89_segmented_reserve(vec, vec->count + 1);
+		if (result != VEC89_SUCCESS) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-			VEC89_UNLOCK(vec->lock);
+			VEC89_UNLOCK(&vec->lock);
 #endif
-			return VEC89_MEMORY_ERROR;
+			return result;
 		}
-
-		vec->arr = arr_block;
-		vec->capacity = target_capacity;
 	}
 
-	memcpy(vec->arr + vec->count * vec->elem_size, element, vec->elem_size);
+	memcpy(vec89_segmented_element(vec, vec->count), element, vec->elem_size);
 	vec->count++;
 
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
-
 	return VEC89_SUCCESS;
 }
 
-char VEC89_POP(vec_p vec, void **out_element) {
-	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
+char VEC89_SEGMENTED_PUSH_N(vec89_segmented_p vec, const void *elements, size_t n) {
+	const char *source = elements;
+	char result;
+	if (vec == NULL || (elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-	if (vec->arr == NULL) {
+
+	result = n > VEC89_SIZE_MAX - vec->count ? VEC89_MEMORY_ERROR : vec89_segmented_reserve(vec, vec->count + n);
+	if (result != VEC89_SUCCESS) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+		VEC89_UNLOCK(&vec->lock);
 #endif
-		return VEC89_INVALID_ARGUMENTS;
+		return result;
 	}
-	if (vec->count == 0) {
-		*out_element = NULL;
+
+	while (n > 0) {
+		size_t segment = 0, offset = 0, run;
+		vec89_segment_locate(vec->count, VEC89_SEGMENTED_FIRST_SEGMENT, VEC89_SEGMENTED_SEGMENT_COUNT, &segment, &offset);
+		run = min(n, VEC89_SEGMENTED_CAPACITY(segment) - offset);
+
+		memcpy(vec->segments[segment] + vec->elem_size * offset, source, vec->elem_size * run);
+		source += vec->elem_size * run;
+		vec->count += run;
+		n -= run;
+	}
+
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
-		return VEC89_SUCCESS;
-	}
+	return VEC89_SUCCESS;
+}
 
-	*out_element = MALLOC_FUNCTION(vec->elem_size);
-	if (*out_element == NULL) {
+char VEC89_SEGMENTED_POP_INTO(vec89_segmented_p vec, void *out_element) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-		return VEC89_MEMORY_ERROR;
+	if (vec->count == 0) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
 	}
 
-	memcpy(*out_element, vec->arr + vec->elem_size * (vec->count - 1), vec->elem_size);
 	vec->count--;
+	if (out_element != NULL) memcpy(out_element, vec89_segmented_element(vec, vec->count), vec->elem_size);
 
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
-
 	return VEC89_SUCCESS;
 }
 
-char VEC89_SET(vec_p vec, size_t idx, const void *element) {
-	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL) {
+char VEC89_SEGMENTED_GET(vec89_segmented_p vec, size_t idx, void **out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_READ_LOCK(&vec->lock);
 #endif
-		return VEC89_INVALID_ARGUMENTS;
-	}
-	if (idx >= vec->capacity) {
+	if (idx >= vec->count) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+		VEC89_READ_UNLOCK(&vec->lock);
 #endif
 		return VEC89_ARRAY_OUT_OF_INDEX;
 	}
 
-	memcpy(vec->arr + vec->elem_size * idx, element, vec->elem_size);
+	*out_element = vec89_segmented_element(vec, idx);
 
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_READ_UNLOCK(&vec->lock);
 #endif
-
 	return VEC89_SUCCESS;
 }
 
-char VEC89_REMOVE(vec_p vec, size_t idx) {
-	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL) {
+char VEC89_SEGMENTED_GET_COPY(vec89_segmented_p vec, size_t idx, void *out_element) {
+	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_READ_LOCK(&vec->lock);
 #endif
-		return VEC89_INVALID_ARGUMENTS;
-	}
 	if (idx >= vec->count) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+		VEC89_READ_UNLOCK(&vec->lock);
 #endif
 		return VEC89_ARRAY_OUT_OF_INDEX;
 	}
 
-	if (idx == vec->count - 1) {
-		vec->count--;
+	memcpy(out_element, vec89_segmented_element(vec, idx), vec->elem_size);
+
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_READ_UNLOCK(&vec->lock);
 #endif
-		return VEC89_SUCCESS;
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SEGMENTED_SET(vec89_segmented_p vec, size_t idx, const void *element) {
+	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
+	if (idx >= vec->count) {
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+		VEC89_UNLOCK(&vec->lock);
+#endif
+		return VEC89_ARRAY_OUT_OF_INDEX;
 	}
 
-	memmove(vec->arr + vec->elem_size * idx, vec->arr + vec->elem_size * (idx + 1), vec->elem_size * (vec->count - (idx + 1)));
-	vec->count--;
+	memcpy(vec89_segmented_element(vec, idx), element, vec->elem_size);
 
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
-
 	return VEC89_SUCCESS;
 }
 
-char VEC89_INSERT(vec_p vec, size_t idx, const void *element) {
+char VEC89_SEGMENTED_INSERT(vec89_segmented_p vec, size_t idx, const void *element) {
 	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL) {
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+	VEC89_LOCK(&vec->lock);
 #endif
-		return VEC89_INVALID_ARGUMENTS;
-	}
 	if (idx > vec->count) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+		VEC89_UNLOCK(&vec->lock);
 #endif
 		return VEC89_ARRAY_OUT_OF_INDEX;
 	}
 
 	if (vec->count >= vec->capacity) {
-		size_t target_capacity = vec->capacity * 2;
-
-		void *arr_block = REALLOC_FUNCTION(vec->arr, vec->elem_size * target_capacity);
-		if (arr_block == NULL) {
+		char result = vec89_segmented_reserve(vec, vec->count + 1);
+		if (result != VEC89_SUCCESS) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-			VEC89_UNLOCK(vec->lock);
+			VEC89_UNLOCK(&vec->lock);
 #endif
-			return VEC89_MEMORY_ERROR;
+			return result;
 		}
-
-		vec->arr = arr_block;
-		vec->capacity = target_capacity;
 	}
 
+	vec89_segmented_shift_up(vec, idx);
+	memcpy(vec89_segmented_element(vec, idx), element, vec->elem_size);
+	vec->count++;
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_UNLOCK(&vec->lock);
+#endif
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SEGMENTED_REMOVE(vec89_segmented_p vec, size_t idx) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	VEC89_LOCK(&vec->lock);
+#endif
 	if (idx >= vec->count) {
-		memcpy(vec->arr + vec->elem_size * vec->count, element, vec->elem_size);
-		vec->count++;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+		VEC89_UNLOCK(&vec->lock);
 #endif
-		return VEC89_SUCCESS;
+		return VEC89_ARRAY_OUT_OF_INDEX;
 	}
-	
-	memmove(vec->arr + vec->elem_size * (idx + 1), vec->arr + vec->elem_size * idx, vec->elem_size * (vec->count - idx));
-	memcpy(vec->arr + vec->elem_size * idx, element, vec->elem_size);
 
-	vec->count++;
+	vec89_segmented_shift_down(vec, idx);
+	vec->count--;
+
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_UNLOCK(&vec->lock);
 #endif
 	return VEC89_SUCCESS;
 }
 
-char VEC89_GET(vec_p vec, size_t idx, void **out_element) {
-	if (vec == NULL || out_element == NULL) return VEC89_INVALID_ARGUMENTS;
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK(vec->lock);
-#endif
-	if (vec->arr == NULL) {
+char VEC89_SEGMENTED_SEGMENT(vec89_segmented_p vec, size_t segment, void **out_elements, size_t *out_count) {
+	size_t begin;
+	if (vec == NULL || out_elements == NULL || out_count == NULL) return VEC89_INVALID_ARGUMENTS;
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-			VEC89_UNLOCK(vec->lock);
+	VEC89_READ_LOCK(&vec->lock);
 #endif
-		return VEC89_INVALID_ARGUMENTS;
-	}
-	if (idx >= vec->count) {
+	if (segment >= vec->segment_count || (begin = VEC89_SEGMENTED_BEGIN(segment)) >= vec->count) {
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-		VEC89_UNLOCK(vec->lock);
+		VEC89_READ_UNLOCK(&vec->lock);
 #endif
 		return VEC89_ARRAY_OUT_OF_INDEX;
 	}
 
-	*out_element = vec->arr + vec->elem_size * idx;
+	*out_elements = vec->segments[segment];
+	*out_count = min(vec->count - begin, VEC89_SEGMENTED_CAPACITY(segment));
 
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_UNLOCK(vec->lock);
+	VEC89_READ_UNLOCK(&vec->lock);
 #endif
 	return VEC89_SUCCESS;
 }
\ No newline at end of file
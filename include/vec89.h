@@ -39,25 +39,299 @@
 #define VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89 
 */
 
+/*
+Define this together with VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89 to use a reader-writer lock.
+Read-only operations then take the lock shared, so readers don't serialize on each other.
+#define VEC89_READ_SCALABLE_NOTC89
+*/
+
+/*
+Define this to enable vec89_concurrent, a vector that many threads can append to without a lock.
+Requires GCC/Clang atomic builtins or MSVC interlocked functions.
+#define VEC89_CONCURRENT_APPEND_NOTC89
+*/
+
+/*
+Define this on Linux to move arrays of at least VEC89_MMAP_THRESHOLD bytes into their own anonymous mapping.
+Mapped arrays grow and shrink with mremap instead of realloc, so growing never copies the elements.
+Define VEC89_MMAP_HUGEPAGE as well to advise transparent huge pages for mapped arrays.
+#define VEC89_MMAP_NOTC89
+*/
+
+/*
+Define this on POSIX systems to enable file-backed vectors opened with VEC89_FILE_OPEN.
+The file holds a vec89_file_header followed by the raw element array and is mapped into memory, so opening is instant.
+#define VEC89_FILE_BACKED_NOTC89
+*/
+
+/*
+Define this to enable vec89_parallel.h, a thread pool with parallel for-each, transform, reduce and sort over vectors.
+Requires POSIX threads or Windows threads and the same atomics as VEC89_CONCURRENT_APPEND_NOTC89.
+#define VEC89_PARALLEL_NOTC89
+*/
+
+/*
+Define this to store the first VEC89_SMALL_BUFFER_SIZE bytes of elements inside the vector struct.
+Initialization then allocates nothing and the elements move to the heap once they outgrow the buffer.
+A vector whose elements are inline must not be copied or moved by value.
+#define VEC89_SMALL_BUFFER_NOTC89
+*/
+
+/*
+Define this to make every vec89 count its operations, reallocations, memmoves and lock waits in a vec89_stats.
+Live vectors are kept in a registry that VEC89_STATS_DUMP prints as text or JSON, and VEC89_STATS_SET_HOOK reports
+every reallocation. Without it the counters, the registry and the hooks compile to nothing.
+A vector must not be copied or moved by value while it is registered.
+#define VEC89_STATS
+*/
+
+/*
+Define this to make VEC89_CLONE and VEC89_SNAPSHOT share the array instead of copying it. The array is reference
+counted and a vector copies it on its first write, so clones that are never modified cost one small allocation.
+Requires the same atomics as VEC89_CONCURRENT_APPEND_NOTC89.
+#define VEC89_COPY_ON_WRITE_NOTC89
+*/
+
+#ifndef VEC89_MMAP_THRESHOLD
+	#define VEC89_MMAP_THRESHOLD ((size_t)1 << 28) /* Default array size in bytes from which arrays are mapped */
+#endif
+
+#ifndef VEC89_SMALL_BUFFER_SIZE
+	#define VEC89_SMALL_BUFFER_SIZE 32 /* Inline storage in bytes of every vector when VEC89_SMALL_BUFFER_NOTC89 is defined */
+#endif
+
 #define VEC89_FUNCTION_MACROS
 
+/* Storage class for the small helpers generated in headers, falls back to plain static functions in C89 */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+	#define VEC89_INLINE static inline
+#elif defined(__GNUC__) || defined(_MSC_VER)
+	#define VEC89_INLINE static __inline
+#else
+	#define VEC89_INLINE static
+#endif
+
+#if defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89) || defined(VEC89_CONCURRENT_APPEND_NOTC89) || defined(VEC89_PARALLEL_NOTC89) || defined(VEC89_COPY_ON_WRITE_NOTC89)
+	#define VEC89_SPIN_LIMIT 64 /* Busy-wait iterations before a spinning thread yields */
+
+	#ifdef _MSC_VER
+		#include <windows.h>
+		#ifdef _WIN64
+			#define VEC89_ATOMIC_FETCH_ADD(size_p, value) ((size_t)InterlockedExchangeAdd64((volatile LONG64 *)(size_p), (LONG64)(value)))
+			#define VEC89_ATOMIC_FETCH_SUB(size_p, value) ((size_t)InterlockedExchangeAdd64((volatile LONG64 *)(size_p), -(LONG64)(value)))
+			#define VEC89_ATOMIC_EXCHANGE(size_p, value) ((size_t)InterlockedExchange64((volatile LONG64 *)(size_p), (LONG64)(value)))
+		#else
+			#define VEC89_ATOMIC_FETCH_ADD(size_p, value) ((size_t)InterlockedExchangeAdd((volatile LONG *)(size_p), (LONG)(value)))
+			#define VEC89_ATOMIC_FETCH_SUB(size_p, value) ((size_t)InterlockedExchangeAdd((volatile LONG *)(size_p), -(LONG)(value)))
+			#define VEC89_ATOMIC_EXCHANGE(size_p, value) ((size_t)InterlockedExchange((volatile LONG *)(size_p), (LONG)(value)))
+		#endif
+		#define VEC89_ATOMIC_LOAD(size_p) (MemoryBarrier(), *(volatile size_t *)(size_p))
+		#define VEC89_ATOMIC_STORE(size_p, value) do { MemoryBarrier(); *(volatile size_t *)(size_p) = (value); } while (0)
+		#define VEC89_ATOMIC_LOAD_PTR(ptr_p) (MemoryBarrier(), *(void * volatile *)(ptr_p))
+		#define VEC89_ATOMIC_STORE_PTR(ptr_p, value) do { MemoryBarrier(); *(void * volatile *)(ptr_p) = (value); } while (0)
+		#define VEC89_ATOMIC_CAS_PTR(ptr_p, expected, desired) (InterlockedCompareExchangePointer((PVOID volatile *)(ptr_p), desired, expected) == (expected))
+		#define VEC89_CPU_RELAX() YieldProcessor()
+		#define VEC89_THREAD_YIELD() SwitchToThread()
+	#else
+		#define VEC89_ATOMIC_FETCH_ADD(size_p, value) __atomic_fetch_add(size_p, value, __ATOMIC_RELAXED)
+		#define VEC89_ATOMIC_FETCH_SUB(size_p, value) __atomic_fetch_sub(size_p, value, __ATOMIC_ACQ_REL) /* Orders reference count drops */
+		#define VEC89_ATOMIC_EXCHANGE(size_p, value) __atomic_exchange_n(size_p, value, __ATOMIC_ACQUIRE)
+		#define VEC89_ATOMIC_LOAD(size_p) __atomic_load_n(size_p, __ATOMIC_ACQUIRE)
+		#define VEC89_ATOMIC_STORE(size_p, value) __atomic_store_n(size_p, value, __ATOMIC_RELEASE)
+		#define VEC89_ATOMIC_LOAD_PTR(ptr_p) __atomic_load_n(ptr_p, __ATOMIC_ACQUIRE)
+		#define VEC89_ATOMIC_STORE_PTR(ptr_p, value) __atomic_store_n(ptr_p, value, __ATOMIC_RELEASE)
+		#define VEC89_ATOMIC_CAS_PTR(ptr_p, expected, desired) vec89_atomic_cas_ptr((void **)(ptr_p), expected, desired)
+		#if defined(__i386__) || defined(__x86_64__)
+			#define VEC89_CPU_RELAX() __builtin_ia32_pause()
+		#else
+			#define VEC89_CPU_RELAX() ((void)0)
+		#endif
+		#include <sched.h>
+		#define VEC89_THREAD_YIELD() sched_yield()
+		VEC89_INLINE int vec89_atomic_cas_ptr(void **ptr_p, void *expected, void *desired) {
+			return __atomic_compare_exchange_n(ptr_p, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+		}
+	#endif
+#endif
+
+#define VEC89_LOCK_POLICY_NONE 0	 /* No locking, for vectors only used by one thread at a time */
+#define VEC89_LOCK_POLICY_SPIN 1	 /* Spinlock with exponential backoff, for very short critical sections */
+#define VEC89_LOCK_POLICY_ADAPTIVE 2 /* Spins on the mutex for a while before blocking */
+#define VEC89_LOCK_POLICY_MUTEX 3	 /* Blocking platform mutex */
+
+#ifndef VEC89_LOCK_POLICY_DEFAULT
+	#define VEC89_LOCK_POLICY_DEFAULT VEC89_LOCK_POLICY_MUTEX /* Policy of newly initialized vectors */
+#endif
+#define VEC89_LOCK_ADAPTIVE_TRIES 100 /* Try-locks of the adaptive policy before blocking */
+
 /* Define this in order to implement thread safety but not C89 */
-#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89 
+#if defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89) && defined(VEC89_READ_SCALABLE_NOTC89)
+	#ifdef _WIN32
+		#include <windows.h>
+		#define VEC89_MUTEX_TYPE SRWLOCK
+		#define VEC89_MUTEX_INIT(mutex_p) InitializeSRWLock(mutex_p)
+		#define VEC89_MUTEX_LOCK(mutex_p) AcquireSRWLockExclusive(mutex_p)
+		#define VEC89_MUTEX_TRY_LOCK(mutex_p) (TryAcquireSRWLockExclusive(mutex_p) != 0)
+		#define VEC89_MUTEX_UNLOCK(mutex_p) ReleaseSRWLockExclusive(mutex_p)
+		#define VEC89_MUTEX_READ_LOCK(mutex_p) AcquireSRWLockShared(mutex_p)
+		#define VEC89_MUTEX_TRY_READ_LOCK(mutex_p) (TryAcquireSRWLockShared(mutex_p) != 0)
+		#define VEC89_MUTEX_READ_UNLOCK(mutex_p) ReleaseSRWLockShared(mutex_p)
+		#define VEC89_MUTEX_DESTROY(mutex_p) ((void)(mutex_p))
+	#else
+		#include <pthread.h>
+		#define VEC89_MUTEX_TYPE pthread_rwlock_t
+		#define VEC89_MUTEX_INIT(mutex_p) pthread_rwlock_init(mutex_p, NULL)
+		#define VEC89_MUTEX_LOCK(mutex_p) pthread_rwlock_wrlock(mutex_p)
+		#define VEC89_MUTEX_TRY_LOCK(mutex_p) (pthread_rwlock_trywrlock(mutex_p) == 0)
+		#define VEC89_MUTEX_UNLOCK(mutex_p) pthread_rwlock_unlock(mutex_p)
+		#define VEC89_MUTEX_READ_LOCK(mutex_p) pthread_rwlock_rdlock(mutex_p)
+		#define VEC89_MUTEX_TRY_READ_LOCK(mutex_p) (pthread_rwlock_tryrdlock(mutex_p) == 0)
+		#define VEC89_MUTEX_READ_UNLOCK(mutex_p) pthread_rwlock_unlock(mutex_p)
+		#define VEC89_MUTEX_DESTROY(mutex_p) pthread_rwlock_destroy(mutex_p)
+	#endif
+#elif defined(VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89)
 	#ifdef _WIN32
 		#include <windows.h>
-		#define VEC89_LOCK_TYPE CRITICAL_SECTION
-		#define VEC89_LOCK_INIT(lock_p) InitializeCriticalSection(lock_p)
-		#define VEC89_LOCK(lock_p) EnterCriticalSection(lock_p)
-		#define VEC89_UNLOCK(lock_p) LeaveCriticalSection(lock_p)
-		#define VEC89_LOCK_DESTROY(lock_p) DeleteCriticalSection(lock_p)
+		#define VEC89_MUTEX_TYPE CRITICAL_SECTION
+		#define VEC89_MUTEX_INIT(mutex_p) InitializeCriticalSection(mutex_p)
+		#define VEC89_MUTEX_LOCK(mutex_p) EnterCriticalSection(mutex_p)
+		#define VEC89_MUTEX_TRY_LOCK(mutex_p) (TryEnterCriticalSection(mutex_p) != 0)
+		#define VEC89_MUTEX_UNLOCK(mutex_p) LeaveCriticalSection(mutex_p)
+		#define VEC89_MUTEX_DESTROY(mutex_p) DeleteCriticalSection(mutex_p)
 	#else
 		#include <pthread.h>
-		#define VEC89_LOCK_TYPE pthread_mutex_t
-		#define VEC89_LOCK_INIT(lock_p) pthread_mutex_init(lock_p, NULL)
-		#define VEC89_LOCK(lock_p) pthread_mutex_lock(lock_p)
-		#define VEC89_UNLOCK(lock_p) pthread_mutex_unlock(lock_p)
-		#define VEC89_LOCK_DESTROY(lock_p) pthread_mutex_destroy(lock_p)
+		#define VEC89_MUTEX_TYPE pthread_mutex_t
+		#define VEC89_MUTEX_INIT(mutex_p) pthread_mutex_init(mutex_p, NULL)
+		#define VEC89_MUTEX_LOCK(mutex_p) pthread_mutex_lock(mutex_p)
+		#define VEC89_MUTEX_TRY_LOCK(mutex_p) (pthread_mutex_trylock(mutex_p) == 0)
+		#define VEC89_MUTEX_UNLOCK(mutex_p) pthread_mutex_unlock(mutex_p)
+		#define VEC89_MUTEX_DESTROY(mutex_p) pthread_mutex_destroy(mutex_p)
 	#endif
+	#define VEC89_MUTEX_READ_LOCK(mutex_p) VEC89_MUTEX_LOCK(mutex_p)
+	#define VEC89_MUTEX_TRY_READ_LOCK(mutex_p) VEC89_MUTEX_TRY_LOCK(mutex_p)
+	#define VEC89_MUTEX_READ_UNLOCK(mutex_p) VEC89_MUTEX_UNLOCK(mutex_p)
+#endif
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+/*
+Lock stored inline in every vector. The policy picks the primitive, the owner and depth let a thread that opened
+a lock scope call VEC89_* functions on the vector without locking it again.
+*/
+typedef struct VEC89_LOCK_STATE {
+	VEC89_MUTEX_TYPE mutex; /* Used by the adaptive and mutex policies */
+	size_t spin;			/* Used by the spin policy, non-zero while held */
+	void *owner;			/* Thread inside a lock scope, NULL otherwise */
+	size_t depth;			/* Nesting depth of the owner's lock scopes and calls */
+	char policy;			/* VEC89_LOCK_POLICY_* */
+#ifdef VEC89_STATS
+	size_t acquisitions;	/* Acquisitions outside lock scopes */
+	size_t contentions;		/* Acquisitions that found the lock taken */
+	size_t wait_ns;			/* Nanoseconds contended acquisitions waited */
+#endif
+} vec89_lock;
+
+#define VEC89_LOCK(lock_p) VEC89_LOCK_ACQUIRE(lock_p, 0)
+#define VEC89_UNLOCK(lock_p) VEC89_LOCK_RELEASE(lock_p, 0)
+#define VEC89_READ_LOCK(lock_p) VEC89_LOCK_ACQUIRE(lock_p, 1)
+#define VEC89_READ_UNLOCK(lock_p) VEC89_LOCK_RELEASE(lock_p, 1)
+
+/*
+Acquires a vector lock according to its policy. Shared acquisitions only differ with VEC89_READ_SCALABLE_NOTC89.
+Used through VEC89_LOCK/VEC89_READ_LOCK.
+*/
+void VEC89_LOCK_ACQUIRE(vec89_lock *lock, char shared);
+
+/*
+Releases a vector lock acquired with VEC89_LOCK_ACQUIRE, shared must match.
+Used through VEC89_UNLOCK/VEC89_READ_UNLOCK.
+*/
+void VEC89_LOCK_RELEASE(vec89_lock *lock, char shared);
+#endif
+
+/*
+Runtime allocator that can be attached to a vector at initialization.
+Every function receives the context pointer. Sizes are in bytes, old_size and size are the sizes the block was allocated with.
+*/
+typedef struct VEC89_ALLOCATOR {
+	void *(*alloc_function)(void *context, size_t size);
+	void *(*realloc_function)(void *context, void *block, size_t old_size, size_t new_size);
+	void (*free_function)(void *context, void *block, size_t size);
+	void *context;
+} vec89_allocator, *vec89_allocator_p;
+
+/*
+Growth policy that can be attached to a vector. Vectors without a policy double their capacity and never shrink on their own.
+Below linear_threshold the capacity is multiplied by factor_percent / 100, above it linear_step bytes are added per growth.
+Every growth adds at least min_step elements.
+With shrink_threshold_percent set, removals shrink the array once count drops below that percentage of the capacity.
+The new capacity puts the occupancy at shrink_target_percent, which must be higher than the threshold so the vector
+doesn't shrink and grow back on every push and pop.
+*/
+typedef struct VEC89_GROWTH_POLICY {
+	size_t factor_percent;			 /* Geometric growth factor in percent, e.g. 150 or 200. Values <= 100 mean 200 */
+	size_t linear_threshold;		 /* Capacity in bytes above which growth is linear, 0 to always grow geometrically */
+	size_t linear_step;				 /* Bytes added per growth above linear_threshold */
+	size_t min_step;				 /* Minimum number of elements added per growth */
+	size_t shrink_threshold_percent; /* Occupancy in percent below which removals shrink the array, 0 to disable */
+	size_t shrink_target_percent;	 /* Occupancy in percent after an automatic shrink (threshold < target <= 100) */
+	size_t shrink_min_capacity;		 /* Capacity automatic shrinking never goes below */
+} vec89_growth_policy, *vec89_growth_policy_p;
+
+#ifdef VEC89_FILE_BACKED_NOTC89
+#include <stdint.h>
+
+#define VEC89_FILE_MAGIC "VEC89\0\0\0" /* First 8 bytes of a vector file */
+#define VEC89_FILE_VERSION 1
+#define VEC89_FILE_HEADER_SIZE 64 /* Bytes before the first element, keeps the array cache line aligned */
+
+#define VEC89_FILE_READ_ONLY 0	/* Open an existing file, changes stay private to the process and can't grow the vector */
+#define VEC89_FILE_READ_WRITE 1 /* Open an existing file, changes and growth go to the file */
+#define VEC89_FILE_CREATE 2		/* Create or truncate a file, then like VEC89_FILE_READ_WRITE */
+
+/*
+Header of a vector file. Fields are stored in the byte order of the machine that wrote the file.
+*/
+typedef struct VEC89_FILE_HEADER {
+	char magic[8];		   /* VEC89_FILE_MAGIC */
+	uint32_t version;	   /* VEC89_FILE_VERSION */
+	uint32_t header_size;  /* VEC89_FILE_HEADER_SIZE */
+	uint64_t elem_size;	   /* Element size */
+	uint64_t count;		   /* Element count */
+	uint64_t capacity;	   /* Element capacity of the array following the header */
+	char reserved[24];	   /* Zero */
+} vec89_file_header;
+#endif
+
+#ifdef VEC89_SMALL_BUFFER_NOTC89
+/* Inline element storage, aligned for doubles and pointers */
+typedef union VEC89_SMALL_BUFFER {
+	char bytes[VEC89_SMALL_BUFFER_SIZE];
+	double align_double;
+	void *align_pointer;
+	long align_long;
+} vec89_small_buffer;
+#endif
+
+#ifdef VEC89_STATS
+#define VEC89_STATS_TEXT 0 /* One line per vector */
+#define VEC89_STATS_JSON 1 /* An array with one object per vector */
+
+/*
+Counters of a vector, read with VEC89_STATS_GET. Byte counts are element bytes.
+*/
+typedef struct VEC89_STATS_COUNTERS {
+	size_t pushes;			  /* Elements added by VEC89_PUSH, VEC89_PUSH_N and VEC89_APPEND_VEC */
+	size_t pops;			  /* Elements taken by VEC89_POP, VEC89_POP_INTO and VEC89_POP_N */
+	size_t inserts;			  /* Elements added by VEC89_INSERT and VEC89_INSERT_RANGE */
+	size_t removes;			  /* Elements dropped by VEC89_REMOVE, VEC89_REMOVE_RANGE, VEC89_SWAP_REMOVE, VEC89_REMOVE_IF, VEC89_RETAIN and VEC89_DEDUP */
+	size_t reallocs;		  /* Array reallocations, growing or shrinking */
+	size_t realloc_bytes;	  /* Bytes copied by reallocations that moved the array */
+	size_t memmove_bytes;	  /* Bytes shifted by insertions and removals */
+	size_t peak_capacity;	  /* Largest element capacity the vector had */
+	size_t lock_acquisitions; /* Lock acquisitions, 0 without VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89 */
+	size_t lock_contentions;  /* Acquisitions that had to wait for another thread */
+	size_t lock_wait_ns;	  /* Nanoseconds spent waiting for the lock */
+} vec89_stats;
 #endif
 
 typedef struct VEC89 {
@@ -65,16 +339,218 @@ typedef struct VEC89 {
 	size_t capacity;  /* Element capacity */
 	size_t elem_size; /* Element size */
 	size_t count;	  /* Element count */
+	const vec89_allocator *allocator; /* Allocator, NULL for the default malloc/realloc/free */
+	const vec89_growth_policy *growth; /* Growth policy, NULL for doubling */
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	size_t *shared;	  /* Reference count of an array shared with clones or snapshots, NULL while the array is owned */
+#endif
+#ifdef VEC89_MMAP_NOTC89
+	size_t mmap_threshold; /* Array size in bytes from which the array is mapped, 0 to never map */
+	char mapped;		   /* Non-zero if the array is a mapping */
+#endif
+#ifdef VEC89_FILE_BACKED_NOTC89
+	int file;		  /* Descriptor of the backing file, -1 for vectors in memory */
+	char file_mode;	  /* VEC89_FILE_* mode the file was opened with */
+#endif
+#ifdef VEC89_SMALL_BUFFER_NOTC89
+	vec89_small_buffer small; /* Holds the elements while arr points to it */
+#endif
 #ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
-	VEC89_LOCK_TYPE *lock;
+	vec89_lock lock;  /* Lock */
+#endif
+#ifdef VEC89_STATS
+	vec89_stats stats;		  /* Counters, the lock_* fields are kept in the lock */
+	const char *stats_name;	  /* Name shown by VEC89_STATS_DUMP, NULL if unnamed */
+	struct VEC89 *stats_prev; /* Registry links */
+	struct VEC89 *stats_next;
 #endif
 } vec, *vec_p, vec89; 
 
+#ifdef VEC89_STATS
+/* Called after a vector's array was reallocated, while the vector is locked */
+typedef void (*vec89_stats_hook)(vec_p vec, size_t old_capacity, size_t new_capacity, void *context);
+#endif
+
+/*
+Frozen copy of a vector's elements made by VEC89_SNAPSHOT. It never changes, so any number of threads can read
+the count elements at arr without locking. With VEC89_COPY_ON_WRITE_NOTC89 it shares the vector's array
+until the vector is next written.
+*/
+typedef struct VEC89_SNAPSHOT {
+	const char *arr;  /* Elements, NULL for an empty snapshot */
+	size_t count;	  /* Element count */
+	size_t elem_size; /* Element size */
+	size_t capacity;  /* Element capacity of the array, needed to free it */
+	const vec89_allocator *allocator; /* Allocator of the array */
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	size_t *shared;	  /* Reference count of an array shared with vectors, NULL if the snapshot owns a copy */
+#endif
+} vec89_snapshot;
+
+#define VEC89_VIEW_END_OF_VECTOR ((size_t)-1) /* End argument of VEC89_VIEW meaning the vector's count */
+
+/*
+Range of a vector's elements returned by VEC89_VIEW. Element i is at data + i * stride.
+The vector stays locked until VEC89_VIEW_RELEASE.
+*/
+typedef struct VEC89_VIEW_RANGE {
+	char *data;	   /* First element of the range */
+	size_t stride; /* Bytes between consecutive elements, the element size */
+	size_t count;  /* Number of elements in the range */
+	vec_p vec;	   /* Viewed vector */
+	char writable; /* Non-zero if the vector is locked for writing */
+} vec89_view;
+
+/*
+Unchecked accessors. They don't lock and don't check the index, use them on vectors no other thread writes
+or inside a view or lock scope. With a constant element type they compile to plain pointer arithmetic.
+Writing through them bypasses copy-on-write, call VEC89_DETACH first on vectors that may share their array.
+*/
+#define VEC89_DATA(vec, T) ((T *)(vec)->arr)						 /* First element as a T pointer */
+#define VEC89_AT(vec, T, idx) (((T *)(vec)->arr)[idx])				 /* Element at idx as a T lvalue */
+#define VEC89_VIEW_DATA(view, T) ((T *)(view)->data)				 /* First element of the view as a T pointer */
+#define VEC89_VIEW_AT(view, T, idx) (((T *)(view)->data)[idx])		 /* Element idx of the view as a T lvalue */
+#define VEC89_SNAPSHOT_AT(snapshot, T, idx) (((const T *)(snapshot)->arr)[idx]) /* Element idx of a snapshot, never needs a lock */
+
+/* Pointer to the element at idx using the runtime element size */
+VEC89_INLINE void *vec89_at(const vec89 *vec, size_t idx) {
+	return vec->arr + vec->elem_size * idx;
+}
+
+/* Pointer to element idx of a view */
+VEC89_INLINE void *vec89_view_at(const vec89_view *view, size_t idx) {
+	return view->data + view->stride * idx;
+}
+
+/* Returns non-zero if element matches, used by VEC89_REMOVE_IF and VEC89_RETAIN */
+typedef char (*vec89_predicate_function)(const void *element, void *context);
+
+/* Returns non-zero if a and b are equal, used by VEC89_DEDUP */
+typedef char (*vec89_equal_function)(const void *a, const void *b, void *context);
+
+#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+#define VEC89_CONCURRENT_FIRST_SEGMENT 16 /* Element capacity of the first segment, must be a power of two */
+#define VEC89_CONCURRENT_SEGMENT_COUNT (sizeof(size_t) * 8 - 4) /* Segment k holds VEC89_CONCURRENT_FIRST_SEGMENT << k elements */
+
+/*
+Append-only vector for many writer threads. Writers reserve an index with an atomic fetch-add and storage grows
+segment by segment, so existing elements never move and no lock is taken.
+Elements become visible to readers in index order: count only covers indices whose writers have finished.
+*/
+typedef struct VEC89_CONCURRENT {
+	char *segments[VEC89_CONCURRENT_SEGMENT_COUNT]; /* Segments, allocated on first use */
+	size_t elem_size;								/* Element size */
+	size_t reserved;								/* Next index to hand out */
+	size_t count;									/* Published element count */
+	size_t failed;									/* Non-zero once a segment allocation failed */
+	const vec89_allocator *allocator;				/* Allocator, must be thread safe. NULL for the default malloc/realloc/free */
+} vec89_concurrent, *vec89_concurrent_p;
+#endif
+
+#define VEC89_SEGMENTED_FIRST_SEGMENT 16 /* Element capacity of the first segment, must be a power of two */
+#define VEC89_SEGMENTED_SEGMENT_COUNT (sizeof(size_t) * 8 - 4) /* Segment k holds VEC89_SEGMENTED_FIRST_SEGMENT << k elements */
+
+/*
+Vector stored in segments that double in size. Index idx lives in segment floor(log2(idx / 16 + 1)), so indexing is
+a bit scan and a few shifts. Growing allocates the next segment and never copies elements, so a pointer to an element
+stays valid until the element is removed or the segments are freed.
+*/
+typedef struct VEC89_SEGMENTED {
+	char *segments[VEC89_SEGMENTED_SEGMENT_COUNT]; /* Segments, the first segment_count are allocated */
+	size_t segment_count;						   /* Allocated segments */
+	size_t capacity;							   /* Element capacity of the allocated segments */
+	size_t elem_size;							   /* Element size */
+	size_t count;								   /* Element count */
+	const vec89_allocator *allocator;			   /* Allocator, NULL for the default malloc/realloc/free */
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock lock;							   /* Lock */
+#endif
+} vec89_segmented, *vec89_segmented_p;
+
+#define VEC89_DEQUE_MIN_CAPACITY 16 /* Element capacity of the first allocation of a deque, must be a power of two */
+
+/*
+Double-ended queue in a ring buffer. Elements start at head and wrap around the end of the array,
+so pushing and popping at either end never moves other elements. The capacity is 0 or a power of two.
+*/
+typedef struct VEC89_DEQUE {
+	char *arr;		  /* Ring buffer, NULL until the first allocation */
+	size_t capacity;  /* Element capacity */
+	size_t elem_size; /* Element size */
+	size_t head;	  /* Array index of the first element */
+	size_t count;	  /* Element count */
+	const vec89_allocator *allocator; /* Allocator, NULL for the default malloc/realloc/free */
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock lock;  /* Lock */
+#endif
+} vec89_deque, *vec89_deque_p;
+
+/*
+Field of a columnar vector's schema. Rows are exchanged in the caller's row layout, usually a struct,
+so a field is described by its offset and size in that struct.
+*/
+typedef struct VEC89_SOA_FIELD {
+	size_t offset; /* Offset of the field in a row, e.g. offsetof(struct record, key) */
+	size_t size;   /* Size of the field, the element size of its column */
+} vec89_soa_field;
+
+/*
+Columnar (struct of arrays) vector. Every field of the schema is stored in its own vec89, and all columns hold count
+elements, so a scan over one field reads only that field's bytes. Insertions and removals shift every column together.
+The column vectors are locked through the columnar vector, never use them directly.
+*/
+typedef struct VEC89_SOA {
+	vec89 *columns;			/* One vector per field */
+	vec89_soa_field *fields;	/* Copy of the schema */
+	size_t field_count;		/* Number of fields and columns */
+	size_t row_size;		/* Size of a row in the caller's layout */
+	size_t count;			/* Row count */
+	const vec89_allocator *allocator; /* Allocator of the columns, NULL for the default malloc/realloc/free */
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock lock;		/* Lock */
+#endif
+} vec89_soa, *vec89_soa_p;
+
+#define VEC89_BITS_PER_WORD (sizeof(size_t) * 8) /* Bits stored in one word of a bit vector */
+#define VEC89_BITS_MIN_CAPACITY 4 /* Word capacity of the first allocation of a bit vector */
+
+/*
+Packed bit vector. Bit idx is bit idx % VEC89_BITS_PER_WORD of words[idx / VEC89_BITS_PER_WORD], and the bits of the last
+word past count are always zero, so the words can be read directly and whole-word operations need no masking.
+*/
+typedef struct VEC89_BITS {
+	size_t *words;	 /* Bits, NULL until the first allocation */
+	size_t capacity; /* Word capacity */
+	size_t count;	 /* Bit count */
+	const vec89_allocator *allocator; /* Allocator, NULL for the default malloc/realloc/free */
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	vec89_lock lock; /* Lock */
+#endif
+} vec89_bits, *vec89_bits_p;
+
 #ifdef VEC89_FUNCTION_MACROS
 	#define vec_init(vec_obj, element_size) VEC89_INITIALIZATION(&vec_obj, element_size)
+	#define vec_init_allocator(vec_obj, element_size, allocator_ptr) VEC89_INITIALIZATION_ALLOCATOR(&vec_obj, element_size, allocator_ptr)
+	#define vec_init_capacity(vec_obj, element_size, capacity) VEC89_INITIALIZATION_CAPACITY(&vec_obj, element_size, capacity)
+	#ifdef VEC89_FILE_BACKED_NOTC89
+		#define vec_file_open(vec_obj, path, element_size, mode) VEC89_FILE_OPEN(&vec_obj, path, element_size, mode)
+		#define vec_file_sync(vec_obj) VEC89_FILE_SYNC(&vec_obj)
+	#endif
 	#define vec_array_free(vec_obj) VEC89_ARRAY_FREE(&vec_obj)
 	#define vec_free(vec_obj) VEC89_FREE(&vec_obj)
 	#define vec_clear(vec_obj) VEC89_CLEAR(&vec_obj)
+	#define vec_set_lock_policy(vec_obj, policy) VEC89_SET_LOCK_POLICY(&vec_obj, policy)
+	#define vec_set_growth_policy(vec_obj, policy_ptr) VEC89_SET_GROWTH_POLICY(&vec_obj, policy_ptr)
+	#define vec_set_mmap_threshold(vec_obj, threshold) VEC89_SET_MMAP_THRESHOLD(&vec_obj, threshold)
+	#define vec_lock_scope_begin(vec_obj) VEC89_LOCK_SCOPE_BEGIN(&vec_obj)
+	#define vec_lock_scope_end(vec_obj) VEC89_LOCK_SCOPE_END(&vec_obj)
+	#ifdef VEC89_STATS
+		#define vec_stats_get(vec_obj, out_stats_ptr) VEC89_STATS_GET(&vec_obj, out_stats_ptr)
+		#define vec_stats_reset(vec_obj) VEC89_STATS_RESET(&vec_obj)
+		#define vec_stats_set_name(vec_obj, name) VEC89_STATS_SET_NAME(&vec_obj, name)
+		#define vec_stats_dump(stream, format) VEC89_STATS_DUMP(stream, format)
+		#define vec_stats_set_hook(hook, context) VEC89_STATS_SET_HOOK(hook, context)
+	#endif
 
 	#define vec_reserve(vec_obj, new_capacity) VEC89_RESERVE(&vec_obj, new_capacity)
 	#define vec_expand(vec_obj, amount) VEC89_EXPAND(&vec_obj, amount)
@@ -83,15 +559,111 @@ typedef struct VEC89 {
 
 	#define vec_push(vec_obj, element_ptr) VEC89_PUSH(&vec_obj, element_ptr)
 	#define vec_pop(vec_obj, out_ptr_ptr) VEC89_POP(&vec_obj, out_ptr_ptr)
+	#define vec_pop_into(vec_obj, out_ptr) VEC89_POP_INTO(&vec_obj, out_ptr)
+	#define vec_pop_n(vec_obj, out_ptr, n) VEC89_POP_N(&vec_obj, out_ptr, n)
+	#define vec_peek(vec_obj, out_ptr_ptr) VEC89_PEEK(&vec_obj, out_ptr_ptr)
 
 	#define vec_get(vec_obj, idx, out_ptr_ptr) VEC89_GET(&vec_obj, idx, out_ptr_ptr)
+	#define vec_get_copy(vec_obj, idx, out_ptr) VEC89_GET_COPY(&vec_obj, idx, out_ptr)
+	#define vec_read_begin(vec_obj, out_arr_ptr, out_count_ptr) VEC89_READ_BEGIN(&vec_obj, out_arr_ptr, out_count_ptr)
+	#define vec_read_end(vec_obj) VEC89_READ_END(&vec_obj)
+	#define vec_view(vec_obj, begin, end, writable, out_view_ptr) VEC89_VIEW(&vec_obj, begin, end, writable, out_view_ptr)
+	#define vec_view_release(view_obj) VEC89_VIEW_RELEASE(&view_obj)
+	#define vec_get_n(vec_obj, idx, out_ptr, n) VEC89_GET_N(&vec_obj, idx, out_ptr, n)
+	#define vec_set_n(vec_obj, idx, elements_ptr, n) VEC89_SET_N(&vec_obj, idx, elements_ptr, n)
+	#define vec_clone(vec_obj, clone_obj) VEC89_CLONE(&vec_obj, &clone_obj)
+	#define vec_detach(vec_obj) VEC89_DETACH(&vec_obj)
+	#define vec_snapshot(vec_obj, snapshot_obj) VEC89_SNAPSHOT(&vec_obj, &snapshot_obj)
+	#define vec_snapshot_release(snapshot_obj) VEC89_SNAPSHOT_RELEASE(&snapshot_obj)
 	#define vec_set(vec_obj, idx, element_ptr) VEC89_SET(&vec_obj, idx, element_ptr)
 	#define vec_insert(vec_obj, idx, element_ptr) VEC89_INSERT(&vec_obj, idx, element_ptr)
 	#define vec_remove(vec_obj, idx) VEC89_REMOVE(&vec_obj, idx)
+
+	#define vec_push_n(vec_obj, elements_ptr, n) VEC89_PUSH_N(&vec_obj, elements_ptr, n)
+	#define vec_insert_range(vec_obj, idx, elements_ptr, n) VEC89_INSERT_RANGE(&vec_obj, idx, elements_ptr, n)
+	#define vec_remove_range(vec_obj, idx, n) VEC89_REMOVE_RANGE(&vec_obj, idx, n)
+	#define vec_append_vec(vec_obj, other_obj) VEC89_APPEND_VEC(&vec_obj, &other_obj)
+	#define vec_swap_remove(vec_obj, idx) VEC89_SWAP_REMOVE(&vec_obj, idx)
+	#define vec_remove_if(vec_obj, predicate, context, out_removed_ptr) VEC89_REMOVE_IF(&vec_obj, predicate, context, out_removed_ptr)
+	#define vec_retain(vec_obj, predicate, context, out_removed_ptr) VEC89_RETAIN(&vec_obj, predicate, context, out_removed_ptr)
+	#define vec_dedup(vec_obj, equal, context, out_removed_ptr) VEC89_DEDUP(&vec_obj, equal, context, out_removed_ptr)
+
+	#define vec_deque_init(deque_obj, element_size, allocator_ptr) VEC89_DEQUE_INITIALIZATION(&deque_obj, element_size, allocator_ptr)
+	#define vec_deque_free(deque_obj) VEC89_DEQUE_ARRAY_FREE(&deque_obj)
+	#define vec_deque_reserve(deque_obj, new_capacity) VEC89_DEQUE_RESERVE(&deque_obj, new_capacity)
+	#define vec_deque_clear(deque_obj) VEC89_DEQUE_CLEAR(&deque_obj)
+	#define vec_deque_push_back(deque_obj, element_ptr) VEC89_DEQUE_PUSH_BACK(&deque_obj, element_ptr)
+	#define vec_deque_push_front(deque_obj, element_ptr) VEC89_DEQUE_PUSH_FRONT(&deque_obj, element_ptr)
+	#define vec_deque_pop_back(deque_obj, out_element_ptr) VEC89_DEQUE_POP_BACK(&deque_obj, out_element_ptr)
+	#define vec_deque_pop_front(deque_obj, out_element_ptr) VEC89_DEQUE_POP_FRONT(&deque_obj, out_element_ptr)
+	#define vec_deque_get(deque_obj, idx, out_ptr_ptr) VEC89_DEQUE_GET(&deque_obj, idx, out_ptr_ptr)
+	#define vec_deque_set(deque_obj, idx, element_ptr) VEC89_DEQUE_SET(&deque_obj, idx, element_ptr)
+	#define vec_deque_insert(deque_obj, idx, element_ptr) VEC89_DEQUE_INSERT(&deque_obj, idx, element_ptr)
+	#define vec_deque_remove(deque_obj, idx) VEC89_DEQUE_REMOVE(&deque_obj, idx)
+	#define vec_deque_linearize(deque_obj, out_arr_ptr) VEC89_DEQUE_LINEARIZE(&deque_obj, out_arr_ptr)
+	#define vec_soa_init(soa_obj, fields_ptr, field_count, row_size, allocator_ptr) VEC89_SOA_INITIALIZATION(&soa_obj, fields_ptr, field_count, row_size, allocator_ptr)
+	#define vec_soa_free(soa_obj) VEC89_SOA_ARRAY_FREE(&soa_obj)
+	#define vec_soa_clear(soa_obj) VEC89_SOA_CLEAR(&soa_obj)
+	#define vec_soa_reserve(soa_obj, new_capacity) VEC89_SOA_RESERVE(&soa_obj, new_capacity)
+	#define vec_soa_push(soa_obj, row_ptr) VEC89_SOA_PUSH(&soa_obj, row_ptr)
+	#define vec_soa_push_n(soa_obj, rows_ptr, n) VEC89_SOA_PUSH_N(&soa_obj, rows_ptr, n)
+	#define vec_soa_pop_into(soa_obj, out_row_ptr) VEC89_SOA_POP_INTO(&soa_obj, out_row_ptr)
+	#define vec_soa_get(soa_obj, idx, out_row_ptr) VEC89_SOA_GET(&soa_obj, idx, out_row_ptr)
+	#define vec_soa_set(soa_obj, idx, row_ptr) VEC89_SOA_SET(&soa_obj, idx, row_ptr)
+	#define vec_soa_get_field(soa_obj, idx, field, out_value_ptr) VEC89_SOA_GET_FIELD(&soa_obj, idx, field, out_value_ptr)
+	#define vec_soa_set_field(soa_obj, idx, field, value_ptr) VEC89_SOA_SET_FIELD(&soa_obj, idx, field, value_ptr)
+	#define vec_soa_insert(soa_obj, idx, row_ptr) VEC89_SOA_INSERT(&soa_obj, idx, row_ptr)
+	#define vec_soa_remove(soa_obj, idx) VEC89_SOA_REMOVE(&soa_obj, idx)
+	#define vec_soa_gather(soa_obj, idx, out_rows_ptr, n) VEC89_SOA_GATHER(&soa_obj, idx, out_rows_ptr, n)
+	#define vec_soa_scatter(soa_obj, idx, rows_ptr, n) VEC89_SOA_SCATTER(&soa_obj, idx, rows_ptr, n)
+	#define vec_soa_view(soa_obj, begin, end, writable, out_views) VEC89_SOA_VIEW(&soa_obj, begin, end, writable, out_views)
+	#define vec_soa_view_release(soa_obj, views) VEC89_SOA_VIEW_RELEASE(&soa_obj, views)
+
+	#define vec_bits_init(bits_obj, allocator_ptr) VEC89_BITS_INITIALIZATION(&bits_obj, allocator_ptr)
+	#define vec_bits_array_free(bits_obj) VEC89_BITS_ARRAY_FREE(&bits_obj)
+	#define vec_bits_reserve(bits_obj, new_capacity) VEC89_BITS_RESERVE(&bits_obj, new_capacity)
+	#define vec_bits_resize(bits_obj, count, value) VEC89_BITS_RESIZE(&bits_obj, count, value)
+	#define vec_bits_push(bits_obj, value) VEC89_BITS_PUSH(&bits_obj, value)
+	#define vec_bits_pop(bits_obj, out_value_ptr) VEC89_BITS_POP(&bits_obj, out_value_ptr)
+	#define vec_bits_get(bits_obj, idx, out_value_ptr) VEC89_BITS_GET(&bits_obj, idx, out_value_ptr)
+	#define vec_bits_set(bits_obj, idx, value) VEC89_BITS_SET(&bits_obj, idx, value)
+	#define vec_bits_insert(bits_obj, idx, value) VEC89_BITS_INSERT(&bits_obj, idx, value)
+	#define vec_bits_remove(bits_obj, idx) VEC89_BITS_REMOVE(&bits_obj, idx)
+	#define vec_bits_and(bits_obj, other_obj) VEC89_BITS_AND(&bits_obj, &other_obj)
+	#define vec_bits_or(bits_obj, other_obj) VEC89_BITS_OR(&bits_obj, &other_obj)
+	#define vec_bits_xor(bits_obj, other_obj) VEC89_BITS_XOR(&bits_obj, &other_obj)
+	#define vec_bits_not(bits_obj) VEC89_BITS_NOT(&bits_obj)
+	#define vec_bits_popcount(bits_obj, out_count_ptr) VEC89_BITS_POPCOUNT(&bits_obj, out_count_ptr)
+	#define vec_bits_rank(bits_obj, idx, out_rank_ptr) VEC89_BITS_RANK(&bits_obj, idx, out_rank_ptr)
+	#define vec_bits_find_first_set(bits_obj, out_idx_ptr) VEC89_BITS_FIND_FIRST_SET(&bits_obj, out_idx_ptr)
+	#define vec_bits_find_next_set(bits_obj, idx, out_idx_ptr) VEC89_BITS_FIND_NEXT_SET(&bits_obj, idx, out_idx_ptr)
+	#define vec_segmented_init(vec_obj, element_size, allocator_ptr) VEC89_SEGMENTED_INITIALIZATION(&vec_obj, element_size, allocator_ptr)
+	#define vec_segmented_free(vec_obj) VEC89_SEGMENTED_ARRAY_FREE(&vec_obj)
+	#define vec_segmented_clear(vec_obj) VEC89_SEGMENTED_CLEAR(&vec_obj)
+	#define vec_segmented_reserve(vec_obj, new_capacity) VEC89_SEGMENTED_RESERVE(&vec_obj, new_capacity)
+	#define vec_segmented_shrink_to_fit(vec_obj) VEC89_SEGMENTED_SHRINK_TO_FIT(&vec_obj)
+	#define vec_segmented_push(vec_obj, element_ptr) VEC89_SEGMENTED_PUSH(&vec_obj, element_ptr)
+	#define vec_segmented_push_n(vec_obj, elements_ptr, n) VEC89_SEGMENTED_PUSH_N(&vec_obj, elements_ptr, n)
+	#define vec_segmented_pop_into(vec_obj, out_element_ptr) VEC89_SEGMENTED_POP_INTO(&vec_obj, out_element_ptr)
+	#define vec_segmented_get(vec_obj, idx, out_ptr_ptr) VEC89_SEGMENTED_GET(&vec_obj, idx, out_ptr_ptr)
+	#define vec_segmented_get_copy(vec_obj, idx, out_element_ptr) VEC89_SEGMENTED_GET_COPY(&vec_obj, idx, out_element_ptr)
+	#define vec_segmented_set(vec_obj, idx, element_ptr) VEC89_SEGMENTED_SET(&vec_obj, idx, element_ptr)
+	#define vec_segmented_insert(vec_obj, idx, element_ptr) VEC89_SEGMENTED_INSERT(&vec_obj, idx, element_ptr)
+	#define vec_segmented_remove(vec_obj, idx) VEC89_SEGMENTED_REMOVE(&vec_obj, idx)
+	#define vec_segmented_segment(vec_obj, segment, out_elements_ptr, out_count_ptr) VEC89_SEGMENTED_SEGMENT(&vec_obj, segment, out_elements_ptr, out_count_ptr)
+	#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+		#define vec_concurrent_init(vec_obj, element_size, allocator_ptr) VEC89_CONCURRENT_INITIALIZATION(&vec_obj, element_size, allocator_ptr)
+		#define vec_concurrent_free(vec_obj) VEC89_CONCURRENT_ARRAY_FREE(&vec_obj)
+		#define vec_concurrent_reserve(vec_obj, new_capacity) VEC89_CONCURRENT_RESERVE(&vec_obj, new_capacity)
+		#define vec_concurrent_push(vec_obj, element_ptr, out_idx_ptr) VEC89_CONCURRENT_PUSH(&vec_obj, element_ptr, out_idx_ptr)
+		#define vec_concurrent_get(vec_obj, idx, out_ptr_ptr) VEC89_CONCURRENT_GET(&vec_obj, idx, out_ptr_ptr)
+		#define vec_concurrent_count(vec_obj) VEC89_CONCURRENT_COUNT(&vec_obj)
+	#endif
 #endif
 
 /*
 Initializes a vector with the given element size and the default capacity value
+With VEC89_SMALL_BUFFER_NOTC89 the vector starts out with its inline storage and allocates nothing.
 Returns 0 on success, non-zero error codes on failure.
 
 *vec_p vec: Pointer to the vector. (vec != NULL)
@@ -100,7 +672,52 @@ Returns 0 on success, non-zero error codes on failure.
 char VEC89_INITIALIZATION(vec_p vec, size_t element_size);
 
 /*
-Frees the given vector's array.
+Initializes a vector like VEC89_INITIALIZATION but every allocation of the vector goes through the given allocator.
+The allocator isn't copied, it must outlive the vector.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t element_size: Size of a single element in bytes. (element_size > 0)
+*const vec89_allocator *allocator: Pointer to the allocator, NULL for the default allocator.
+*/
+char VEC89_INITIALIZATION_ALLOCATOR(vec_p vec, size_t element_size, const vec89_allocator *allocator);
+
+/*
+Initializes a vector with room for capacity elements. A capacity of 0 allocates nothing until the first element is added,
+capacities that fit the inline storage of VEC89_SMALL_BUFFER_NOTC89 use it.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t element_size: Size of a single element in bytes. (element_size > 0)
+*size_t capacity: Initial element capacity.
+*/
+char VEC89_INITIALIZATION_CAPACITY(vec_p vec, size_t element_size, size_t capacity);
+
+#ifdef VEC89_FILE_BACKED_NOTC89
+/*
+Initializes a vector whose array lives in a memory-mapped file. Every VEC89_* function works on it, growing the vector
+extends the file. The count is written to the file by VEC89_FILE_SYNC and VEC89_ARRAY_FREE, which also closes the file.
+Shrinking the file clamps the stored count to the new capacity, so the file stays valid if the process dies before the next sync.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_FAILURE if the file can't be opened or isn't a valid vector file.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const char *path: Path to the file. (path != NULL)
+*size_t element_size: Size of a single element in bytes, must match the file's. 0 takes it from an existing file.
+*char mode: VEC89_FILE_READ_ONLY, VEC89_FILE_READ_WRITE or VEC89_FILE_CREATE. (element_size > 0 for VEC89_FILE_CREATE)
+*/
+char VEC89_FILE_OPEN(vec_p vec, const char *path, size_t element_size, char mode);
+
+/*
+Writes the count to the file header and flushes the mapped pages to the file.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to a file-backed vector. (vec != NULL)
+*/
+char VEC89_FILE_SYNC(vec_p vec);
+#endif
+
+/*
+Frees the given vector's array and destroys its lock.
 The vector pointer isn't freed.
 
 *vec_p vec: Pointer to the vector.
@@ -115,6 +732,101 @@ Do not use this on stack allocated vectors, Freeing stack memory is undefined be
 */
 void VEC89_FREE(vec_p vec);
 
+/*
+Sets the lock policy of the vector, one of the VEC89_LOCK_POLICY_* values. Vectors start with VEC89_LOCK_POLICY_DEFAULT.
+Must be called before the vector is shared between threads. Without VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89 the policy is ignored.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*char policy: VEC89_LOCK_POLICY_NONE, VEC89_LOCK_POLICY_SPIN, VEC89_LOCK_POLICY_ADAPTIVE or VEC89_LOCK_POLICY_MUTEX.
+*/
+char VEC89_SET_LOCK_POLICY(vec_p vec, char policy);
+
+/*
+Attaches a growth policy to the vector. The policy isn't copied, it must outlive the vector and can be shared between vectors.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const vec89_growth_policy *policy: Pointer to the policy, NULL to go back to doubling without automatic shrinking.
+*/
+char VEC89_SET_GROWTH_POLICY(vec_p vec, const vec89_growth_policy *policy);
+
+/*
+Sets the array size in bytes from which the array moves into its own mapping. Vectors start with VEC89_MMAP_THRESHOLD.
+Arrays move back to the heap once they shrink below half the threshold. Vectors with an allocator are never mapped.
+Without VEC89_MMAP_NOTC89 the threshold is ignored.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t threshold: Threshold in bytes, 0 to never map the array.
+*/
+char VEC89_SET_MMAP_THRESHOLD(vec_p vec, size_t threshold);
+
+/*
+Locks the vector until the matching VEC89_LOCK_SCOPE_END. Inside the scope the calling thread can use every VEC89_* function
+on the vector, they run without locking again, so a sequence like GET then SET is atomic and takes the lock once.
+Scopes can be nested. Without VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89 this does nothing.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*/
+char VEC89_LOCK_SCOPE_BEGIN(vec_p vec);
+
+/*
+Ends a lock scope started by the calling thread with VEC89_LOCK_SCOPE_BEGIN.
+
+*vec_p vec: Pointer to the vector.
+*/
+void VEC89_LOCK_SCOPE_END(vec_p vec);
+
+#ifdef VEC89_STATS
+/*
+Copies the vector's counters.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_stats *out_stats: Pointer receiving the counters. (out_stats != NULL)
+*/
+char VEC89_STATS_GET(vec_p vec, vec89_stats *out_stats);
+
+/*
+Zeroes the vector's counters. The peak capacity restarts at the current capacity.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*/
+char VEC89_STATS_RESET(vec_p vec);
+
+/*
+Names the vector in VEC89_STATS_DUMP output. The string isn't copied, it must outlive the vector.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const char *name: Name of the vector, NULL to show it by address only.
+*/
+char VEC89_STATS_SET_NAME(vec_p vec, const char *name);
+
+/*
+Writes the counters of every initialized vector that wasn't freed yet. The vectors aren't locked while they are read,
+so counters of vectors in use by other threads are a close snapshot rather than an exact one.
+Returns 0 on success, non-zero error codes on failure.
+
+*FILE *stream: Stream to write to. (stream != NULL)
+*char format: VEC89_STATS_TEXT or VEC89_STATS_JSON.
+*/
+char VEC89_STATS_DUMP(FILE *stream, char format);
+
+/*
+Sets the function called after any vector's array was grown or shrunk by a reallocation.
+The hook runs on the thread that changed the vector, while it holds the vector's lock, and must not use that vector.
+Set it before other threads start using vectors.
+
+*vec89_stats_hook hook: Hook function, NULL to remove the hook.
+*void *context: Passed to every call of the hook.
+*/
+void VEC89_STATS_SET_HOOK(vec89_stats_hook hook, void *context);
+#endif
+
 /*
 Sets the count value to zero.
 
@@ -133,7 +845,7 @@ char VEC89_RESERVE(vec_p vec, size_t capacity);
 
 /*
 Expands the vector as if its capacity is full n times.
-Returns 0 on success, non-zero error codes on failure.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_MEMORY_ERROR if the new size overflows.
 
 *vec_p vec: Pointer to the vector. (vec != NULL)
 *size_t n: Times to expand. (n > 0)
@@ -168,7 +880,7 @@ Returns 0 on success, non-zero error codes on failure.
 char VEC89_PUSH(vec_p vec, const void *element);
 
 /*
-Removes the last element at the end of the vector. The element is duplicated, element must be freed by the caller.
+Removes the last element at the end of the vector. The element is duplicated with malloc, element must be freed by the caller with free.
 Returns 0 on success, non-zero error codes on failure.
 
 *vec_p vec: Pointer to the vector. (vec != NULL)
@@ -176,6 +888,36 @@ Returns 0 on success, non-zero error codes on failure.
 */
 char VEC89_POP(vec_p vec, void **out_element);
 
+/*
+Removes the last element at the end of the vector and copies it into the caller's storage. Nothing is allocated.
+Returns 0 on success, non-zero error codes on failure. Popping an empty vector returns VEC89_ARRAY_OUT_OF_INDEX.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*void *out_element: Pointer to storage of at least elem_size bytes. (out_element != NULL)
+*/
+char VEC89_POP_INTO(vec_p vec, void *out_element);
+
+/*
+Removes the last n elements of the vector and copies them into the caller's storage with a single memcpy.
+The elements keep their vector order, the last element of the vector ends up last in out_elements.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*void *out_elements: Pointer to storage of at least n * elem_size bytes. (out_elements != NULL if n > 0)
+*size_t n: Number of elements to pop. (n <= count)
+*/
+char VEC89_POP_N(vec_p vec, void *out_elements, size_t n);
+
+/*
+Gets the last element of the vector without removing it. The element isn't duplicated, the pointer's ownership is still at the vector.
+Sets the pointer to NULL if the vector is empty.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*void **out_element: Pointer to the pointer to the element. (out_element != NULL)
+*/
+char VEC89_PEEK(vec_p vec, void **out_element);
+
 /*
 Sets an element at the index. The index cannot be out of range of the vector. The element is duplicated.
 Returns 0 on success, non-zero error codes on failure.
@@ -208,6 +950,8 @@ char VEC89_INSERT(vec_p vec, size_t idx, const void *element);
 
 /*
 Gets the element at index. The element isn't duplicated, the pointer's ownership is still at the vector.
+Any call that grows or shrinks the array can move it, use vec89_segmented for pointers that stay valid.
+In thread-safe builds the pointer can be invalidated by any concurrent write, use VEC89_GET_COPY or VEC89_READ_BEGIN instead.
 Returns 0 on success, non-zero error codes on failure.
 
 *vec_p vec: Pointer to the vector. (vec != NULL)
@@ -216,4 +960,850 @@ Returns 0 on success, non-zero error codes on failure.
 */
 char VEC89_GET(vec_p vec, size_t idx, void **out_element);
 
+/*
+Pushes n contiguous elements at the end of the vector. The vector grows at most once and the elements are copied with a single memcpy.
+The elements must not point into the vector's own array.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const void *elements: Pointer to the first element. (elements != NULL if n > 0)
+*size_t n: Number of elements to push.
+*/
+char VEC89_PUSH_N(vec_p vec, const void *elements, size_t n);
+
+/*
+Inserts n contiguous elements at index. The remaining elements are shifted once.
+The vector grows at most once. The elements must not point into the vector's own array.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index to insert the elements at (0 <= idx <= count)
+*const void *elements: Pointer to the first element. (elements != NULL if n > 0)
+*size_t n: Number of elements to insert.
+*/
+char VEC89_INSERT_RANGE(vec_p vec, size_t idx, const void *elements, size_t n);
+
+/*
+Removes n elements starting at index. The remaining elements are shifted once.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the first element to remove (idx + n <= count)
+*size_t n: Number of elements to remove.
+*/
+char VEC89_REMOVE_RANGE(vec_p vec, size_t idx, size_t n);
+
+/*
+Appends every element of other at the end of vec. Both vectors must have the same element size.
+Appending a vector to itself is allowed.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the destination vector. (vec != NULL)
+*vec_p other: Pointer to the source vector. (other != NULL, other->elem_size == vec->elem_size)
+*/
+char VEC89_APPEND_VEC(vec_p vec, vec_p other);
+
+/*
+Removes the element at index by moving the last element into its place. O(1), but does not keep the order.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the element to remove. (idx < count)
+*/
+char VEC89_SWAP_REMOVE(vec_p vec, size_t idx);
+
+/*
+Removes every element for which predicate returns non-zero, keeping the order of the others.
+The predicate is called once per element, in index order. Runs of kept elements are moved with one memmove each.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_predicate_function predicate: Function called with each element and context. (predicate != NULL)
+*void *context: Passed to predicate.
+*size_t *out_removed: Pointer receiving the number of removed elements, can be NULL.
+*/
+char VEC89_REMOVE_IF(vec_p vec, vec89_predicate_function predicate, void *context, size_t *out_removed);
+
+/*
+Keeps only the elements for which predicate returns non-zero, in one pass like VEC89_REMOVE_IF.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_predicate_function predicate: Function called with each element and context. (predicate != NULL)
+*void *context: Passed to predicate.
+*size_t *out_removed: Pointer receiving the number of removed elements, can be NULL.
+*/
+char VEC89_RETAIN(vec_p vec, vec89_predicate_function predicate, void *context, size_t *out_removed);
+
+/*
+Removes every element equal to the one before it, so each run of equal elements keeps its first element.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_equal_function equal: Function comparing two elements, NULL to compare their bytes.
+*void *context: Passed to equal.
+*size_t *out_removed: Pointer receiving the number of removed elements, can be NULL.
+*/
+char VEC89_DEDUP(vec_p vec, vec89_equal_function equal, void *context, size_t *out_removed);
+
+/*
+Copies the element at index into the caller's storage while the vector is locked for reading.
+Unlike VEC89_GET the result stays valid after concurrent writes.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the element (0 <= idx < count)
+*void *out_element: Pointer to storage of at least elem_size bytes. (out_element != NULL)
+*/
+char VEC89_GET_COPY(vec_p vec, size_t idx, void *out_element);
+
+/*
+Locks the vector for reading and returns its array and count. The array stays valid and unchanged until VEC89_READ_END.
+With VEC89_READ_SCALABLE_NOTC89 any number of threads can hold a read section at the same time.
+No other VEC89_* function may be called on the vector by the same thread before VEC89_READ_END.
+Returns 0 on success, non-zero error codes on failure, the vector is only left locked on success.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const void **out_arr: Pointer to the pointer to the first element. (out_arr != NULL)
+*size_t *out_count: Pointer to the element count. (out_count != NULL)
+*/
+char VEC89_READ_BEGIN(vec_p vec, const void **out_arr, size_t *out_count);
+
+/*
+Ends a read section started with VEC89_READ_BEGIN.
+
+*vec_p vec: Pointer to the vector.
+*/
+void VEC89_READ_END(vec_p vec);
+
+/*
+Locks the vector once and returns the elements [begin, end) as a pointer, stride and count, so a loop over them needs
+no further calls, checks or locks. Read-only views lock the vector shared with VEC89_READ_SCALABLE_NOTC89, writable
+views lock it exclusively and may overwrite the elements. The range stays valid until VEC89_VIEW_RELEASE.
+No other VEC89_* function may be called on the vector by the same thread before the view is released.
+Returns 0 on success, non-zero error codes on failure, the vector is only left locked on success.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t begin: Index of the first element. (begin <= end)
+*size_t end: Index after the last element, VEC89_VIEW_END_OF_VECTOR for the vector's count. (end <= count)
+*char writable: Non-zero to write through the view.
+*vec89_view *out_view: Pointer receiving the view. (out_view != NULL)
+*/
+char VEC89_VIEW(vec_p vec, size_t begin, size_t end, char writable, vec89_view *out_view);
+
+/*
+Unlocks the vector of a view returned by VEC89_VIEW. The view's pointer must not be used afterwards.
+
+*vec89_view *view: Pointer to the view.
+*/
+void VEC89_VIEW_RELEASE(vec89_view *view);
+
+/*
+Copies n contiguous elements starting at index into the caller's storage with one memcpy, under one read lock.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the first element. (idx + n <= count)
+*void *out_elements: Pointer to storage of at least n * elem_size bytes. (out_elements != NULL if n > 0)
+*size_t n: Number of elements to copy.
+*/
+char VEC89_GET_N(vec_p vec, size_t idx, void *out_elements, size_t n);
+
+/*
+Overwrites n contiguous elements starting at index with one memcpy, under one lock.
+The elements must not point into the vector's own array.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the first element to overwrite. (idx + n <= count)
+*const void *elements: Pointer to the first element. (elements != NULL if n > 0)
+*size_t n: Number of elements to copy.
+*/
+char VEC89_SET_N(vec_p vec, size_t idx, const void *elements, size_t n);
+
+/*
+Initializes out_clone as a copy of vec with the same elements, growth policy and allocator.
+With VEC89_COPY_ON_WRITE_NOTC89 the clone shares the array and whichever vector is written first copies it,
+except for arrays in the inline buffer, in a mapping or in a file, which are copied right away.
+Free the clone with VEC89_ARRAY_FREE like any other vector.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector to clone. (vec != NULL)
+*vec_p out_clone: Pointer to an uninitialized vector receiving the clone. (out_clone != NULL, out_clone != vec)
+*/
+char VEC89_CLONE(vec_p vec, vec_p out_clone);
+
+/*
+Gives the vector its own copy of the array if it shares it with clones or snapshots. Every VEC89_* function that
+writes elements does this itself, call it before writing through VEC89_DATA, VEC89_AT, vec89_at or pointers
+returned by VEC89_GET and VEC89_PEEK. Does nothing without VEC89_COPY_ON_WRITE_NOTC89.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*/
+char VEC89_DETACH(vec_p vec);
+
+/*
+Takes an immutable snapshot of the vector's elements. Readers use the snapshot without any locking and it stays
+unchanged whatever happens to the vector afterwards. With VEC89_COPY_ON_WRITE_NOTC89 the snapshot shares the array
+and the vector copies it on its next write, otherwise the elements are copied now.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_snapshot *out_snapshot: Pointer to the snapshot to fill. (out_snapshot != NULL)
+*/
+char VEC89_SNAPSHOT(vec_p vec, vec89_snapshot *out_snapshot);
+
+/*
+Releases a snapshot. The last owner of a shared array frees it.
+
+*vec89_snapshot *snapshot: Pointer to the snapshot.
+*/
+void VEC89_SNAPSHOT_RELEASE(vec89_snapshot *snapshot);
+
+/*
+Initializes a deque. No storage is allocated until the first element is added.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*size_t element_size: Size of a single element in bytes. (element_size > 0)
+*const vec89_allocator *allocator: Pointer to the allocator, NULL for the default allocator.
+*/
+char VEC89_DEQUE_INITIALIZATION(vec89_deque_p deque, size_t element_size, const vec89_allocator *allocator);
+
+/*
+Frees the ring buffer of a deque.
+
+*vec89_deque_p deque: Pointer to the deque.
+*/
+void VEC89_DEQUE_ARRAY_FREE(vec89_deque_p deque);
+
+/*
+Grows the ring buffer to hold at least capacity elements, rounded up to a power of two. Never shrinks.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*size_t capacity: Minimum element capacity.
+*/
+char VEC89_DEQUE_RESERVE(vec89_deque_p deque, size_t capacity);
+
+/*
+Removes every element, the ring buffer is kept.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*/
+char VEC89_DEQUE_CLEAR(vec89_deque_p deque);
+
+/*
+Appends an element at the back. Amortized O(1).
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_DEQUE_PUSH_BACK(vec89_deque_p deque, const void *element);
+
+/*
+Prepends an element at the front. Amortized O(1).
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_DEQUE_PUSH_FRONT(vec89_deque_p deque, const void *element);
+
+/*
+Removes the last element. Returns VEC89_ARRAY_OUT_OF_INDEX if the deque is empty.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*void *out_element: Pointer receiving a copy of the element, NULL to discard it.
+*/
+char VEC89_DEQUE_POP_BACK(vec89_deque_p deque, void *out_element);
+
+/*
+Removes the first element. Returns VEC89_ARRAY_OUT_OF_INDEX if the deque is empty.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*void *out_element: Pointer receiving a copy of the element, NULL to discard it.
+*/
+char VEC89_DEQUE_POP_FRONT(vec89_deque_p deque, void *out_element);
+
+/*
+Retrieves a pointer to the element at idx, counted from the front. The pointer is valid until the deque is modified.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*size_t idx: Index of the element. (idx < deque->count)
+*void **out_element: Pointer receiving the element pointer. (out_element != NULL)
+*/
+char VEC89_DEQUE_GET(vec89_deque_p deque, size_t idx, void **out_element);
+
+/*
+Overwrites the element at idx, counted from the front.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*size_t idx: Index of the element. (idx < deque->count)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_DEQUE_SET(vec89_deque_p deque, size_t idx, const void *element);
+
+/*
+Inserts an element at idx, counted from the front. The elements before or after idx move, whichever are fewer.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*size_t idx: Index of the new element. (idx <= deque->count)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_DEQUE_INSERT(vec89_deque_p deque, size_t idx, const void *element);
+
+/*
+Removes the element at idx, counted from the front. The elements before or after idx move, whichever are fewer.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*size_t idx: Index of the element. (idx < deque->count)
+*/
+char VEC89_DEQUE_REMOVE(vec89_deque_p deque, size_t idx);
+
+/*
+Rotates the ring buffer so the elements form one contiguous span, if they wrap around its end.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_deque_p deque: Pointer to the deque. (deque != NULL)
+*void **out_arr: Pointer receiving the first element, valid until the deque is modified. NULL for empty deques that never allocated. (out_arr != NULL)
+*/
+char VEC89_DEQUE_LINEARIZE(vec89_deque_p deque, void **out_arr);
+
+/*
+Initializes a columnar vector with one empty column per field. The schema is copied.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*const vec89_soa_field *fields: Array of field_count fields. (fields != NULL, size > 0, offset + size <= row_size)
+*size_t field_count: Number of fields. (field_count > 0)
+*size_t row_size: Size of a row in the caller's layout, e.g. sizeof(struct record). (row_size > 0)
+*const vec89_allocator *allocator: Pointer to an allocator for the columns and the schema, NULL for the default allocator.
+*/
+char VEC89_SOA_INITIALIZATION(vec89_soa_p soa, const vec89_soa_field *fields, size_t field_count, size_t row_size, const vec89_allocator *allocator);
+
+/*
+Frees every column and the schema.
+
+*vec89_soa_p soa: Pointer to the vector.
+*/
+void VEC89_SOA_ARRAY_FREE(vec89_soa_p soa);
+
+/*
+Sets the row count to zero.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*/
+char VEC89_SOA_CLEAR(vec89_soa_p soa);
+
+/*
+Grows every column so it holds at least capacity rows.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t capacity: Target capacity in rows.
+*/
+char VEC89_SOA_RESERVE(vec89_soa_p soa, size_t capacity);
+
+/*
+Appends a row, each field is copied into its column.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*const void *row: Pointer to the row in the caller's layout. (row != NULL)
+*/
+char VEC89_SOA_PUSH(vec89_soa_p soa, const void *row);
+
+/*
+Appends n contiguous rows of the caller's layout. The columns grow at most once.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*const void *rows: Pointer to the first row. (rows != NULL if n > 0)
+*size_t n: Number of rows.
+*/
+char VEC89_SOA_PUSH_N(vec89_soa_p soa, const void *rows, size_t n);
+
+/*
+Removes the last row and copies it into out_row.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*void *out_row: Pointer to storage of at least row_size bytes, can be NULL to drop the row.
+*/
+char VEC89_SOA_POP_INTO(vec89_soa_p soa, void *out_row);
+
+/*
+Copies the row at index into out_row. Bytes of the row that belong to no field are left untouched.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index of the row. (idx < count)
+*void *out_row: Pointer to storage of at least row_size bytes. (out_row != NULL)
+*/
+char VEC89_SOA_GET(vec89_soa_p soa, size_t idx, void *out_row);
+
+/*
+Overwrites the row at index.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index of the row. (idx < count)
+*const void *row: Pointer to the row in the caller's layout. (row != NULL)
+*/
+char VEC89_SOA_SET(vec89_soa_p soa, size_t idx, const void *row);
+
+/*
+Copies one field of the row at index.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index of the row. (idx < count)
+*size_t field: Index of the field in the schema. (field < field_count)
+*void *out_value: Pointer to storage of at least the field's size. (out_value != NULL)
+*/
+char VEC89_SOA_GET_FIELD(vec89_soa_p soa, size_t idx, size_t field, void *out_value);
+
+/*
+Overwrites one field of the row at index.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index of the row. (idx < count)
+*size_t field: Index of the field in the schema. (field < field_count)
+*const void *value: Pointer to the new value. (value != NULL)
+*/
+char VEC89_SOA_SET_FIELD(vec89_soa_p soa, size_t idx, size_t field, const void *value);
+
+/*
+Inserts a row at index, every column is shifted by one element.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index to insert the row at. (idx <= count)
+*const void *row: Pointer to the row in the caller's layout. (row != NULL)
+*/
+char VEC89_SOA_INSERT(vec89_soa_p soa, size_t idx, const void *row);
+
+/*
+Removes the row at index, every column is shifted by one element.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index of the row. (idx < count)
+*/
+char VEC89_SOA_REMOVE(vec89_soa_p soa, size_t idx);
+
+/*
+Gathers n rows starting at index from the columns into a contiguous array of rows in the caller's layout.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index of the first row. (idx + n <= count)
+*void *out_rows: Pointer to storage of at least n * row_size bytes. (out_rows != NULL if n > 0)
+*size_t n: Number of rows.
+*/
+char VEC89_SOA_GATHER(vec89_soa_p soa, size_t idx, void *out_rows, size_t n);
+
+/*
+Scatters n contiguous rows of the caller's layout into the columns, overwriting the rows starting at index.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t idx: Index of the first row to overwrite. (idx + n <= count)
+*const void *rows: Pointer to the first row. (rows != NULL if n > 0)
+*size_t n: Number of rows.
+*/
+char VEC89_SOA_SCATTER(vec89_soa_p soa, size_t idx, const void *rows, size_t n);
+
+/*
+Locks the vector once and returns the rows [begin, end) of every column as one view per field, out_views[field].
+Each view is contiguous, so a loop over a column is a plain array scan the compiler can vectorize.
+Read-only views lock the vector shared with VEC89_READ_SCALABLE_NOTC89, writable views lock it exclusively.
+The views stay valid until VEC89_SOA_VIEW_RELEASE, VEC89_VIEW_RELEASE does nothing on them.
+No other VEC89_SOA_* function may be called on the vector by the same thread before the views are released.
+Returns 0 on success, non-zero error codes on failure, the vector is only left locked on success.
+
+*vec89_soa_p soa: Pointer to the vector. (soa != NULL)
+*size_t begin: Index of the first row. (begin <= end)
+*size_t end: Index after the last row, VEC89_VIEW_END_OF_VECTOR for the row count. (end <= count)
+*char writable: Non-zero to write through the views.
+*vec89_view *out_views: Array of field_count views receiving the columns. (out_views != NULL)
+*/
+char VEC89_SOA_VIEW(vec89_soa_p soa, size_t begin, size_t end, char writable, vec89_view *out_views);
+
+/*
+Unlocks the vector after VEC89_SOA_VIEW. The views must not be used afterwards.
+
+*vec89_soa_p soa: Pointer to the vector.
+*vec89_view *views: The views filled by VEC89_SOA_VIEW.
+*/
+void VEC89_SOA_VIEW_RELEASE(vec89_soa_p soa, vec89_view *views);
+
+/*
+Initializes an empty bit vector. No storage is allocated until the first bit is added.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*const vec89_allocator *allocator: Pointer to an allocator, NULL for the default allocator.
+*/
+char VEC89_BITS_INITIALIZATION(vec89_bits_p bits, const vec89_allocator *allocator);
+
+/*
+Frees the words of the bit vector.
+
+*vec89_bits_p bits: Pointer to the bit vector.
+*/
+void VEC89_BITS_ARRAY_FREE(vec89_bits_p bits);
+
+/*
+Grows the bit vector so it holds at least capacity bits without reallocating.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t capacity: Target capacity in bits.
+*/
+char VEC89_BITS_RESERVE(vec89_bits_p bits, size_t capacity);
+
+/*
+Sets the bit count, new bits are set to value a word at a time.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t count: New bit count.
+*char value: Value of the added bits, non-zero for 1.
+*/
+char VEC89_BITS_RESIZE(vec89_bits_p bits, size_t count, char value);
+
+/*
+Appends a bit.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*char value: Value of the bit, non-zero for 1.
+*/
+char VEC89_BITS_PUSH(vec89_bits_p bits, char value);
+
+/*
+Removes the last bit.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*char *out_value: Pointer receiving the removed bit, can be NULL.
+*/
+char VEC89_BITS_POP(vec89_bits_p bits, char *out_value);
+
+/*
+Reads a bit.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t idx: Index of the bit. (idx < count)
+*char *out_value: Pointer receiving 1 or 0. (out_value != NULL)
+*/
+char VEC89_BITS_GET(vec89_bits_p bits, size_t idx, char *out_value);
+
+/*
+Writes a bit.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t idx: Index of the bit. (idx < count)
+*char value: Value of the bit, non-zero for 1.
+*/
+char VEC89_BITS_SET(vec89_bits_p bits, size_t idx, char value);
+
+/*
+Inserts a bit at idx, the bits after it move up one position a word at a time.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t idx: Index of the new bit. (idx <= count)
+*char value: Value of the bit, non-zero for 1.
+*/
+char VEC89_BITS_INSERT(vec89_bits_p bits, size_t idx, char value);
+
+/*
+Removes the bit at idx, the bits after it move down one position a word at a time.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t idx: Index of the bit. (idx < count)
+*/
+char VEC89_BITS_REMOVE(vec89_bits_p bits, size_t idx);
+
+/*
+Replaces the bits of the vector with their AND with other's bits. The loop works on whole words and vectorizes.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector receiving the result. (bits != NULL)
+*vec89_bits_p other: Pointer to the second operand. (other != NULL, other->count == bits->count)
+*/
+char VEC89_BITS_AND(vec89_bits_p bits, vec89_bits_p other);
+
+/*
+Replaces the bits of the vector with their OR with other's bits, like VEC89_BITS_AND.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector receiving the result. (bits != NULL)
+*vec89_bits_p other: Pointer to the second operand. (other != NULL, other->count == bits->count)
+*/
+char VEC89_BITS_OR(vec89_bits_p bits, vec89_bits_p other);
+
+/*
+Replaces the bits of the vector with their XOR with other's bits, like VEC89_BITS_AND.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector receiving the result. (bits != NULL)
+*vec89_bits_p other: Pointer to the second operand. (other != NULL, other->count == bits->count)
+*/
+char VEC89_BITS_XOR(vec89_bits_p bits, vec89_bits_p other);
+
+/*
+Flips every bit.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*/
+char VEC89_BITS_NOT(vec89_bits_p bits);
+
+/*
+Counts the set bits a word at a time. x86 GCC/Clang builds use the popcnt instruction when the CPU has it.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t *out_count: Pointer receiving the number of set bits. (out_count != NULL)
+*/
+char VEC89_BITS_POPCOUNT(vec89_bits_p bits, size_t *out_count);
+
+/*
+Counts the set bits before idx, with the same word-at-a-time count as VEC89_BITS_POPCOUNT.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t idx: End of the counted range [0, idx). (idx <= count)
+*size_t *out_rank: Pointer receiving the number of set bits before idx. (out_rank != NULL)
+*/
+char VEC89_BITS_RANK(vec89_bits_p bits, size_t idx, size_t *out_rank);
+
+/*
+Finds the first set bit, skipping zero words and counting trailing zeros of the first non-zero one.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t *out_idx: Pointer receiving the index of the bit, count if no bit is set. (out_idx != NULL)
+*/
+char VEC89_BITS_FIND_FIRST_SET(vec89_bits_p bits, size_t *out_idx);
+
+/*
+Finds the first set bit at or after idx, like VEC89_BITS_FIND_FIRST_SET. Calling it again with the found index + 1
+walks every set bit.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_bits_p bits: Pointer to the bit vector. (bits != NULL)
+*size_t idx: Index the search starts at. (idx <= count)
+*size_t *out_idx: Pointer receiving the index of the bit, count if no bit is set from idx on. (out_idx != NULL)
+*/
+char VEC89_BITS_FIND_NEXT_SET(vec89_bits_p bits, size_t idx, size_t *out_idx);
+
+/*
+Initializes a segmented vector. No segment is allocated until the first element is added.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t element_size: Size of a single element in bytes. (element_size > 0)
+*const vec89_allocator *allocator: Pointer to the allocator, NULL for the default allocator.
+*/
+char VEC89_SEGMENTED_INITIALIZATION(vec89_segmented_p vec, size_t element_size, const vec89_allocator *allocator);
+
+/*
+Frees every segment of the vector.
+
+*vec89_segmented_p vec: Pointer to the vector.
+*/
+void VEC89_SEGMENTED_ARRAY_FREE(vec89_segmented_p vec);
+
+/*
+Removes every element, the segments are kept.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*/
+char VEC89_SEGMENTED_CLEAR(vec89_segmented_p vec);
+
+/*
+Allocates the segments needed to hold capacity elements. Existing elements are not moved.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t capacity: Target capacity.
+*/
+char VEC89_SEGMENTED_RESERVE(vec89_segmented_p vec, size_t capacity);
+
+/*
+Frees the segments past the one holding the last element.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*/
+char VEC89_SEGMENTED_SHRINK_TO_FIT(vec89_segmented_p vec);
+
+/*
+Appends an element. Allocates a new segment when the last one is full, existing elements never move.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_SEGMENTED_PUSH(vec89_segmented_p vec, const void *element);
+
+/*
+Appends n contiguous elements with one copy per segment they span.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*const void *elements: Pointer to the first element. (elements != NULL if n > 0)
+*size_t n: Number of elements.
+*/
+char VEC89_SEGMENTED_PUSH_N(vec89_segmented_p vec, const void *elements, size_t n);
+
+/*
+Removes the last element into the caller's storage. Segments are kept for later pushes.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*void *out_element: Pointer receiving a copy of the element, NULL to discard it.
+*/
+char VEC89_SEGMENTED_POP_INTO(vec89_segmented_p vec, void *out_element);
+
+/*
+Gets the element at index. The pointer stays valid while the element is in the vector,
+only VEC89_SEGMENTED_INSERT and VEC89_SEGMENTED_REMOVE before it shift other elements into its place.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the element. (idx < count)
+*void **out_element: Pointer receiving the element pointer. (out_element != NULL)
+*/
+char VEC89_SEGMENTED_GET(vec89_segmented_p vec, size_t idx, void **out_element);
+
+/*
+Copies the element at index into the caller's storage while the vector is locked for reading.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the element. (idx < count)
+*void *out_element: Pointer receiving a copy of the element. (out_element != NULL)
+*/
+char VEC89_SEGMENTED_GET_COPY(vec89_segmented_p vec, size_t idx, void *out_element);
+
+/*
+Overwrites the element at index.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the element. (idx < count)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_SEGMENTED_SET(vec89_segmented_p vec, size_t idx, const void *element);
+
+/*
+Inserts an element at index and shifts the following elements up, one memmove per segment.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the new element. (idx <= count)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_SEGMENTED_INSERT(vec89_segmented_p vec, size_t idx, const void *element);
+
+/*
+Removes the element at index and shifts the following elements down, one memmove per segment.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the element. (idx < count)
+*/
+char VEC89_SEGMENTED_REMOVE(vec89_segmented_p vec, size_t idx);
+
+/*
+Gets the elements stored in a segment, for scanning the vector one contiguous block at a time:
+for (s = 0; VEC89_SEGMENTED_SEGMENT(&v, s, &elements, &n) == VEC89_SUCCESS; s++) { ... }
+Returns VEC89_ARRAY_OUT_OF_INDEX once segment is past the last element.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_segmented_p vec: Pointer to the vector. (vec != NULL)
+*size_t segment: Index of the segment.
+*void **out_elements: Pointer receiving the first element of the segment. (out_elements != NULL)
+*size_t *out_count: Pointer receiving the number of elements in the segment. (out_count != NULL)
+*/
+char VEC89_SEGMENTED_SEGMENT(vec89_segmented_p vec, size_t segment, void **out_elements, size_t *out_count);
+
+#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+/*
+Initializes a concurrent vector. No element storage is allocated until the first push or reserve.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_concurrent_p vec: Pointer to the vector. (vec != NULL)
+*size_t element_size: Size of a single element in bytes. (element_size > 0)
+*const vec89_allocator *allocator: Pointer to a thread safe allocator, NULL for the default allocator.
+*/
+char VEC89_CONCURRENT_INITIALIZATION(vec89_concurrent_p vec, size_t element_size, const vec89_allocator *allocator);
+
+/*
+Frees every segment of the vector. No other thread may use the vector anymore.
+
+*vec89_concurrent_p vec: Pointer to the vector.
+*/
+void VEC89_CONCURRENT_ARRAY_FREE(vec89_concurrent_p vec);
+
+/*
+Allocates the segments needed to hold capacity elements, so later pushes below that index never allocate.
+Can be called while other threads push.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_concurrent_p vec: Pointer to the vector. (vec != NULL)
+*size_t capacity: Target capacity.
+*/
+char VEC89_CONCURRENT_RESERVE(vec89_concurrent_p vec, size_t capacity);
+
+/*
+Appends an element without taking a lock. The call returns once the element and every element before it are published.
+After a segment allocation failed every later push fails with VEC89_MEMORY_ERROR.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_concurrent_p vec: Pointer to the vector. (vec != NULL)
+*const void *element: Pointer to the element. (element != NULL)
+*size_t *out_idx: Pointer receiving the element's index, can be NULL.
+*/
+char VEC89_CONCURRENT_PUSH(vec89_concurrent_p vec, const void *element, size_t *out_idx);
+
+/*
+Gets a published element. Elements never move, the pointer stays valid until the vector is freed.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_concurrent_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the element (0 <= idx < published count)
+*void **out_element: Pointer to the pointer to the element. (out_element != NULL)
+*/
+char VEC89_CONCURRENT_GET(vec89_concurrent_p vec, size_t idx, void **out_element);
+
+/*
+Returns the number of published elements.
+
+*vec89_concurrent_p vec: Pointer to the vector. (vec != NULL)
+*/
+size_t VEC89_CONCURRENT_COUNT(vec89_concurrent_p vec);
+#endif
+
 #endif /* VEC89_H */
\ No newline at end of file
@@ -0,0 +1,968 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#include "vec89_algo.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define min(a, b) ((a) > (b) ? (b) : (a))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+#define VEC89_SIZE_MAX ((size_t)-1)
+
+#define MALLOC_FUNCTION(Size) malloc(Size)
+#define FREE_FUNCTION(Block) free(Block)
+
+#define VEC89_ELEMENT(base, idx, size) ((unsigned char *)(base) + (idx) * (size))
+
+#define VEC89_KEY_KIND_UNSIGNED 0
+#define VEC89_KEY_KIND_SIGNED 1
+#define VEC89_KEY_KIND_FLOAT 2
+
+#define VEC89_SORTED_RADIX_THRESHOLD 256 /* Smaller merged batches are merge sorted even with a key type, the histograms wouldn't pay off */
+
+static void *vec89_algo_alloc(vec_p vec, size_t size) {
+	if (vec->allocator != NULL) return vec->allocator->alloc_function(vec->allocator->context, size);
+	return MALLOC_FUNCTION(size);
+}
+
+static void vec89_algo_free(vec_p vec, void *block, size_t size) {
+	if (vec->allocator != NULL) vec->allocator->free_function(vec->allocator->context, block, size);
+	else FREE_FUNCTION(block);
+}
+
+static void vec89_swap(unsigned char *a, unsigned char *b, size_t size) {
+	unsigned char buffer[64];
+	while (size > 0) {
+		size_t n = min(size, sizeof(buffer));
+		memcpy(buffer, a, n);
+		memcpy(a, b, n);
+		memcpy(b, buffer, n);
+		a += n;
+		b += n;
+		size -= n;
+	}
+}
+
+static size_t vec89_depth_limit(size_t n) {
+	size_t depth = 0;
+	while (n >>= 1) depth += 2;
+	return depth;
+}
+
+static void vec89_insertion_sort(unsigned char *base, size_t n, size_t size, vec89_compare_function compare) {
+	size_t i;
+	for (i = 1; i < n; i++) {
+		size_t j = i;
+		while (j > 0 && compare(VEC89_ELEMENT(base, j - 1, size), VEC89_ELEMENT(base, j, size)) > 0) {
+			vec89_swap(VEC89_ELEMENT(base, j - 1, size), VEC89_ELEMENT(base, j, size), size);
+			j--;
+		}
+	}
+}
+
+static void vec89_sift_down(unsigned char *base, size_t root, size_t n, size_t size, vec89_compare_function compare) {
+	size_t child;
+	while ((child = 2 * root + 1) < n) {
+		if (child + 1 < n && compare(VEC89_ELEMENT(base, child, size), VEC89_ELEMENT(base, child + 1, size)) < 0) child++;
+		if (compare(VEC89_ELEMENT(base, root, size), VEC89_ELEMENT(base, child, size)) >= 0) return;
+		vec89_swap(VEC89_ELEMENT(base, root, size), VEC89_ELEMENT(base, child, size), size);
+		root = child;
+	}
+}
+
+static void vec89_heap_sort(unsigned char *base, size_t n, size_t size, vec89_compare_function compare) {
+	size_t i;
+	for (i = n / 2; i-- > 0;) vec89_sift_down(base, i, n, size, compare);
+	for (i = n - 1; i > 0; i--) {
+		vec89_swap(base, VEC89_ELEMENT(base, i, size), size);
+		vec89_sift_down(base, 0, i, size, compare);
+	}
+}
+
+static void vec89_introsort(unsigned char *base, size_t n, size_t size, vec89_compare_function compare, size_t depth) {
+	while (n > VEC89_SORT_INSERTION_THRESHOLD) {
+		if (depth-- == 0) {
+			vec89_heap_sort(base, n, size, compare);
+			return;
+		}
+
+		/* Median of three moved to the front, the last element then bounds the left scan */
+		unsigned char *middle = VEC89_ELEMENT(base, n / 2, size), *last = VEC89_ELEMENT(base, n - 1, size);
+		if (compare(middle, base) < 0) vec89_swap(middle, base, size);
+		if (compare(last, middle) < 0) {
+			vec89_swap(last, middle, size);
+			if (compare(middle, base) < 0) vec89_swap(middle, base, size);
+		}
+		vec89_swap(middle, base, size);
+
+		/* The pivot stays at the front during the partition */
+		size_t i = 1, j = n - 1;
+		for (;;) {
+			while (compare(VEC89_ELEMENT(base, i, size), base) < 0) i++;
+			while (compare(base, VEC89_ELEMENT(base, j, size)) < 0) j--;
+			if (i >= j) break;
+			vec89_swap(VEC89_ELEMENT(base, i, size), VEC89_ELEMENT(base, j, size), size);
+			i++;
+			j--;
+		}
+		vec89_swap(base, VEC89_ELEMENT(base, j, size), size);
+
+		/* Recurse into the smaller side and loop on the larger one */
+		if (j < n - j - 1) {
+			vec89_introsort(base, j, size, compare, depth);
+			base = VEC89_ELEMENT(base, j + 1, size);
+			n -= j + 1;
+		} else {
+			vec89_introsort(VEC89_ELEMENT(base, j + 1, size), n - j - 1, size, compare, depth);
+			n = j;
+		}
+	}
+	vec89_insertion_sort(base, n, size, compare);
+}
+
+char VEC89_SORT_ARRAY(void *arr, size_t count, size_t elem_size, vec89_compare_function compare) {
+	if ((arr == NULL && count > 0) || elem_size == 0 || compare == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	vec89_introsort(arr, count, elem_size, compare, vec89_depth_limit(count));
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SORT(vec_p vec, vec89_compare_function compare) {
+	if (vec == NULL || compare == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	result = VEC89_DETACH(vec);
+	if (result != VEC89_SUCCESS) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	vec89_introsort((unsigned char *)vec->arr, vec->count, vec->elem_size, compare, vec89_depth_limit(vec->count));
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return VEC89_SUCCESS;
+}
+
+static size_t vec89_key_width(char key_type) {
+	switch (key_type) {
+		case VEC89_KEY_UINT8: case VEC89_KEY_INT8: return 1;
+		case VEC89_KEY_UINT16: case VEC89_KEY_INT16: return 2;
+		case VEC89_KEY_UINT32: case VEC89_KEY_INT32: case VEC89_KEY_FLOAT: return 4;
+		case VEC89_KEY_UINT64: case VEC89_KEY_INT64: case VEC89_KEY_DOUBLE: return 8;
+		default: return 0;
+	}
+}
+
+static char vec89_key_kind(char key_type) {
+	if (key_type == VEC89_KEY_FLOAT || key_type == VEC89_KEY_DOUBLE) return VEC89_KEY_KIND_FLOAT;
+	if (key_type >= VEC89_KEY_INT8) return VEC89_KEY_KIND_SIGNED;
+	return VEC89_KEY_KIND_UNSIGNED;
+}
+
+/*
+Byte pass (0 = least significant) of a key, transformed so unsigned byte order matches key order:
+signed keys get their sign bit flipped, negative floats get every bit flipped and positive floats their sign bit.
+*/
+VEC89_INLINE unsigned char vec89_key_byte(const unsigned char *key, size_t width, size_t pass, char kind, char little_endian) {
+	unsigned char byte = key[little_endian ? pass : width - 1 - pass];
+	if (kind == VEC89_KEY_KIND_FLOAT && (key[little_endian ? width - 1 : 0] & 0x80)) return (unsigned char)~byte;
+	if (kind != VEC89_KEY_KIND_UNSIGNED && pass == width - 1) return (unsigned char)(byte ^ 0x80);
+	return byte;
+}
+
+/*
+Stable LSD radix sort of count elements in source by the key at key_offset, destination is scratch space of the same size.
+Returns whichever array holds the result.
+*/
+static unsigned char *vec89_radix_sort(unsigned char *source, unsigned char *destination, size_t count, size_t size, size_t key_offset, char key_type) {
+	size_t width = vec89_key_width(key_type);
+	const unsigned short one = 1;
+	char little_endian = *(const unsigned char *)&one;
+	char kind = vec89_key_kind(key_type);
+
+	/* Every histogram is filled in a single pass over the keys */
+	size_t histogram[8][256];
+	memset(histogram, 0, sizeof(histogram[0]) * width);
+
+	size_t i, pass;
+	for (i = 0; i < count; i++) {
+		const unsigned char *key = VEC89_ELEMENT(source, i, size) + key_offset;
+		for (pass = 0; pass < width; pass++) histogram[pass][vec89_key_byte(key, width, pass, kind, little_endian)]++;
+	}
+
+	for (pass = 0; pass < width; pass++) {
+		size_t *offsets = histogram[pass];
+
+		/* A byte shared by every key doesn't reorder anything */
+		if (offsets[vec89_key_byte(source + key_offset, width, pass, kind, little_endian)] == count) continue;
+
+		size_t total = 0, bucket;
+		for (bucket = 0; bucket < 256; bucket++) {
+			size_t n = offsets[bucket];
+			offsets[bucket] = total;
+			total += n;
+		}
+
+		for (i = 0; i < count; i++) {
+			const unsigned char *element = VEC89_ELEMENT(source, i, size);
+			unsigned char byte = vec89_key_byte(element + key_offset, width, pass, kind, little_endian);
+			unsigned char *target = VEC89_ELEMENT(destination, offsets[byte]++, size);
+
+			/* Constant sizes let the copy compile to plain loads and stores */
+			switch (size) {
+				case 4: memcpy(target, element, 4); break;
+				case 8: memcpy(target, element, 8); break;
+				case 16: memcpy(target, element, 16); break;
+				default: memcpy(target, element, size); break;
+			}
+		}
+
+		unsigned char *swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	return source;
+}
+
+char VEC89_SORT_KEY(vec_p vec, size_t key_offset, char key_type) {
+	if (vec == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	size_t width = vec89_key_width(key_type);
+	if (width == 0 || key_offset > vec->elem_size || width > vec->elem_size - key_offset) return VEC89_INVALID_ARGUMENTS;
+
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	size_t count = vec->count, size = vec->elem_size;
+	if (count < 2) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_SUCCESS;
+	}
+	result = VEC89_DETACH(vec);
+	if (result != VEC89_SUCCESS) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	unsigned char *temp = vec89_algo_alloc(vec, count * size);
+	if (temp == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_MEMORY_ERROR;
+	}
+
+	if (vec89_radix_sort((unsigned char *)vec->arr, temp, count, size, key_offset, key_type) == temp) memcpy(vec->arr, temp, count * size);
+	vec89_algo_free(vec, temp, count * size);
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return VEC89_SUCCESS;
+}
+
+char VEC89_LOWER_BOUND(vec_p vec, const void *key, vec89_compare_function compare, size_t *out_idx) {
+	if (vec == NULL || compare == NULL || out_idx == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *arr;
+	size_t n;
+	char result = VEC89_READ_BEGIN(vec, &arr, &n);
+	if (result != VEC89_SUCCESS) return result;
+
+	/* The loop runs a fixed number of iterations for a given count and only selects between two bases */
+	const unsigned char *base = arr;
+	size_t size = vec->elem_size;
+	if (n > 0) {
+		while (n > 1) {
+			size_t half = n / 2;
+			base = compare(base + half * size, key) < 0 ? base + half * size : base;
+			n -= half;
+		}
+		if (compare(base, key) < 0) base += size;
+	}
+	*out_idx = (size_t)(base - (const unsigned char *)arr) / size;
+
+	VEC89_READ_END(vec);
+	return VEC89_SUCCESS;
+}
+
+char VEC89_UPPER_BOUND(vec_p vec, const void *key, vec89_compare_function compare, size_t *out_idx) {
+	if (vec == NULL || compare == NULL || out_idx == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *arr;
+	size_t n;
+	char result = VEC89_READ_BEGIN(vec, &arr, &n);
+	if (result != VEC89_SUCCESS) return result;
+
+	const unsigned char *base = arr;
+	size_t size = vec->elem_size;
+	if (n > 0) {
+		while (n > 1) {
+			size_t half = n / 2;
+			base = compare(base + half * size, key) <= 0 ? base + half * size : base;
+			n -= half;
+		}
+		if (compare(base, key) <= 0) base += size;
+	}
+	*out_idx = (size_t)(base - (const unsigned char *)arr) / size;
+
+	VEC89_READ_END(vec);
+	return VEC89_SUCCESS;
+}
+
+/* Scalar kernels, constant sizes let memcmp compile to a single compare */
+#define VEC89_SCALAR_EQUAL(a, b, size) \
+	((size) == 1 ? *(a) == *(b) : (size) == 2 ? memcmp(a, b, 2) == 0 : (size) == 4 ? memcmp(a, b, 4) == 0 \
+	: (size) == 8 ? memcmp(a, b, 8) == 0 : memcmp(a, b, size) == 0)
+
+static size_t vec89_find_scalar(const unsigned char *arr, size_t count, const unsigned char *element, size_t size) {
+	size_t i;
+	for (i = 0; i < count; i++) {
+		if (VEC89_SCALAR_EQUAL(arr + i * size, element, size)) return i;
+	}
+	return count;
+}
+
+static size_t vec89_count_scalar(const unsigned char *arr, size_t count, const unsigned char *element, size_t size) {
+	size_t i, matches = 0;
+	for (i = 0; i < count; i++) matches += VEC89_SCALAR_EQUAL(arr + i * size, element, size);
+	return matches;
+}
+
+/* Copies the element once, then doubles the filled prefix, so the copies are done by memcpy in large blocks */
+static void vec89_fill_scalar(unsigned char *arr, size_t count, const unsigned char *element, size_t size) {
+	if (count == 0) return;
+
+	size_t bytes = count * size, filled = size;
+	memcpy(arr, element, size);
+	while (filled < bytes) {
+		size_t n = min(filled, bytes - filled);
+		memcpy(arr + filled, arr, n);
+		filled += n;
+	}
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define VEC89_SIMD_X86
+#endif
+
+#ifdef VEC89_SIMD_X86
+#include <immintrin.h>
+
+#define VEC89_SIMD_NONE 0
+#define VEC89_SIMD_SSE2 1
+#define VEC89_SIMD_AVX2 2
+#define VEC89_SIMD_AVX512 3
+
+#define VEC89_SIMD_PATTERN_SIZE 64 /* Widest register, the pattern buffer of every kernel */
+
+#define VEC89_TARGET_SSE2 __attribute__((target("sse2")))
+#define VEC89_TARGET_AVX2 __attribute__((target("avx2")))
+#define VEC89_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+
+/* Checked once, racing threads store the same value */
+static int vec89_simd_level(void) {
+	static volatile int level = -1;
+	if (level < 0) {
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) level = VEC89_SIMD_AVX512;
+		else if (__builtin_cpu_supports("avx2")) level = VEC89_SIMD_AVX2;
+		else if (__builtin_cpu_supports("sse2")) level = VEC89_SIMD_SSE2;
+		else level = VEC89_SIMD_NONE;
+#ifdef VEC89_SIMD_LIMIT
+		if (level > VEC89_SIMD_LIMIT) level = VEC89_SIMD_LIMIT;
+#endif
+	}
+	return level;
+}
+
+/*
+Match masks of one register: every matching element sets as many consecutive bits as it covers mask bits.
+SSE2 and AVX2 have one bit per byte, AVX-512 one bit per compared lane.
+*/
+VEC89_TARGET_SSE2 VEC89_INLINE unsigned long long vec89_mask_sse2_1(__m128i a, __m128i b) { return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)); }
+VEC89_TARGET_SSE2 VEC89_INLINE unsigned long long vec89_mask_sse2_2(__m128i a, __m128i b) { return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)); }
+VEC89_TARGET_SSE2 VEC89_INLINE unsigned long long vec89_mask_sse2_4(__m128i a, __m128i b) { return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)); }
+VEC89_TARGET_SSE2 VEC89_INLINE unsigned long long vec89_mask_sse2_8(__m128i a, __m128i b) {
+	__m128i equal = _mm_cmpeq_epi32(a, b);
+	equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (unsigned)_mm_movemask_epi8(equal);
+}
+VEC89_TARGET_SSE2 VEC89_INLINE unsigned long long vec89_mask_sse2_16(__m128i a, __m128i b) {
+	__m128i equal = _mm_cmpeq_epi32(a, b);
+	equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+	equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(1, 0, 3, 2)));
+	return (unsigned)_mm_movemask_epi8(equal);
+}
+
+VEC89_TARGET_AVX2 VEC89_INLINE unsigned long long vec89_mask_avx2_1(__m256i a, __m256i b) { return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)); }
+VEC89_TARGET_AVX2 VEC89_INLINE unsigned long long vec89_mask_avx2_2(__m256i a, __m256i b) { return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)); }
+VEC89_TARGET_AVX2 VEC89_INLINE unsigned long long vec89_mask_avx2_4(__m256i a, __m256i b) { return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)); }
+VEC89_TARGET_AVX2 VEC89_INLINE unsigned long long vec89_mask_avx2_8(__m256i a, __m256i b) { return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b)); }
+VEC89_TARGET_AVX2 VEC89_INLINE unsigned long long vec89_mask_avx2_16(__m256i a, __m256i b) {
+	__m256i equal = _mm256_cmpeq_epi64(a, b);
+	equal = _mm256_and_si256(equal, _mm256_shuffle_epi32(equal, _MM_SHUFFLE(1, 0, 3, 2)));
+	return (unsigned)_mm256_movemask_epi8(equal);
+}
+
+VEC89_TARGET_AVX512 VEC89_INLINE unsigned long long vec89_mask_avx512_1(__m512i a, __m512i b) { return _mm512_cmpeq_epi8_mask(a, b); }
+VEC89_TARGET_AVX512 VEC89_INLINE unsigned long long vec89_mask_avx512_2(__m512i a, __m512i b) { return _mm512_cmpeq_epi16_mask(a, b); }
+VEC89_TARGET_AVX512 VEC89_INLINE unsigned long long vec89_mask_avx512_4(__m512i a, __m512i b) { return _mm512_cmpeq_epi32_mask(a, b); }
+VEC89_TARGET_AVX512 VEC89_INLINE unsigned long long vec89_mask_avx512_8(__m512i a, __m512i b) { return _mm512_cmpeq_epi64_mask(a, b); }
+VEC89_TARGET_AVX512 VEC89_INLINE unsigned long long vec89_mask_avx512_16(__m512i a, __m512i b) {
+	unsigned long long mask = _mm512_cmpeq_epi64_mask(a, b);
+	mask &= (mask >> 1) & 0x55;
+	return mask | (mask << 1);
+}
+
+#define VEC89_LOAD_SSE2(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define VEC89_LOAD_AVX2(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define VEC89_LOAD_AVX512(p) _mm512_loadu_si512((const void *)(p))
+#define VEC89_STORE_SSE2(p, v) _mm_storeu_si128((__m128i *)(void *)(p), v)
+#define VEC89_STORE_AVX2(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), v)
+#define VEC89_STORE_AVX512(p, v) _mm512_storeu_si512((void *)(p), v)
+
+/* The element repeated over a whole register */
+static void vec89_simd_pattern(unsigned char *pattern, const unsigned char *element, size_t size) {
+	size_t i;
+	for (i = 0; i < VEC89_SIMD_PATTERN_SIZE; i += size) memcpy(pattern + i, element, size);
+}
+
+#define VEC89_DEFINE_SIMD_KERNELS(isa, TARGET, VECTOR, LOAD, size, bits) \
+	static TARGET size_t vec89_find_##isa##_##size(const unsigned char *arr, size_t count, const unsigned char *element) { \
+		unsigned char buffer[VEC89_SIMD_PATTERN_SIZE]; \
+		vec89_simd_pattern(buffer, element, size); \
+		VECTOR pattern = LOAD(buffer); \
+		size_t bytes = count * size, offset = 0; \
+		for (; offset + sizeof(VECTOR) <= bytes; offset += sizeof(VECTOR)) { \
+			unsigned long long mask = vec89_mask_##isa##_##size(LOAD(arr + offset), pattern); \
+			if (mask != 0) return offset / size + (size_t)__builtin_ctzll(mask) / bits; \
+		} \
+		return offset / size + vec89_find_scalar(arr + offset, count - offset / size, element, size); \
+	} \
+	\
+	static TARGET size_t vec89_count_##isa##_##size(const unsigned char *arr, size_t count, const unsigned char *element) { \
+		unsigned char buffer[VEC89_SIMD_PATTERN_SIZE]; \
+		vec89_simd_pattern(buffer, element, size); \
+		VECTOR pattern = LOAD(buffer); \
+		size_t bytes = count * size, offset = 0, matched_bits = 0; \
+		for (; offset + sizeof(VECTOR) <= bytes; offset += sizeof(VECTOR)) { \
+			matched_bits += (size_t)__builtin_popcountll(vec89_mask_##isa##_##size(LOAD(arr + offset), pattern)); \
+		} \
+		return matched_bits / bits + vec89_count_scalar(arr + offset, count - offset / size, element, size); \
+	}
+
+#define VEC89_DEFINE_SIMD_FILL(isa, TARGET, VECTOR, LOAD, STORE) \
+	static TARGET void vec89_fill_##isa(unsigned char *arr, size_t count, const unsigned char *element, size_t size) { \
+		unsigned char buffer[VEC89_SIMD_PATTERN_SIZE]; \
+		vec89_simd_pattern(buffer, element, size); \
+		VECTOR pattern = LOAD(buffer); \
+		size_t bytes = count * size, offset = 0; \
+		for (; offset + sizeof(VECTOR) <= bytes; offset += sizeof(VECTOR)) STORE(arr + offset, pattern); \
+		memcpy(arr + offset, buffer, bytes - offset); \
+	}
+
+VEC89_DEFINE_SIMD_KERNELS(sse2, VEC89_TARGET_SSE2, __m128i, VEC89_LOAD_SSE2, 1, 1)
+VEC89_DEFINE_SIMD_KERNELS(sse2, VEC89_TARGET_SSE2, __m128i, VEC89_LOAD_SSE2, 2, 2)
+VEC89_DEFINE_SIMD_KERNELS(sse2, VEC89_TARGET_SSE2, __m128i, VEC89_LOAD_SSE2, 4, 4)
+VEC89_DEFINE_SIMD_KERNELS(sse2, VEC89_TARGET_SSE2, __m128i, VEC89_LOAD_SSE2, 8, 8)
+VEC89_DEFINE_SIMD_KERNELS(sse2, VEC89_TARGET_SSE2, __m128i, VEC89_LOAD_SSE2, 16, 16)
+VEC89_DEFINE_SIMD_KERNELS(avx2, VEC89_TARGET_AVX2, __m256i, VEC89_LOAD_AVX2, 1, 1)
+VEC89_DEFINE_SIMD_KERNELS(avx2, VEC89_TARGET_AVX2, __m256i, VEC89_LOAD_AVX2, 2, 2)
+VEC89_DEFINE_SIMD_KERNELS(avx2, VEC89_TARGET_AVX2, __m256i, VEC89_LOAD_AVX2, 4, 4)
+VEC89_DEFINE_SIMD_KERNELS(avx2, VEC89_TARGET_AVX2, __m256i, VEC89_LOAD_AVX2, 8, 8)
+VEC89_DEFINE_SIMD_KERNELS(avx2, VEC89_TARGET_AVX2, __m256i, VEC89_LOAD_AVX2, 16, 16)
+VEC89_DEFINE_SIMD_KERNELS(avx512, VEC89_TARGET_AVX512, __m512i, VEC89_LOAD_AVX512, 1, 1)
+VEC89_DEFINE_SIMD_KERNELS(avx512, VEC89_TARGET_AVX512, __m512i, VEC89_LOAD_AVX512, 2, 1)
+VEC89_DEFINE_SIMD_KERNELS(avx512, VEC89_TARGET_AVX512, __m512i, VEC89_LOAD_AVX512, 4, 1)
+VEC89_DEFINE_SIMD_KERNELS(avx512, VEC89_TARGET_AVX512, __m512i, VEC89_LOAD_AVX512, 8, 1)
+VEC89_DEFINE_SIMD_KERNELS(avx512, VEC89_TARGET_AVX512, __m512i, VEC89_LOAD_AVX512, 16, 2)
+
+VEC89_DEFINE_SIMD_FILL(sse2, VEC89_TARGET_SSE2, __m128i, VEC89_LOAD_SSE2, VEC89_STORE_SSE2)
+VEC89_DEFINE_SIMD_FILL(avx2, VEC89_TARGET_AVX2, __m256i, VEC89_LOAD_AVX2, VEC89_STORE_AVX2)
+VEC89_DEFINE_SIMD_FILL(avx512, VEC89_TARGET_AVX512, __m512i, VEC89_LOAD_AVX512, VEC89_STORE_AVX512)
+
+typedef size_t (*vec89_match_kernel)(const unsigned char *arr, size_t count, const unsigned char *element);
+
+/* Indexed by SIMD level - 1 and log2 of the element size */
+static const vec89_match_kernel vec89_find_kernels[3][5] = {
+	{ vec89_find_sse2_1, vec89_find_sse2_2, vec89_find_sse2_4, vec89_find_sse2_8, vec89_find_sse2_16 },
+	{ vec89_find_avx2_1, vec89_find_avx2_2, vec89_find_avx2_4, vec89_find_avx2_8, vec89_find_avx2_16 },
+	{ vec89_find_avx512_1, vec89_find_avx512_2, vec89_find_avx512_4, vec89_find_avx512_8, vec89_find_avx512_16 }
+};
+
+static const vec89_match_kernel vec89_count_kernels[3][5] = {
+	{ vec89_count_sse2_1, vec89_count_sse2_2, vec89_count_sse2_4, vec89_count_sse2_8, vec89_count_sse2_16 },
+	{ vec89_count_avx2_1, vec89_count_avx2_2, vec89_count_avx2_4, vec89_count_avx2_8, vec89_count_avx2_16 },
+	{ vec89_count_avx512_1, vec89_count_avx512_2, vec89_count_avx512_4, vec89_count_avx512_8, vec89_count_avx512_16 }
+};
+
+/* Kernel index of an element size, -1 for sizes without kernels */
+static int vec89_kernel_index(size_t size) {
+	switch (size) {
+		case 1: return 0;
+		case 2: return 1;
+		case 4: return 2;
+		case 8: return 3;
+		case 16: return 4;
+		default: return -1;
+	}
+}
+#endif
+
+static size_t vec89_find(const unsigned char *arr, size_t count, const unsigned char *element, size_t size) {
+#ifdef VEC89_SIMD_X86
+	int level = vec89_simd_level(), index = vec89_kernel_index(size);
+	if (level != VEC89_SIMD_NONE && index >= 0) return vec89_find_kernels[level - 1][index](arr, count, element);
+#endif
+	return vec89_find_scalar(arr, count, element, size);
+}
+
+static size_t vec89_count(const unsigned char *arr, size_t count, const unsigned char *element, size_t size) {
+#ifdef VEC89_SIMD_X86
+	int level = vec89_simd_level(), index = vec89_kernel_index(size);
+	if (level != VEC89_SIMD_NONE && index >= 0) return vec89_count_kernels[level - 1][index](arr, count, element);
+#endif
+	return vec89_count_scalar(arr, count, element, size);
+}
+
+static void vec89_fill(unsigned char *arr, size_t count, const unsigned char *element, size_t size) {
+	if (size == 1) {
+		memset(arr, *element, count);
+		return;
+	}
+#ifdef VEC89_SIMD_X86
+	/* A kernel stores one register of the pattern over and over, so the element has to divide the register */
+	switch (vec89_simd_level()) {
+		case VEC89_SIMD_AVX512:
+			if (sizeof(__m512i) % size != 0) break;
+			vec89_fill_avx512(arr, count, element, size);
+			return;
+		case VEC89_SIMD_AVX2:
+			if (sizeof(__m256i) % size != 0) break;
+			vec89_fill_avx2(arr, count, element, size);
+			return;
+		case VEC89_SIMD_SSE2:
+			if (sizeof(__m128i) % size != 0) break;
+			vec89_fill_sse2(arr, count, element, size);
+			return;
+		default: break;
+	}
+#endif
+	vec89_fill_scalar(arr, count, element, size);
+}
+
+char VEC89_FIND(vec_p vec, const void *element, size_t *out_idx) {
+	if (vec == NULL || element == NULL || out_idx == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *arr;
+	size_t count;
+	char result = VEC89_READ_BEGIN(vec, &arr, &count);
+	if (result != VEC89_SUCCESS) return result;
+
+	*out_idx = vec89_find(arr, count, element, vec->elem_size);
+
+	VEC89_READ_END(vec);
+	return VEC89_SUCCESS;
+}
+
+char VEC89_COUNT(vec_p vec, const void *element, size_t *out_count) {
+	if (vec == NULL || element == NULL || out_count == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *arr;
+	size_t count;
+	char result = VEC89_READ_BEGIN(vec, &arr, &count);
+	if (result != VEC89_SUCCESS) return result;
+
+	*out_count = vec89_count(arr, count, element, vec->elem_size);
+
+	VEC89_READ_END(vec);
+	return VEC89_SUCCESS;
+}
+
+char VEC89_FILL(vec_p vec, size_t idx, size_t n, const void *element) {
+	if (vec == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (idx > vec->count || n > vec->count - idx) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_ARRAY_OUT_OF_INDEX;
+	}
+	result = VEC89_DETACH(vec);
+	if (result != VEC89_SUCCESS) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	vec89_fill(VEC89_ELEMENT(vec->arr, idx, vec->elem_size), n, element, vec->elem_size);
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return VEC89_SUCCESS;
+}
+
+char VEC89_EQUAL(vec_p vec, vec_p other, char *out_equal) {
+	if (vec == NULL || other == NULL || out_equal == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *first_arr, *second_arr;
+	size_t first_count, second_count;
+	if (vec == other) {
+		*out_equal = 1;
+		return VEC89_SUCCESS;
+	}
+
+	/* Locked in address order, like VEC89_APPEND_VEC */
+	vec_p first = vec < other ? vec : other, second = vec < other ? other : vec;
+	char result = VEC89_READ_BEGIN(first, &first_arr, &first_count);
+	if (result != VEC89_SUCCESS) return result;
+	result = VEC89_READ_BEGIN(second, &second_arr, &second_count);
+	if (result != VEC89_SUCCESS) {
+		VEC89_READ_END(first);
+		return result;
+	}
+
+	/* The bytes are compared regardless of the element size, memcmp is already vectorized by the C library */
+	*out_equal = first->elem_size == second->elem_size && first_count == second_count
+		&& memcmp(first_arr, second_arr, first_count * first->elem_size) == 0;
+
+	VEC89_READ_END(second);
+	VEC89_READ_END(first);
+	return VEC89_SUCCESS;
+}
+
+/* Reads a key of type T without assuming the element is aligned for it */
+#define VEC89_KEY_COMPARE(T, a, b) do { \
+	T x, y; \
+	memcpy(&x, a, sizeof(T)); \
+	memcpy(&y, b, sizeof(T)); \
+	return (x > y) - (x < y); \
+} while (0)
+
+/* Floats compare by their bits transformed like vec89_key_byte does, so the order matches VEC89_SORT_KEY */
+#define VEC89_KEY_COMPARE_FLOAT(T, a, b) do { \
+	T x, y, sign = (T)1 << (sizeof(T) * 8 - 1); \
+	memcpy(&x, a, sizeof(T)); \
+	memcpy(&y, b, sizeof(T)); \
+	x = (x & sign) ? (T)~x : (T)(x | sign); \
+	y = (y & sign) ? (T)~y : (T)(y | sign); \
+	return (x > y) - (x < y); \
+} while (0)
+
+VEC89_INLINE int vec89_sorted_compare(const vec89_sorted *sorted, const void *a, const void *b) {
+	if (sorted->compare != NULL) return sorted->compare(a, b);
+
+	switch (sorted->key_type) {
+		case VEC89_KEY_UINT8: VEC89_KEY_COMPARE(uint8_t, a, b);
+		case VEC89_KEY_UINT16: VEC89_KEY_COMPARE(uint16_t, a, b);
+		case VEC89_KEY_UINT32: VEC89_KEY_COMPARE(uint32_t, a, b);
+		case VEC89_KEY_UINT64: VEC89_KEY_COMPARE(uint64_t, a, b);
+		case VEC89_KEY_INT8: VEC89_KEY_COMPARE(int8_t, a, b);
+		case VEC89_KEY_INT16: VEC89_KEY_COMPARE(int16_t, a, b);
+		case VEC89_KEY_INT32: VEC89_KEY_COMPARE(int32_t, a, b);
+		case VEC89_KEY_INT64: VEC89_KEY_COMPARE(int64_t, a, b);
+		case VEC89_KEY_FLOAT: VEC89_KEY_COMPARE_FLOAT(uint32_t, a, b);
+		default: VEC89_KEY_COMPARE_FLOAT(uint64_t, a, b);
+	}
+}
+
+/* Compares the keys of two elements */
+#define VEC89_SORTED_COMPARE(sorted, a, b) vec89_sorted_compare(sorted, (a) + (sorted)->key_offset, (b) + (sorted)->key_offset)
+
+/*
+Branchless binary search over n elements for the first element whose key is not less than key (upper = 0)
+or greater than key (upper = 1), as in VEC89_LOWER_BOUND.
+*/
+static size_t vec89_sorted_bound(const vec89_sorted *sorted, const void *arr, size_t n, const void *key, int upper) {
+	const unsigned char *base = arr;
+	size_t size = sorted->vec.elem_size, offset = sorted->key_offset;
+	if (n == 0) return 0;
+	while (n > 1) {
+		size_t half = n / 2;
+		base = vec89_sorted_compare(sorted, base + half * size + offset, key) < upper ? base + half * size : base;
+		n -= half;
+	}
+	if (vec89_sorted_compare(sorted, base + offset, key) < upper) base += size;
+	return (size_t)(base - (const unsigned char *)arr) / size;
+}
+
+VEC89_INLINE void vec89_sorted_copy(unsigned char *target, const unsigned char *source, size_t size) {
+	switch (size) {
+		case 4: memcpy(target, source, 4); break;
+		case 8: memcpy(target, source, 8); break;
+		case 16: memcpy(target, source, 16); break;
+		default: memcpy(target, source, size); break;
+	}
+}
+
+/*
+Stable bottom-up merge sort of n elements in source, using buffer as scratch space of the same size.
+Runs of VEC89_SORT_INSERTION_THRESHOLD elements are sorted by insertion first. Returns whichever array holds the result.
+*/
+static unsigned char *vec89_sorted_merge_sort(const vec89_sorted *sorted, unsigned char *source, unsigned char *buffer, size_t n) {
+	size_t size = sorted->vec.elem_size, begin, width;
+
+	for (begin = 0; begin < n; begin += VEC89_SORT_INSERTION_THRESHOLD) {
+		size_t end = min(begin + VEC89_SORT_INSERTION_THRESHOLD, n), i;
+		for (i = begin + 1; i < end; i++) {
+			size_t j = i;
+			while (j > begin && VEC89_SORTED_COMPARE(sorted, VEC89_ELEMENT(source, j - 1, size), VEC89_ELEMENT(source, j, size)) > 0) {
+				vec89_swap(VEC89_ELEMENT(source, j - 1, size), VEC89_ELEMENT(source, j, size), size);
+				j--;
+			}
+		}
+	}
+
+	for (width = VEC89_SORT_INSERTION_THRESHOLD; width < n; width *= 2) {
+		for (begin = 0; begin < n; begin += 2 * width) {
+			size_t middle = min(begin + width, n), end = min(begin + 2 * width, n);
+			size_t i = begin, j = middle, k = begin;
+
+			/* Already ordered pairs of runs are copied as they are */
+			if (middle == end || VEC89_SORTED_COMPARE(sorted, VEC89_ELEMENT(source, middle - 1, size), VEC89_ELEMENT(source, middle, size)) <= 0) {
+				memcpy(VEC89_ELEMENT(buffer, begin, size), VEC89_ELEMENT(source, begin, size), (end - begin) * size);
+				continue;
+			}
+			while (i < middle && j < end) {
+				if (VEC89_SORTED_COMPARE(sorted, VEC89_ELEMENT(source, j, size), VEC89_ELEMENT(source, i, size)) < 0) {
+					vec89_sorted_copy(VEC89_ELEMENT(buffer, k++, size), VEC89_ELEMENT(source, j++, size), size);
+				} else {
+					vec89_sorted_copy(VEC89_ELEMENT(buffer, k++, size), VEC89_ELEMENT(source, i++, size), size);
+				}
+			}
+			memcpy(VEC89_ELEMENT(buffer, k, size), VEC89_ELEMENT(source, i, size), (middle - i) * size);
+			k += middle - i;
+			memcpy(VEC89_ELEMENT(buffer, k, size), VEC89_ELEMENT(source, j, size), (end - j) * size);
+		}
+
+		unsigned char *swap = source;
+		source = buffer;
+		buffer = swap;
+	}
+	return source;
+}
+
+char VEC89_SORTED_INITIALIZATION(vec89_sorted_p sorted, size_t element_size, size_t key_offset, char key_type, vec89_compare_function compare, const vec89_allocator *allocator) {
+	if (sorted == NULL || element_size == 0 || key_offset >= element_size) return VEC89_INVALID_ARGUMENTS;
+	if (compare == NULL) {
+		size_t width = vec89_key_width(key_type);
+		if (width == 0 || width > element_size - key_offset) return VEC89_INVALID_ARGUMENTS;
+	}
+
+	char result = VEC89_INITIALIZATION_ALLOCATOR(&sorted->vec, element_size, allocator);
+	if (result != VEC89_SUCCESS) return result;
+
+	sorted->compare = compare;
+	sorted->key_offset = key_offset;
+	sorted->key_type = key_type;
+	return VEC89_SUCCESS;
+}
+
+void VEC89_SORTED_ARRAY_FREE(vec89_sorted_p sorted) {
+	if (sorted == NULL) return;
+	VEC89_ARRAY_FREE(&sorted->vec);
+}
+
+char VEC89_SORTED_FIND(vec89_sorted_p sorted, const void *key, size_t *out_idx) {
+	if (sorted == NULL || key == NULL || out_idx == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *arr;
+	size_t count;
+	char result = VEC89_READ_BEGIN(&sorted->vec, &arr, &count);
+	if (result != VEC89_SUCCESS) return result;
+
+	size_t idx = vec89_sorted_bound(sorted, arr, count, key, 0);
+	if (idx < count && vec89_sorted_compare(sorted, VEC89_ELEMENT(arr, idx, sorted->vec.elem_size) + sorted->key_offset, key) != 0) idx = count;
+	*out_idx = idx;
+
+	VEC89_READ_END(&sorted->vec);
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SORTED_EQUAL_RANGE(vec89_sorted_p sorted, const void *key, size_t *out_begin, size_t *out_end) {
+	if (sorted == NULL || key == NULL || out_begin == NULL || out_end == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *arr;
+	size_t count;
+	char result = VEC89_READ_BEGIN(&sorted->vec, &arr, &count);
+	if (result != VEC89_SUCCESS) return result;
+
+	/* The upper bound can only follow the lower bound */
+	size_t begin = vec89_sorted_bound(sorted, arr, count, key, 0);
+	*out_begin = begin;
+	*out_end = begin + vec89_sorted_bound(sorted, VEC89_ELEMENT(arr, begin, sorted->vec.elem_size), count - begin, key, 1);
+
+	VEC89_READ_END(&sorted->vec);
+	return VEC89_SUCCESS;
+}
+
+char VEC89_SORTED_INSERT_UNIQUE(vec89_sorted_p sorted, const void *element, char *out_inserted) {
+	if (sorted == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	vec_p vec = &sorted->vec;
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	const unsigned char *key = (const unsigned char *)element + sorted->key_offset;
+	size_t idx = vec89_sorted_bound(sorted, vec->arr, vec->count, key, 0);
+	char inserted = idx == vec->count || vec89_sorted_compare(sorted, VEC89_ELEMENT(vec->arr, idx, vec->elem_size) + sorted->key_offset, key) != 0;
+	if (inserted) result = VEC89_INSERT(vec, idx, element);
+	if (out_inserted != NULL) *out_inserted = result == VEC89_SUCCESS && inserted;
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return result;
+}
+
+char VEC89_SORTED_INSERT_MULTI(vec89_sorted_p sorted, const void *element) {
+	if (sorted == NULL || element == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	vec_p vec = &sorted->vec;
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	size_t idx = vec89_sorted_bound(sorted, vec->arr, vec->count, (const unsigned char *)element + sorted->key_offset, 1);
+	result = VEC89_INSERT(vec, idx, element);
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return result;
+}
+
+char VEC89_SORTED_ERASE(vec89_sorted_p sorted, const void *key, size_t *out_removed) {
+	if (sorted == NULL || key == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	vec_p vec = &sorted->vec;
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+
+	size_t begin = vec89_sorted_bound(sorted, vec->arr, vec->count, key, 0);
+	size_t n = vec89_sorted_bound(sorted, VEC89_ELEMENT(vec->arr, begin, vec->elem_size), vec->count - begin, key, 1);
+	if (n > 0) result = VEC89_REMOVE_RANGE(vec, begin, n);
+	if (out_removed != NULL) *out_removed = result == VEC89_SUCCESS ? n : 0;
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return result;
+}
+
+char VEC89_SORTED_MERGE(vec89_sorted_p sorted, const void *elements, size_t n, char unique, size_t *out_inserted) {
+	if (sorted == NULL || (elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+
+	vec_p vec = &sorted->vec;
+	size_t size = vec->elem_size, offset = sorted->key_offset, temp_size;
+	if (out_inserted != NULL) *out_inserted = 0;
+	if (n > VEC89_SIZE_MAX / 2 / size) return VEC89_MEMORY_ERROR;
+	temp_size = 2 * n * size;
+
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	if (n == 0) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_SUCCESS;
+	}
+
+	unsigned char *temp = vec89_algo_alloc(vec, temp_size);
+	if (temp == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_MEMORY_ERROR;
+	}
+	memcpy(temp, elements, n * size);
+	unsigned char *batch = sorted->compare == NULL && n >= VEC89_SORTED_RADIX_THRESHOLD
+		? vec89_radix_sort(temp, temp + n * size, n, size, offset, sorted->key_type)
+		: vec89_sorted_merge_sort(sorted, temp, temp + n * size, n);
+
+	if (unique) {
+		/* Drops repeated keys and keys already present, the batch is sorted so each search starts at the previous one */
+		size_t i, kept = 0, start = 0;
+		for (i = 0; i < n; i++) {
+			const unsigned char *element = VEC89_ELEMENT(batch, i, size);
+			if (kept > 0 && VEC89_SORTED_COMPARE(sorted, VEC89_ELEMENT(batch, kept - 1, size), element) == 0) continue;
+
+			start += vec89_sorted_bound(sorted, VEC89_ELEMENT(vec->arr, start, size), vec->count - start, element + offset, 0);
+			if (start < vec->count && VEC89_SORTED_COMPARE(sorted, VEC89_ELEMENT(vec->arr, start, size), element) == 0) continue;
+
+			if (kept != i) vec89_sorted_copy(VEC89_ELEMENT(batch, kept, size), element, size);
+			kept++;
+		}
+		n = kept;
+	}
+
+	/* Grows the array once through the growth policy, the copied elements are overwritten by the merge */
+	size_t i = vec->count;
+	result = n > 0 ? VEC89_PUSH_N(vec, batch, n) : VEC89_SUCCESS;
+	if (result != VEC89_SUCCESS) {
+		vec89_algo_free(vec, temp, temp_size);
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	/*
+	Merges from the back: every batch element finds its place among the remaining existing elements with a binary search,
+	the existing elements after it move up with one memmove, and elements before the first insertion point never move.
+	*/
+	unsigned char *arr = (unsigned char *)vec->arr;
+	size_t j = n;
+	while (j > 0 && i > 0) {
+		const unsigned char *element = VEC89_ELEMENT(batch, j - 1, size);
+		size_t idx = vec89_sorted_bound(sorted, arr, i, element + offset, 1);
+		if (idx < i) memmove(VEC89_ELEMENT(arr, idx + j, size), VEC89_ELEMENT(arr, idx, size), (i - idx) * size);
+		vec89_sorted_copy(VEC89_ELEMENT(arr, idx + j - 1, size), element, size);
+		i = idx;
+		j--;
+	}
+	if (j > 0) memcpy(arr, batch, j * size);
+
+	vec89_algo_free(vec, temp, temp_size);
+	if (out_inserted != NULL) *out_inserted = n;
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return VEC89_SUCCESS;
+}
\ No newline at end of file
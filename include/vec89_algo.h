@@ -0,0 +1,410 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#ifndef VEC89_ALGO_H
+#define VEC89_ALGO_H
+
+#include "vec89.h"
+#include "vec89_typed.h"
+
+/*
+Define this as 0 (no SIMD), 1 (SSE2) or 2 (AVX2) to cap the x86 kernels VEC89_FIND, VEC89_COUNT and VEC89_FILL pick at runtime,
+so the narrower kernels can be tested and timed on a CPU with wider registers.
+#define VEC89_SIMD_LIMIT 2
+*/
+
+#define VEC89_SORT_INSERTION_THRESHOLD 16 /* Ranges of at most this many elements are finished with insertion sort */
+
+/* Key types for VEC89_SORT_KEY, keys are read in the byte order of the machine */
+#define VEC89_KEY_UINT8 0
+#define VEC89_KEY_UINT16 1
+#define VEC89_KEY_UINT32 2
+#define VEC89_KEY_UINT64 3
+#define VEC89_KEY_INT8 4
+#define VEC89_KEY_INT16 5
+#define VEC89_KEY_INT32 6
+#define VEC89_KEY_INT64 7
+#define VEC89_KEY_FLOAT 8  /* IEEE 754 binary32, -0.0 sorts before 0.0, NaNs sort by their bits at either end */
+#define VEC89_KEY_DOUBLE 9 /* IEEE 754 binary64, same ordering as VEC89_KEY_FLOAT */
+
+/* qsort compatible comparator, returns <0, 0 or >0 */
+typedef int (*vec89_compare_function)(const void *a, const void *b);
+
+/* Sorted vector, a flat set or map kept in ascending key order in one contiguous array */
+typedef struct VEC89_SORTED {
+	vec89 vec;						/* Elements, read with the VEC89_* read functions but only written through VEC89_SORTED_* */
+	vec89_compare_function compare; /* Comparator of two keys, NULL to order by key_type */
+	size_t key_offset;				/* Byte offset of the key inside an element */
+	char key_type;					/* One of the VEC89_KEY_* types, used when compare is NULL */
+} vec89_sorted, *vec89_sorted_p;
+
+#ifdef VEC89_FUNCTION_MACROS
+	#define vec_sort(vec_obj, compare) VEC89_SORT(&vec_obj, compare)
+	#define vec_sort_key(vec_obj, key_offset, key_type) VEC89_SORT_KEY(&vec_obj, key_offset, key_type)
+	#define vec_lower_bound(vec_obj, key, compare, out_idx_ptr) VEC89_LOWER_BOUND(&vec_obj, key, compare, out_idx_ptr)
+	#define vec_upper_bound(vec_obj, key, compare, out_idx_ptr) VEC89_UPPER_BOUND(&vec_obj, key, compare, out_idx_ptr)
+	#define vec_find(vec_obj, element, out_idx_ptr) VEC89_FIND(&vec_obj, element, out_idx_ptr)
+	#define vec_count(vec_obj, element, out_count_ptr) VEC89_COUNT(&vec_obj, element, out_count_ptr)
+	#define vec_fill(vec_obj, idx, n, element) VEC89_FILL(&vec_obj, idx, n, element)
+	#define vec_equal(vec_obj, other_obj, out_equal_ptr) VEC89_EQUAL(&vec_obj, &other_obj, out_equal_ptr)
+
+	#define vec_sorted_init(sorted_obj, element_size, key_offset, key_type, compare, allocator_ptr) VEC89_SORTED_INITIALIZATION(&sorted_obj, element_size, key_offset, key_type, compare, allocator_ptr)
+	#define vec_sorted_array_free(sorted_obj) VEC89_SORTED_ARRAY_FREE(&sorted_obj)
+	#define vec_sorted_find(sorted_obj, key, out_idx_ptr) VEC89_SORTED_FIND(&sorted_obj, key, out_idx_ptr)
+	#define vec_sorted_equal_range(sorted_obj, key, out_begin_ptr, out_end_ptr) VEC89_SORTED_EQUAL_RANGE(&sorted_obj, key, out_begin_ptr, out_end_ptr)
+	#define vec_sorted_insert_unique(sorted_obj, element, out_inserted_ptr) VEC89_SORTED_INSERT_UNIQUE(&sorted_obj, element, out_inserted_ptr)
+	#define vec_sorted_insert_multi(sorted_obj, element) VEC89_SORTED_INSERT_MULTI(&sorted_obj, element)
+	#define vec_sorted_erase(sorted_obj, key, out_removed_ptr) VEC89_SORTED_ERASE(&sorted_obj, key, out_removed_ptr)
+	#define vec_sorted_merge(sorted_obj, elements, n, unique, out_inserted_ptr) VEC89_SORTED_MERGE(&sorted_obj, elements, n, unique, out_inserted_ptr)
+#endif
+
+/*
+Sorts the vector with an introsort (median of three quicksort, heapsort once the recursion gets too deep, insertion sort
+for small ranges). Not stable. The comparator is called with the vector locked.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_compare_function compare: Comparator of two elements. (compare != NULL)
+*/
+char VEC89_SORT(vec_p vec, vec89_compare_function compare);
+
+/*
+VEC89_SORT for a plain array that isn't owned by a vector, nothing is locked.
+Returns 0 on success, non-zero error codes on failure.
+
+*void *arr: Pointer to the first element. (arr != NULL if count > 0)
+*size_t count: Number of elements.
+*size_t elem_size: Size of a single element in bytes. (elem_size > 0)
+*vec89_compare_function compare: Comparator of two elements. (compare != NULL)
+*/
+char VEC89_SORT_ARRAY(void *arr, size_t count, size_t elem_size, vec89_compare_function compare);
+
+/*
+Sorts the vector by a fixed-width integer or floating point key stored inside each element, using an LSD radix sort.
+One histogram pass counts every key byte, then one stable scatter pass runs per key byte, skipping bytes that are
+equal in every element. Needs a temporary array as large as the elements, taken from the vector's allocator. Stable.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t key_offset: Byte offset of the key inside an element. (key_offset + key width <= vec->elem_size)
+*char key_type: One of the VEC89_KEY_* types.
+*/
+char VEC89_SORT_KEY(vec_p vec, size_t key_offset, char key_type);
+
+/*
+Finds the first element that isn't less than key in a vector sorted by compare, with a branchless binary search.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const void *key: Key passed as the second argument of compare.
+*vec89_compare_function compare: Comparator of an element and the key. (compare != NULL)
+*size_t *out_idx: Pointer receiving the index, count if every element is less than key. (out_idx != NULL)
+*/
+char VEC89_LOWER_BOUND(vec_p vec, const void *key, vec89_compare_function compare, size_t *out_idx);
+
+/*
+Finds the first element that is greater than key in a vector sorted by compare, with a branchless binary search.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const void *key: Key passed as the second argument of compare.
+*vec89_compare_function compare: Comparator of an element and the key. (compare != NULL)
+*size_t *out_idx: Pointer receiving the index, count if no element is greater than key. (out_idx != NULL)
+*/
+char VEC89_UPPER_BOUND(vec_p vec, const void *key, vec89_compare_function compare, size_t *out_idx);
+
+/*
+Finds the first element whose bytes equal element's. Elements of 1, 2, 4, 8 and 16 bytes are compared with SSE2, AVX2 or
+AVX-512 kernels picked at runtime on x86 GCC/Clang builds, other sizes and targets compare element by element.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const void *element: Pointer to the element searched for. (element != NULL)
+*size_t *out_idx: Pointer receiving the index, count if no element matches. (out_idx != NULL)
+*/
+char VEC89_FIND(vec_p vec, const void *element, size_t *out_idx);
+
+/*
+Counts the elements whose bytes equal element's, with the same kernels as VEC89_FIND.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*const void *element: Pointer to the element counted. (element != NULL)
+*size_t *out_count: Pointer receiving the number of matches. (out_count != NULL)
+*/
+char VEC89_COUNT(vec_p vec, const void *element, size_t *out_count);
+
+/*
+Overwrites n elements starting at idx with copies of element. Sizes dividing the register width of the picked kernel,
+64 bytes for AVX-512, 32 for AVX2 and 16 for SSE2, are stored a register at a time.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*size_t idx: Index of the first overwritten element. (idx + n <= vec->count)
+*size_t n: Number of overwritten elements.
+*const void *element: Pointer to the element copied. (element != NULL)
+*/
+char VEC89_FILL(vec_p vec, size_t idx, size_t n, const void *element);
+
+/*
+Checks whether two vectors hold the same number of elements of the same size with identical bytes.
+Padding bytes take part in the comparison and floating point values compare by their bits.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec_p vec: Pointer to the first vector. (vec != NULL)
+*vec_p other: Pointer to the second vector. (other != NULL)
+*char *out_equal: Pointer receiving 1 if the vectors are equal, 0 otherwise. (out_equal != NULL)
+*/
+char VEC89_EQUAL(vec_p vec, vec_p other, char *out_equal);
+
+/*
+Initializes an empty sorted vector. Keys are ordered by compare, which is called with pointers to two keys, or by
+key_type when compare is NULL, with the same order as VEC89_SORT_KEY. Functions taking a key expect a pointer to a key,
+not to an element.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector. (sorted != NULL)
+*size_t element_size: Size of a single element in bytes. (element_size > 0)
+*size_t key_offset: Byte offset of the key inside an element. (key_offset < element_size, key_offset + key width <= element_size)
+*char key_type: One of the VEC89_KEY_* types, ignored when compare isn't NULL.
+*vec89_compare_function compare: Comparator of two keys, NULL to order by key_type.
+*const vec89_allocator *allocator: Pointer to an allocator, NULL for the default allocator.
+*/
+char VEC89_SORTED_INITIALIZATION(vec89_sorted_p sorted, size_t element_size, size_t key_offset, char key_type, vec89_compare_function compare, const vec89_allocator *allocator);
+
+/*
+Frees the elements of the sorted vector.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector.
+*/
+void VEC89_SORTED_ARRAY_FREE(vec89_sorted_p sorted);
+
+/*
+Finds an element with the given key in O(log n).
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector. (sorted != NULL)
+*const void *key: Pointer to the key. (key != NULL)
+*size_t *out_idx: Pointer receiving the index of the first element with the key, count if there is none. (out_idx != NULL)
+*/
+char VEC89_SORTED_FIND(vec89_sorted_p sorted, const void *key, size_t *out_idx);
+
+/*
+Finds the range of elements with the given key in O(log n), the elements in [begin, end) can then be scanned in place.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector. (sorted != NULL)
+*const void *key: Pointer to the key. (key != NULL)
+*size_t *out_begin: Pointer receiving the index of the first element that isn't less than key. (out_begin != NULL)
+*size_t *out_end: Pointer receiving the index of the first element greater than key. (out_end != NULL)
+*/
+char VEC89_SORTED_EQUAL_RANGE(vec89_sorted_p sorted, const void *key, size_t *out_begin, size_t *out_end);
+
+/*
+Inserts an element unless an element with the same key already exists, the existing element is left unchanged.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector. (sorted != NULL)
+*const void *element: Pointer to the element. (element != NULL)
+*char *out_inserted: Pointer receiving 1 if the element was inserted and 0 if its key was present, can be NULL.
+*/
+char VEC89_SORTED_INSERT_UNIQUE(vec89_sorted_p sorted, const void *element, char *out_inserted);
+
+/*
+Inserts an element after every element with the same key.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector. (sorted != NULL)
+*const void *element: Pointer to the element. (element != NULL)
+*/
+char VEC89_SORTED_INSERT_MULTI(vec89_sorted_p sorted, const void *element);
+
+/*
+Removes every element with the given key with a single move of the elements after them.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector. (sorted != NULL)
+*const void *key: Pointer to the key. (key != NULL)
+*size_t *out_removed: Pointer receiving the number of removed elements, can be NULL.
+*/
+char VEC89_SORTED_ERASE(vec89_sorted_p sorted, const void *key, size_t *out_removed);
+
+/*
+Inserts a batch of unsorted elements. The batch is copied and sorted with a stable radix sort for key_type keys or a stable
+merge sort, the array grows at most once and the batch is merged in from the back, so every existing element moves at most once. Equal keys keep the batch order
+and follow existing elements with the same key. With unique set, batch elements whose key is already present or appears
+earlier in the batch are dropped. Needs a temporary array twice as large as the batch, taken from the vector's allocator.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_sorted_p sorted: Pointer to the sorted vector. (sorted != NULL)
+*const void *elements: Pointer to n elements. (elements != NULL if n > 0)
+*size_t n: Number of elements.
+*char unique: Non-zero to keep keys unique like VEC89_SORTED_INSERT_UNIQUE, zero to insert like VEC89_SORTED_INSERT_MULTI.
+*size_t *out_inserted: Pointer receiving the number of inserted elements, can be NULL.
+*/
+char VEC89_SORTED_MERGE(vec89_sorted_p sorted, const void *elements, size_t n, char unique, size_t *out_inserted);
+
+/*
+Generates sorting and searching for a vector type generated by VEC89_DEFINE(name, T). LESS(a, b) is a function or macro
+taking two T values and returning non-zero if a orders before b, it's inlined into the generated code.
+
+VEC89_DEFINE_SORT(int_vec, int, INT_LESS) generates:
+	char int_vec_sort(int_vec *v)                                   Introsort ordered by LESS, not stable
+	char int_vec_lower_bound(int_vec *v, int key, size_t *out_idx)  First element not less than key
+	char int_vec_upper_bound(int_vec *v, int key, size_t *out_idx)  First element greater than key
+All functions use the VEC89_* return codes.
+*/
+#define VEC89_DEFINE_SORT(name, T, LESS) \
+	VEC89_INLINE void name##_insertion_sort(T *data, size_t n) { \
+		size_t i; \
+		for (i = 1; i < n; i++) { \
+			T value = data[i]; \
+			size_t j = i; \
+			while (j > 0 && LESS(value, data[j - 1])) { \
+				data[j] = data[j - 1]; \
+				j--; \
+			} \
+			data[j] = value; \
+		} \
+	} \
+	\
+	VEC89_INLINE void name##_sift_down(T *data, size_t root, size_t n) { \
+		T value = data[root]; \
+		size_t child; \
+		while ((child = 2 * root + 1) < n) { \
+			if (child + 1 < n && LESS(data[child], data[child + 1])) child++; \
+			if (!LESS(value, data[child])) break; \
+			data[root] = data[child]; \
+			root = child; \
+		} \
+		data[root] = value; \
+	} \
+	\
+	VEC89_INLINE void name##_introsort(T *data, size_t n, size_t depth) { \
+		T temp; \
+		while (n > VEC89_SORT_INSERTION_THRESHOLD) { \
+			if (depth-- == 0) { \
+				size_t i; \
+				for (i = n / 2; i-- > 0;) name##_sift_down(data, i, n); \
+				for (i = n - 1; i > 0; i--) { \
+					temp = data[0]; data[0] = data[i]; data[i] = temp; \
+					name##_sift_down(data, 0, i); \
+				} \
+				return; \
+			} \
+			\
+			/* Median of three moved to the front, the last element then bounds the left scan */ \
+			T *middle = data + n / 2, *last = data + n - 1; \
+			if (LESS(*middle, *data)) { temp = *middle; *middle = *data; *data = temp; } \
+			if (LESS(*last, *middle)) { \
+				temp = *last; *last = *middle; *middle = temp; \
+				if (LESS(*middle, *data)) { temp = *middle; *middle = *data; *data = temp; } \
+			} \
+			temp = *middle; *middle = *data; *data = temp; \
+			\
+			T pivot = data[0]; \
+			size_t i = 1, j = n - 1; \
+			for (;;) { \
+				while (LESS(data[i], pivot)) i++; \
+				while (LESS(pivot, data[j])) j--; \
+				if (i >= j) break; \
+				temp = data[i]; data[i] = data[j]; data[j] = temp; \
+				i++; \
+				j--; \
+			} \
+			data[0] = data[j]; \
+			data[j] = pivot; \
+			\
+			/* Recurse into the smaller side and loop on the larger one */ \
+			if (j < n - j - 1) { \
+				name##_introsort(data, j, depth); \
+				data += j + 1; \
+				n -= j + 1; \
+			} else { \
+				name##_introsort(data + j + 1, n - j - 1, depth); \
+				n = j; \
+			} \
+		} \
+		name##_insertion_sort(data, n); \
+	} \
+	\
+	VEC89_INLINE char name##_sort(name *v) { \
+		char result = VEC89_LOCK_SCOPE_BEGIN(&v->base); \
+		if (result != VEC89_SUCCESS) return result; \
+		/* Sorting writes every element, an array shared with clones or snapshots is copied first */ \
+		if (v->base.arr == NULL) result = VEC89_INVALID_ARGUMENTS; \
+		else if (VEC89_TYPED_SHARED(v)) result = VEC89_DETACH(&v->base); \
+		if (result == VEC89_SUCCESS) { \
+			size_t depth = 0, n = v->base.count; \
+			while (n >>= 1) depth += 2; \
+			name##_introsort((T *)v->base.arr, v->base.count, depth); \
+		} \
+		VEC89_LOCK_SCOPE_END(&v->base); \
+		return result; \
+	} \
+	\
+	VEC89_INLINE char name##_lower_bound(name *v, T key, size_t *out_idx) { \
+		VEC89_TYPED_READ_LOCK(v); \
+		if (v->base.arr == NULL) { \
+			VEC89_TYPED_READ_UNLOCK(v); \
+			return VEC89_INVALID_ARGUMENTS; \
+		} \
+		const T *data = (const T *)v->base.arr, *base = data; \
+		size_t n = v->base.count; \
+		if (n > 0) { \
+			while (n > 1) { \
+				size_t half = n / 2; \
+				base = LESS(base[half], key) ? base + half : base; \
+				n -= half; \
+			} \
+			base += LESS(*base, key) ? 1 : 0; \
+		} \
+		*out_idx = (size_t)(base - data); \
+		VEC89_TYPED_READ_UNLOCK(v); \
+		return VEC89_SUCCESS; \
+	} \
+	\
+	VEC89_INLINE char name##_upper_bound(name *v, T key, size_t *out_idx) { \
+		VEC89_TYPED_READ_LOCK(v); \
+		if (v->base.arr == NULL) { \
+			VEC89_TYPED_READ_UNLOCK(v); \
+			return VEC89_INVALID_ARGUMENTS; \
+		} \
+		const T *data = (const T *)v->base.arr, *base = data; \
+		size_t n = v->base.count; \
+		if (n > 0) { \
+			while (n > 1) { \
+				size_t half = n / 2; \
+				base = LESS(key, base[half]) ? base : base + half; \
+				n -= half; \
+			} \
+			base += LESS(key, *base) ? 0 : 1; \
+		} \
+		*out_idx = (size_t)(base - data); \
+		VEC89_TYPED_READ_UNLOCK(v); \
+		return VEC89_SUCCESS; \
+	}
+
+#endif /* VEC89_ALGO_H */
@@ -0,0 +1,274 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#include "vec89_alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define min(a, b) ((a) > (b) ? (b) : (a))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+#define MALLOC_FUNCTION(Size) malloc(Size)
+#define REALLOC_FUNCTION(Block, Size) realloc(Block, Size)
+#define FREE_FUNCTION(Block) free(Block)
+
+#define VEC89_SIZE_MAX ((size_t)-1)
+#define VEC89_ALIGN_UP(Size) (((Size) + (VEC89_ALLOC_ALIGNMENT - 1)) & ~(size_t)(VEC89_ALLOC_ALIGNMENT - 1))
+
+struct VEC89_ARENA_BLOCK {
+	struct VEC89_ARENA_BLOCK *next; /* Previous block */
+	size_t size;					/* Usable bytes */
+	size_t used;					/* Used bytes */
+};
+
+struct VEC89_POOL_SLAB {
+	struct VEC89_POOL_SLAB *next;
+};
+
+#define VEC89_ARENA_HEADER_SIZE VEC89_ALIGN_UP(sizeof(struct VEC89_ARENA_BLOCK))
+#define VEC89_ARENA_DATA(block) ((char *)(block) + VEC89_ARENA_HEADER_SIZE)
+
+#define VEC89_POOL_HEADER_SIZE VEC89_ALIGN_UP(sizeof(struct VEC89_POOL_SLAB))
+#define VEC89_POOL_MAX_CLASS_SIZE ((size_t)VEC89_POOL_MIN_CLASS_SIZE << (VEC89_POOL_CLASS_COUNT - 1))
+
+static void *vec89_arena_alloc(void *context, size_t size) {
+	vec89_arena_p arena = context;
+	struct VEC89_ARENA_BLOCK *block = arena->head;
+
+	if (size > VEC89_SIZE_MAX - VEC89_ARENA_HEADER_SIZE - VEC89_ALLOC_ALIGNMENT) return NULL;
+	size = VEC89_ALIGN_UP(max(size, 1));
+
+	if (block == NULL || block->size - block->used < size) {
+		size_t block_size = max(arena->block_size, size);
+
+		block = MALLOC_FUNCTION(VEC89_ARENA_HEADER_SIZE + block_size);
+		if (block == NULL) return NULL;
+		arena->system_allocations++;
+
+		block->next = arena->head;
+		block->size = block_size;
+		block->used = 0;
+		arena->head = block;
+	}
+
+	arena->last = VEC89_ARENA_DATA(block) + block->used;
+	block->used += size;
+
+	return arena->last;
+}
+
+static void *vec89_arena_realloc(void *context, void *block, size_t old_size, size_t new_size) {
+	vec89_arena_p arena = context;
+
+	if (block == NULL) return vec89_arena_alloc(context, new_size);
+
+	/* The most recent allocation owns the rest of the current block, grow or shrink it in place */
+	if (block == arena->last && new_size <= VEC89_SIZE_MAX - VEC89_ALLOC_ALIGNMENT) {
+		struct VEC89_ARENA_BLOCK *head = arena->head;
+		size_t offset = (size_t)(arena->last - VEC89_ARENA_DATA(head));
+		size_t size = VEC89_ALIGN_UP(max(new_size, 1));
+
+		if (size <= head->size - offset) {
+			head->used = offset + size;
+			return block;
+		}
+	}
+
+	void *new_block = vec89_arena_alloc(context, new_size);
+	if (new_block == NULL) return NULL;
+
+	memcpy(new_block, block, min(old_size, new_size));
+	return new_block;
+}
+
+static void vec89_arena_free(void *context, void *block, size_t size) {
+	vec89_arena_p arena = context;
+	(void)size;
+
+	if (block != NULL && block == arena->last) {
+		arena->head->used = (size_t)(arena->last - VEC89_ARENA_DATA(arena->head));
+		arena->last = NULL;
+	}
+}
+
+char VEC89_ARENA_INITIALIZATION(vec89_arena_p arena, size_t block_size) {
+	if (arena == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	arena->head = NULL;
+	arena->last = NULL;
+	arena->block_size = block_size > 0 ? block_size : VEC89_ARENA_DEFAULT_BLOCK_SIZE;
+	arena->system_allocations = 0;
+
+	arena->allocator.alloc_function = vec89_arena_alloc;
+	arena->allocator.realloc_function = vec89_arena_realloc;
+	arena->allocator.free_function = vec89_arena_free;
+	arena->allocator.context = arena;
+
+	return VEC89_SUCCESS;
+}
+
+void VEC89_ARENA_RESET(vec89_arena_p arena) {
+	if (arena == NULL || arena->head == NULL) return;
+
+	struct VEC89_ARENA_BLOCK *block = arena->head->next;
+	while (block != NULL) {
+		struct VEC89_ARENA_BLOCK *next = block->next;
+		FREE_FUNCTION(block);
+		block = next;
+	}
+
+	arena->head->next = NULL;
+	arena->head->used = 0;
+	arena->last = NULL;
+}
+
+void VEC89_ARENA_DESTROY(vec89_arena_p arena) {
+	if (arena == NULL) return;
+
+	struct VEC89_ARENA_BLOCK *block = arena->head;
+	while (block != NULL) {
+		struct VEC89_ARENA_BLOCK *next = block->next;
+		FREE_FUNCTION(block);
+		block = next;
+	}
+
+	arena->head = NULL;
+	arena->last = NULL;
+}
+
+/* Returns the class index of size, VEC89_POOL_CLASS_COUNT if it is larger than the biggest class */
+static size_t vec89_pool_class(size_t size) {
+	size_t class_size = VEC89_POOL_MIN_CLASS_SIZE;
+	size_t i;
+	for (i = 0; i < VEC89_POOL_CLASS_COUNT; i++) {
+		if (size <= class_size) return i;
+		class_size <<= 1;
+	}
+	return VEC89_POOL_CLASS_COUNT;
+}
+
+static void *vec89_pool_alloc(void *context, size_t size) {
+	vec89_pool_p pool = context;
+	size_t class_index = vec89_pool_class(size);
+
+	if (class_index == VEC89_POOL_CLASS_COUNT) {
+		void *large_block = MALLOC_FUNCTION(size);
+		if (large_block != NULL) pool->system_allocations++;
+		return large_block;
+	}
+
+	if (pool->free_lists[class_index] == NULL) {
+		size_t class_size = (size_t)VEC89_POOL_MIN_CLASS_SIZE << class_index;
+		size_t objects = (VEC89_POOL_SLAB_SIZE - VEC89_POOL_HEADER_SIZE) / class_size;
+		size_t i;
+
+		struct VEC89_POOL_SLAB *slab = MALLOC_FUNCTION(VEC89_POOL_SLAB_SIZE);
+		if (slab == NULL) return NULL;
+		pool->system_allocations++;
+
+		slab->next = pool->slabs;
+		pool->slabs = slab;
+
+		/* Thread the new objects onto the free list, lowest address first */
+		char *object = (char *)slab + VEC89_POOL_HEADER_SIZE + class_size * (objects - 1);
+		for (i = 0; i < objects; i++) {
+			*(void **)object = pool->free_lists[class_index];
+			pool->free_lists[class_index] = object;
+			object -= class_size;
+		}
+	}
+
+	void *block = pool->free_lists[class_index];
+	pool->free_lists[class_index] = *(void **)block;
+
+	return block;
+}
+
+static void vec89_pool_free(void *context, void *block, size_t size) {
+	vec89_pool_p pool = context;
+	size_t class_index = vec89_pool_class(size);
+
+	if (block == NULL) return;
+
+	if (class_index == VEC89_POOL_CLASS_COUNT) {
+		FREE_FUNCTION(block);
+		return;
+	}
+
+	*(void **)block = pool->free_lists[class_index];
+	pool->free_lists[class_index] = block;
+}
+
+static void *vec89_pool_realloc(void *context, void *block, size_t old_size, size_t new_size) {
+	if (block == NULL) return vec89_pool_alloc(context, new_size);
+
+	size_t old_class = vec89_pool_class(old_size);
+	size_t new_class = vec89_pool_class(new_size);
+
+	if (old_class == new_class) {
+		if (old_class < VEC89_POOL_CLASS_COUNT) return block;
+		return REALLOC_FUNCTION(block, new_size);
+	}
+
+	void *new_block = vec89_pool_alloc(context, new_size);
+	if (new_block == NULL) return NULL;
+
+	memcpy(new_block, block, min(old_size, new_size));
+	vec89_pool_free(context, block, old_size);
+
+	return new_block;
+}
+
+char VEC89_POOL_INITIALIZATION(vec89_pool_p pool) {
+	if (pool == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	size_t i;
+	for (i = 0; i < VEC89_POOL_CLASS_COUNT; i++) pool->free_lists[i] = NULL;
+	pool->slabs = NULL;
+	pool->system_allocations = 0;
+
+	pool->allocator.alloc_function = vec89_pool_alloc;
+	pool->allocator.realloc_function = vec89_pool_realloc;
+	pool->allocator.free_function = vec89_pool_free;
+	pool->allocator.context = pool;
+
+	return VEC89_SUCCESS;
+}
+
+void VEC89_POOL_DESTROY(vec89_pool_p pool) {
+	if (pool == NULL) return;
+
+	struct VEC89_POOL_SLAB *slab = pool->slabs;
+	while (slab != NULL) {
+		struct VEC89_POOL_SLAB *next = slab->next;
+		FREE_FUNCTION(slab);
+		slab = next;
+	}
+
+	size_t i;
+	for (i = 0; i < VEC89_POOL_CLASS_COUNT; i++) pool->free_lists[i] = NULL;
+	pool->slabs = NULL;
+}
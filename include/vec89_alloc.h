@@ -0,0 +1,119 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#ifndef VEC89_ALLOC_H
+#define VEC89_ALLOC_H
+
+#include "vec89.h"
+
+#define VEC89_ALLOC_ALIGNMENT 16 /* Alignment of every block handed out by the arena and the pool */
+
+#define VEC89_ARENA_DEFAULT_BLOCK_SIZE 65536 /* Bytes requested from the system per arena block */
+
+#define VEC89_POOL_CLASS_COUNT 12 /* Size classes 16, 32, 64, ... 32768 bytes */
+#define VEC89_POOL_MIN_CLASS_SIZE 16
+#define VEC89_POOL_SLAB_SIZE 65536 /* Bytes requested from the system per pool slab */
+
+struct VEC89_ARENA_BLOCK;
+struct VEC89_POOL_SLAB;
+
+/*
+Bump-pointer arena. Allocations are carved out of large blocks and are only released all at once by a reset or destroy.
+The most recent allocation can grow or be released in place, which makes a single growing vector cheap.
+The arena holds a ready to use allocator in its allocator member, the arena must not be moved while vectors use it.
+An arena isn't thread safe.
+*/
+typedef struct VEC89_ARENA {
+	struct VEC89_ARENA_BLOCK *head; /* Current block, older blocks are chained behind it */
+	char *last;						/* Most recent allocation */
+	size_t block_size;				/* Minimum size of a block in bytes */
+	size_t system_allocations;		/* Number of blocks requested from the system */
+	vec89_allocator allocator;		/* Allocator to attach to vectors */
+} vec89_arena, *vec89_arena_p;
+
+/*
+Size-class pool. Requests are rounded up to a power of two class and served from per-class free lists filled from slabs.
+Requests larger than the biggest class go straight to the system allocator.
+The pool holds a ready to use allocator in its allocator member, the pool must not be moved while vectors use it.
+A pool isn't thread safe.
+*/
+typedef struct VEC89_POOL {
+	void *free_lists[VEC89_POOL_CLASS_COUNT]; /* Free blocks of every class */
+	struct VEC89_POOL_SLAB *slabs;			  /* Slabs requested from the system */
+	size_t system_allocations;				  /* Number of slabs and large blocks requested from the system */
+	vec89_allocator allocator;				  /* Allocator to attach to vectors */
+} vec89_pool, *vec89_pool_p;
+
+#ifdef VEC89_FUNCTION_MACROS
+	#define vec_arena_init(arena_obj, block_size) VEC89_ARENA_INITIALIZATION(&arena_obj, block_size)
+	#define vec_arena_reset(arena_obj) VEC89_ARENA_RESET(&arena_obj)
+	#define vec_arena_destroy(arena_obj) VEC89_ARENA_DESTROY(&arena_obj)
+
+	#define vec_pool_init(pool_obj) VEC89_POOL_INITIALIZATION(&pool_obj)
+	#define vec_pool_destroy(pool_obj) VEC89_POOL_DESTROY(&pool_obj)
+#endif
+
+/*
+Initializes an arena. No memory is requested until the first allocation.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_arena_p arena: Pointer to the arena. (arena != NULL)
+*size_t block_size: Minimum block size in bytes, 0 for VEC89_ARENA_DEFAULT_BLOCK_SIZE.
+*/
+char VEC89_ARENA_INITIALIZATION(vec89_arena_p arena, size_t block_size);
+
+/*
+Releases every allocation of the arena at once. The current block is kept for reuse, older blocks are freed.
+Vectors using the arena must not be used afterwards.
+
+*vec89_arena_p arena: Pointer to the arena.
+*/
+void VEC89_ARENA_RESET(vec89_arena_p arena);
+
+/*
+Frees every block of the arena.
+Vectors using the arena must not be used afterwards.
+
+*vec89_arena_p arena: Pointer to the arena.
+*/
+void VEC89_ARENA_DESTROY(vec89_arena_p arena);
+
+/*
+Initializes a pool. No memory is requested until the first allocation.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_pool_p pool: Pointer to the pool. (pool != NULL)
+*/
+char VEC89_POOL_INITIALIZATION(vec89_pool_p pool);
+
+/*
+Frees every slab of the pool. Blocks larger than the biggest class must have been freed already.
+Vectors using the pool must not be used afterwards.
+
+*vec89_pool_p pool: Pointer to the pool.
+*/
+void VEC89_POOL_DESTROY(vec89_pool_p pool);
+
+#endif /* VEC89_ALLOC_H */
@@ -0,0 +1,408 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#include "vec89_io.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <errno.h>
+	#include <unistd.h>
+#endif
+
+#define min(a, b) ((a) > (b) ? (b) : (a))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+#define VEC89_SIZE_MAX ((size_t)-1)
+
+#define VEC89_IO_HEADER_SIZE 32
+#define VEC89_IO_CHUNK_HEADER_SIZE 12
+#define VEC89_IO_FLAGS VEC89_IO_CHECKSUM /* Every flag this version reads and writes */
+
+#define VEC89_ADLER_BASE 65521UL
+#define VEC89_ADLER_INIT 1UL /* Running checksum of no bytes, a = 1 and b = 0 */
+#define VEC89_ADLER_NMAX 5552 /* Largest block whose sums can't overflow 32 bits before the modulo */
+
+static void vec89_put_le(unsigned char *p, size_t value, size_t bytes) {
+	size_t i;
+	for (i = 0; i < bytes; i++) {
+		p[i] = (unsigned char)(value & 0xFF);
+		value >>= 8;
+	}
+}
+
+/* Fails if the value doesn't fit a size_t */
+static char vec89_get_le(const unsigned char *p, size_t bytes, size_t *out_value) {
+	size_t value = 0;
+	size_t i = bytes;
+	while (i--) {
+		if (value > (VEC89_SIZE_MAX >> 8)) return VEC89_FAILURE;
+		value = (value << 8) | p[i];
+	}
+
+	*out_value = value;
+	return VEC89_SUCCESS;
+}
+
+/* Continues a running checksum with (b << 16) | a packed like the result, so a chunk can be summed piece by piece */
+static unsigned long vec89_adler32(unsigned long adler, const unsigned char *data, size_t size) {
+	unsigned long a = adler & 0xFFFFUL, b = (adler >> 16) & 0xFFFFUL;
+	while (size > 0) {
+		size_t block = min(size, VEC89_ADLER_NMAX);
+		size -= block;
+
+		while (block >= 4) {
+			a += data[0]; b += a;
+			a += data[1]; b += a;
+			a += data[2]; b += a;
+			a += data[3]; b += a;
+			data += 4;
+			block -= 4;
+		}
+		while (block--) {
+			a += *data++;
+			b += a;
+		}
+
+		a %= VEC89_ADLER_BASE;
+		b %= VEC89_ADLER_BASE;
+	}
+	return ((b << 16) | a) & 0xFFFFFFFFUL;
+}
+
+static size_t vec89_file_read(void *context, void *buffer, size_t size) {
+	return fread(buffer, 1, size, (FILE *)context);
+}
+
+static size_t vec89_file_write(void *context, const void *buffer, size_t size) {
+	return fwrite(buffer, 1, size, (FILE *)context);
+}
+
+/* read() and write() may transfer less than asked for on pipes and sockets, so both loop until done */
+static size_t vec89_fd_read(void *context, void *buffer, size_t size) {
+	vec89_stream_p stream = context;
+	size_t done = 0;
+	while (done < size) {
+#ifdef _WIN32
+		int result = _read(stream->fd, (char *)buffer + done, (unsigned int)min(size - done, 1U << 30));
+		if (result <= 0) break;
+#else
+		ssize_t result = read(stream->fd, (char *)buffer + done, min(size - done, (size_t)1 << 30));
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) break;
+#endif
+		done += (size_t)result;
+	}
+	return done;
+}
+
+static size_t vec89_fd_write(void *context, const void *buffer, size_t size) {
+	vec89_stream_p stream = context;
+	size_t done = 0;
+	while (done < size) {
+#ifdef _WIN32
+		int result = _write(stream->fd, (const char *)buffer + done, (unsigned int)min(size - done, 1U << 30));
+		if (result <= 0) break;
+#else
+		ssize_t result = write(stream->fd, (const char *)buffer + done, min(size - done, (size_t)1 << 30));
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) break;
+#endif
+		done += (size_t)result;
+	}
+	return done;
+}
+
+static char vec89_stream_read_exact(vec89_stream_p stream, void *buffer, size_t size) {
+	if (stream->read_function(stream->context, buffer, size) != size) return VEC89_FAILURE;
+	return VEC89_SUCCESS;
+}
+
+static char vec89_stream_write_exact(vec89_stream_p stream, const void *buffer, size_t size) {
+	if (stream->write_function(stream->context, buffer, size) != size) return VEC89_FAILURE;
+	return VEC89_SUCCESS;
+}
+
+static void vec89_stream_reset(vec89_stream_p stream) {
+	stream->elem_size = 0;
+	stream->count = VEC89_IO_UNKNOWN_COUNT;
+	stream->flags = 0;
+	stream->transferred = 0;
+	stream->finished = 0;
+	stream->fd = -1;
+}
+
+char VEC89_STREAM_OPEN_FILE(vec89_stream_p stream, FILE *file) {
+	if (stream == NULL || file == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	vec89_stream_reset(stream);
+	stream->read_function = vec89_file_read;
+	stream->write_function = vec89_file_write;
+	stream->context = file;
+	return VEC89_SUCCESS;
+}
+
+char VEC89_STREAM_OPEN_FD(vec89_stream_p stream, int fd) {
+	if (stream == NULL || fd < 0) return VEC89_INVALID_ARGUMENTS;
+
+	vec89_stream_reset(stream);
+	stream->read_function = vec89_fd_read;
+	stream->write_function = vec89_fd_write;
+	stream->context = stream;
+	stream->fd = fd;
+	return VEC89_SUCCESS;
+}
+
+char VEC89_STREAM_WRITE_HEADER(vec89_stream_p stream, size_t element_size, size_t count, size_t flags) {
+	if (stream == NULL || element_size == 0 || (flags & ~(size_t)VEC89_IO_FLAGS) != 0) return VEC89_INVALID_ARGUMENTS;
+
+	unsigned char header[VEC89_IO_HEADER_SIZE];
+	memcpy(header, VEC89_IO_MAGIC, 8);
+	vec89_put_le(header + 8, VEC89_IO_VERSION, 4);
+	vec89_put_le(header + 12, flags, 4);
+	vec89_put_le(header + 16, element_size, 8);
+	if (count == VEC89_IO_UNKNOWN_COUNT) memset(header + 24, 0xFF, 8);
+	else vec89_put_le(header + 24, count, 8);
+
+	stream->elem_size = element_size;
+	stream->count = count;
+	stream->flags = flags;
+	stream->transferred = 0;
+	stream->finished = 0;
+	return vec89_stream_write_exact(stream, header, sizeof(header));
+}
+
+char VEC89_STREAM_WRITE_CHUNK(vec89_stream_p stream, const void *elements, size_t n) {
+	if (stream == NULL || stream->elem_size == 0 || stream->finished || (elements == NULL && n > 0)) return VEC89_INVALID_ARGUMENTS;
+	if (n == 0) return VEC89_SUCCESS;
+	if (n > VEC89_SIZE_MAX / stream->elem_size) return VEC89_INVALID_ARGUMENTS;
+	if (stream->count != VEC89_IO_UNKNOWN_COUNT && n > stream->count - stream->transferred) return VEC89_INVALID_ARGUMENTS;
+
+	size_t size = n * stream->elem_size;
+	unsigned char header[VEC89_IO_CHUNK_HEADER_SIZE];
+	vec89_put_le(header, n, 8);
+	vec89_put_le(header + 8, (stream->flags & VEC89_IO_CHECKSUM) ? (size_t)vec89_adler32(VEC89_ADLER_INIT, elements, size) : 0, 4);
+
+	if (vec89_stream_write_exact(stream, header, sizeof(header)) != VEC89_SUCCESS) return VEC89_FAILURE;
+	if (vec89_stream_write_exact(stream, elements, size) != VEC89_SUCCESS) return VEC89_FAILURE;
+
+	stream->transferred += n;
+	return VEC89_SUCCESS;
+}
+
+char VEC89_STREAM_WRITE_END(vec89_stream_p stream) {
+	if (stream == NULL || stream->elem_size == 0 || stream->finished) return VEC89_INVALID_ARGUMENTS;
+	if (stream->count != VEC89_IO_UNKNOWN_COUNT && stream->transferred != stream->count) return VEC89_INVALID_ARGUMENTS;
+
+	unsigned char header[VEC89_IO_CHUNK_HEADER_SIZE];
+	memset(header, 0, sizeof(header));
+
+	stream->finished = 1;
+	return vec89_stream_write_exact(stream, header, sizeof(header));
+}
+
+char VEC89_STREAM_READ_HEADER(vec89_stream_p stream) {
+	if (stream == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	unsigned char header[VEC89_IO_HEADER_SIZE];
+	if (vec89_stream_read_exact(stream, header, sizeof(header)) != VEC89_SUCCESS) return VEC89_FAILURE;
+	if (memcmp(header, VEC89_IO_MAGIC, 8) != 0) return VEC89_FAILURE;
+
+	size_t version, flags, element_size, count;
+	if (vec89_get_le(header + 8, 4, &version) != VEC89_SUCCESS || version != VEC89_IO_VERSION) return VEC89_FAILURE;
+	if (vec89_get_le(header + 12, 4, &flags) != VEC89_SUCCESS || (flags & ~(size_t)VEC89_IO_FLAGS) != 0) return VEC89_FAILURE;
+	if (vec89_get_le(header + 16, 8, &element_size) != VEC89_SUCCESS || element_size == 0) return VEC89_FAILURE;
+
+	static const unsigned char unknown[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+	if (memcmp(header + 24, unknown, 8) == 0) count = VEC89_IO_UNKNOWN_COUNT;
+	else if (vec89_get_le(header + 24, 8, &count) != VEC89_SUCCESS) return VEC89_FAILURE;
+
+	stream->elem_size = element_size;
+	stream->count = count;
+	stream->flags = flags;
+	stream->transferred = 0;
+	stream->finished = 0;
+	return VEC89_SUCCESS;
+}
+
+char VEC89_STREAM_READ_CHUNK(vec_p vec, vec89_stream_p stream, size_t *out_appended) {
+	if (vec == NULL || stream == NULL || out_appended == NULL || stream->elem_size == 0) return VEC89_INVALID_ARGUMENTS;
+	if (vec->elem_size != stream->elem_size) return VEC89_FAILURE;
+
+	*out_appended = 0;
+	if (stream->finished) return VEC89_SUCCESS;
+
+	unsigned char header[VEC89_IO_CHUNK_HEADER_SIZE];
+	if (vec89_stream_read_exact(stream, header, sizeof(header)) != VEC89_SUCCESS) return VEC89_FAILURE;
+
+	size_t n, checksum = 0;
+	if (vec89_get_le(header, 8, &n) != VEC89_SUCCESS) return VEC89_FAILURE;
+	vec89_get_le(header + 8, 4, &checksum);
+	if (n == 0) {
+		if (stream->count != VEC89_IO_UNKNOWN_COUNT && stream->transferred != stream->count) return VEC89_FAILURE;
+		stream->finished = 1;
+		return VEC89_SUCCESS;
+	}
+	if (n > VEC89_SIZE_MAX / stream->elem_size) return VEC89_FAILURE;
+	if (stream->count != VEC89_IO_UNKNOWN_COUNT && n > stream->count - stream->transferred) return VEC89_FAILURE;
+
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+
+	if (n > VEC89_SIZE_MAX - vec->count) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_MEMORY_ERROR;
+	}
+
+	/*
+	The chunk is read straight into the unused capacity in pieces of at most VEC89_IO_CHUNK_SIZE bytes and only counted
+	once it's complete and verified. Neither the header's count nor the chunk's own is trusted for the allocation,
+	the capacity doubles as the pieces actually arrive, so it stays within one piece or twice the data that was read
+	*/
+	/* Doubling stops at the end of a stream of known length, so a stream read into an empty vector fits exactly */
+	size_t rest = stream->count - stream->transferred;
+	size_t limit = VEC89_SIZE_MAX;
+	if (stream->count != VEC89_IO_UNKNOWN_COUNT && rest <= VEC89_SIZE_MAX - vec->count) limit = vec->count + rest;
+
+	size_t piece = max(VEC89_IO_CHUNK_SIZE / vec->elem_size, 1);
+	unsigned long adler = VEC89_ADLER_INIT;
+	size_t done = 0;
+	while (done < n) {
+		size_t step = min(n - done, piece);
+		size_t needed = vec->count + done + step;
+		if (needed > vec->capacity) {
+			size_t capacity = vec->capacity > VEC89_SIZE_MAX / 2 ? VEC89_SIZE_MAX : vec->capacity * 2;
+			capacity = min(capacity, limit);
+			result = VEC89_RESERVE(vec, max(needed, capacity));
+			if (result != VEC89_SUCCESS && capacity > needed) result = VEC89_RESERVE(vec, needed);
+			if (result != VEC89_SUCCESS) break;
+		}
+		if (done == 0) {
+			result = VEC89_DETACH(vec);
+			if (result != VEC89_SUCCESS) break;
+		}
+
+		unsigned char *destination = (unsigned char *)vec->arr + (vec->count + done) * vec->elem_size;
+		if (vec89_stream_read_exact(stream, destination, step * vec->elem_size) != VEC89_SUCCESS) {
+			result = VEC89_FAILURE;
+			break;
+		}
+		if (stream->flags & VEC89_IO_CHECKSUM) adler = vec89_adler32(adler, destination, step * vec->elem_size);
+		done += step;
+	}
+	if (result == VEC89_SUCCESS && (stream->flags & VEC89_IO_CHECKSUM) && (size_t)adler != checksum) result = VEC89_FAILURE;
+	if (result != VEC89_SUCCESS) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	vec->count += n;
+	VEC89_LOCK_SCOPE_END(vec);
+
+	stream->transferred += n;
+	*out_appended = n;
+	return VEC89_SUCCESS;
+}
+
+static char vec89_write_stream(vec_p vec, vec89_stream_p stream, size_t flags) {
+	const void *arr;
+	size_t count;
+	char result = VEC89_READ_BEGIN(vec, &arr, &count);
+	if (result != VEC89_SUCCESS) return result;
+
+	result = VEC89_STREAM_WRITE_HEADER(stream, vec->elem_size, count, flags);
+
+	size_t chunk = max(VEC89_IO_CHUNK_SIZE / vec->elem_size, 1);
+	size_t done = 0;
+	while (result == VEC89_SUCCESS && done < count) {
+		size_t n = min(count - done, chunk);
+		result = VEC89_STREAM_WRITE_CHUNK(stream, (const char *)arr + done * vec->elem_size, n);
+		done += n;
+	}
+	if (result == VEC89_SUCCESS) result = VEC89_STREAM_WRITE_END(stream);
+
+	VEC89_READ_END(vec);
+	return result;
+}
+
+static char vec89_read_stream(vec_p vec, vec89_stream_p stream) {
+	char result = VEC89_STREAM_READ_HEADER(stream);
+	if (result != VEC89_SUCCESS) return result;
+	if (stream->elem_size != vec->elem_size) return VEC89_FAILURE;
+
+	/* The header's count is only trusted as far as one chunk, longer streams grow as their chunks arrive */
+	if (stream->count != VEC89_IO_UNKNOWN_COUNT) {
+		size_t reserve = min(stream->count, max(VEC89_IO_CHUNK_SIZE / vec->elem_size, 1));
+		result = VEC89_LOCK_SCOPE_BEGIN(vec);
+		if (result != VEC89_SUCCESS) return result;
+		if (reserve > VEC89_SIZE_MAX - vec->count) result = VEC89_MEMORY_ERROR;
+		else if (vec->count + reserve > vec->capacity) result = VEC89_RESERVE(vec, vec->count + reserve);
+		VEC89_LOCK_SCOPE_END(vec);
+		if (result != VEC89_SUCCESS) return result;
+	}
+
+	size_t appended;
+	do {
+		result = VEC89_STREAM_READ_CHUNK(vec, stream, &appended);
+	} while (result == VEC89_SUCCESS && appended > 0);
+	return result;
+}
+
+char VEC89_WRITE(vec_p vec, FILE *file, size_t flags) {
+	if (vec == NULL || file == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	vec89_stream stream;
+	VEC89_STREAM_OPEN_FILE(&stream, file);
+
+	char result = vec89_write_stream(vec, &stream, flags);
+	if (result == VEC89_SUCCESS && fflush(file) != 0) result = VEC89_FAILURE;
+	return result;
+}
+
+char VEC89_READ(vec_p vec, FILE *file) {
+	if (vec == NULL || file == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	vec89_stream stream;
+	VEC89_STREAM_OPEN_FILE(&stream, file);
+	return vec89_read_stream(vec, &stream);
+}
+
+char VEC89_WRITE_FD(vec_p vec, int fd, size_t flags) {
+	if (vec == NULL || fd < 0) return VEC89_INVALID_ARGUMENTS;
+
+	vec89_stream stream;
+	VEC89_STREAM_OPEN_FD(&stream, fd);
+	return vec89_write_stream(vec, &stream, flags);
+}
+
+char VEC89_READ_FD(vec_p vec, int fd) {
+	if (vec == NULL || fd < 0) return VEC89_INVALID_ARGUMENTS;
+
+	vec89_stream stream;
+	VEC89_STREAM_OPEN_FD(&stream, fd);
+	return vec89_read_stream(vec, &stream);
+}
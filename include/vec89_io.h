@@ -0,0 +1,172 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#ifndef VEC89_IO_H
+#define VEC89_IO_H
+
+#include "vec89.h"
+
+#define VEC89_IO_CHUNK_SIZE ((size_t)1 << 20) /* Bytes of elements per chunk written by VEC89_WRITE */
+
+#define VEC89_IO_CHECKSUM 1 /* Flag: every chunk carries an Adler-32 checksum that is verified on read */
+
+#define VEC89_IO_UNKNOWN_COUNT ((size_t)-1) /* Header count of streams whose length isn't known up front */
+
+/*
+Binary stream format, all integers little-endian:
+	header: "VEC89STR", u32 version, u32 flags, u64 element size, u64 element count (all ones if unknown)
+	chunks: u64 element count, u32 checksum (0 without VEC89_IO_CHECKSUM), raw elements
+	end:    a chunk with an element count of 0
+*/
+#define VEC89_IO_MAGIC "VEC89STR"
+#define VEC89_IO_VERSION 1
+
+/*
+Source or sink of a stream. The functions transfer up to size bytes and return the number transferred,
+fewer than size only at the end of the stream or on error.
+*/
+typedef struct VEC89_STREAM {
+	size_t (*read_function)(void *context, void *buffer, size_t size);
+	size_t (*write_function)(void *context, const void *buffer, size_t size);
+	void *context;
+	size_t elem_size;  /* Element size from the header */
+	size_t count;	   /* Element count from the header, VEC89_IO_UNKNOWN_COUNT if unknown */
+	size_t flags;	   /* VEC89_IO_* flags from the header */
+	size_t transferred; /* Elements in the chunks read or written since the header */
+	char finished;	   /* Non-zero once the end chunk was read or written */
+	int fd;			   /* Descriptor of streams opened with VEC89_STREAM_OPEN_FD */
+} vec89_stream, *vec89_stream_p;
+
+#ifdef VEC89_FUNCTION_MACROS
+	#define vec_write(vec_obj, file, flags) VEC89_WRITE(&vec_obj, file, flags)
+	#define vec_read(vec_obj, file) VEC89_READ(&vec_obj, file)
+	#define vec_write_fd(vec_obj, fd, flags) VEC89_WRITE_FD(&vec_obj, fd, flags)
+	#define vec_read_fd(vec_obj, fd) VEC89_READ_FD(&vec_obj, fd)
+#endif
+
+/*
+Writes the whole vector to a stdio stream: header, chunks of VEC89_IO_CHUNK_SIZE bytes and the end chunk.
+The vector is locked for reading while it is written.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_FAILURE on I/O errors.
+
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*FILE *file: Stream opened for binary writing. (file != NULL)
+*size_t flags: 0 or VEC89_IO_CHECKSUM.
+*/
+char VEC89_WRITE(vec_p vec, FILE *file, size_t flags);
+
+/*
+Reads a stream written by VEC89_WRITE or the stream writer functions and appends its elements to the vector.
+At most one chunk of the header's count is reserved up front, the vector then grows as the data arrives, so whatever counts
+the header and the chunks claim the reader allocates no more than one chunk or twice the data that actually follows. Elements are read straight into the array,
+a chunk only becomes part of the vector once it was read completely and its checksum matched.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_FAILURE on I/O errors, truncated or invalid
+streams, unknown flags, chunks that don't add up to the header's count, checksum mismatches and element sizes
+that differ from the vector's.
+
+*vec_p vec: Pointer to an initialized vector. (vec != NULL)
+*FILE *file: Stream opened for binary reading. (file != NULL)
+*/
+char VEC89_READ(vec_p vec, FILE *file);
+
+/*
+VEC89_WRITE for a file descriptor, works with pipes and sockets.
+*/
+char VEC89_WRITE_FD(vec_p vec, int fd, size_t flags);
+
+/*
+VEC89_READ for a file descriptor, works with pipes and sockets.
+*/
+char VEC89_READ_FD(vec_p vec, int fd);
+
+/*
+Initializes a stream reading from or writing to a stdio stream.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_stream_p stream: Pointer to the stream. (stream != NULL)
+*FILE *file: The stdio stream. (file != NULL)
+*/
+char VEC89_STREAM_OPEN_FILE(vec89_stream_p stream, FILE *file);
+
+/*
+Initializes a stream reading from or writing to a file descriptor.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_stream_p stream: Pointer to the stream. (stream != NULL)
+*int fd: The file descriptor. (fd >= 0)
+*/
+char VEC89_STREAM_OPEN_FD(vec89_stream_p stream, int fd);
+
+/*
+Writes the stream header. Must be called once before any chunk is written.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_stream_p stream: Pointer to the stream. (stream != NULL)
+*size_t element_size: Size of a single element in bytes. (element_size > 0)
+*size_t count: Total element count, the chunks must add up to it. VEC89_IO_UNKNOWN_COUNT if it isn't known yet.
+*size_t flags: 0 or VEC89_IO_CHECKSUM.
+*/
+char VEC89_STREAM_WRITE_HEADER(vec89_stream_p stream, size_t element_size, size_t count, size_t flags);
+
+/*
+Writes n elements as one chunk. Writing 0 elements does nothing, the stream is only ended by VEC89_STREAM_WRITE_END.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_INVALID_ARGUMENTS past the header's count.
+
+*vec89_stream_p stream: Pointer to the stream. (stream != NULL)
+*const void *elements: Pointer to the first element. (elements != NULL if n > 0)
+*size_t n: Number of elements.
+*/
+char VEC89_STREAM_WRITE_CHUNK(vec89_stream_p stream, const void *elements, size_t n);
+
+/*
+Writes the end chunk.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_INVALID_ARGUMENTS before the header's count was written.
+
+*vec89_stream_p stream: Pointer to the stream. (stream != NULL)
+*/
+char VEC89_STREAM_WRITE_END(vec89_stream_p stream);
+
+/*
+Reads and validates the stream header, the element size, count and flags are stored in the stream.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_FAILURE for invalid headers and flags this version doesn't know.
+
+*vec89_stream_p stream: Pointer to the stream. (stream != NULL)
+*/
+char VEC89_STREAM_READ_HEADER(vec89_stream_p stream);
+
+/*
+Reads the next chunk and appends its elements to the vector, reading them straight into the array.
+The chunk is read in pieces of at most VEC89_IO_CHUNK_SIZE bytes and the vector grows as they arrive, not by the chunk's count.
+Lets a consumer process a pipe of unknown length as it arrives.
+Returns 0 on success, non-zero error codes on failure. Returns VEC89_FAILURE if the chunks go past the header's count
+or the end chunk comes before it.
+
+*vec_p vec: Pointer to the vector. (vec != NULL, vec->elem_size == stream->elem_size)
+*vec89_stream_p stream: Pointer to a stream whose header was read. (stream != NULL)
+*size_t *out_appended: Pointer receiving the number of appended elements, 0 once the end chunk was read. (out_appended != NULL)
+*/
+char VEC89_STREAM_READ_CHUNK(vec_p vec, vec89_stream_p stream, size_t *out_appended);
+
+#endif /* VEC89_IO_H */
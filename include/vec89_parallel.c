@@ -0,0 +1,579 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#include "vec89_parallel.h"
+
+#ifdef VEC89_PARALLEL_NOTC89
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+	#include <unistd.h>
+#endif
+
+#define min(a, b) ((a) > (b) ? (b) : (a))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+#define MALLOC_FUNCTION(Size) malloc(Size)
+#define FREE_FUNCTION(Block) free(Block)
+
+#define VEC89_SIZE_MAX ((size_t)-1)
+
+#ifdef _WIN32
+	#define VEC89_POOL_MUTEX_INIT(mutex_p) InitializeCriticalSection(mutex_p)
+	#define VEC89_POOL_MUTEX_LOCK(mutex_p) EnterCriticalSection(mutex_p)
+	#define VEC89_POOL_MUTEX_UNLOCK(mutex_p) LeaveCriticalSection(mutex_p)
+	#define VEC89_POOL_MUTEX_DESTROY(mutex_p) DeleteCriticalSection(mutex_p)
+	#define VEC89_POOL_COND_INIT(cond_p) InitializeConditionVariable(cond_p)
+	#define VEC89_POOL_COND_WAIT(cond_p, mutex_p) SleepConditionVariableCS(cond_p, mutex_p, INFINITE)
+	#define VEC89_POOL_COND_SIGNAL(cond_p) WakeConditionVariable(cond_p)
+	#define VEC89_POOL_COND_BROADCAST(cond_p) WakeAllConditionVariable(cond_p)
+	#define VEC89_POOL_COND_DESTROY(cond_p) ((void)0)
+#else
+	#define VEC89_POOL_MUTEX_INIT(mutex_p) pthread_mutex_init(mutex_p, NULL)
+	#define VEC89_POOL_MUTEX_LOCK(mutex_p) pthread_mutex_lock(mutex_p)
+	#define VEC89_POOL_MUTEX_UNLOCK(mutex_p) pthread_mutex_unlock(mutex_p)
+	#define VEC89_POOL_MUTEX_DESTROY(mutex_p) pthread_mutex_destroy(mutex_p)
+	#define VEC89_POOL_COND_INIT(cond_p) pthread_cond_init(cond_p, NULL)
+	#define VEC89_POOL_COND_WAIT(cond_p, mutex_p) pthread_cond_wait(cond_p, mutex_p)
+	#define VEC89_POOL_COND_SIGNAL(cond_p) pthread_cond_signal(cond_p)
+	#define VEC89_POOL_COND_BROADCAST(cond_p) pthread_cond_broadcast(cond_p)
+	#define VEC89_POOL_COND_DESTROY(cond_p) pthread_cond_destroy(cond_p)
+#endif
+
+struct VEC89_THREAD_POOL_WORKER {
+	vec89_thread_pool_p pool;
+	size_t id; /* Participant index, the calling thread is 0 */
+};
+
+/* Chunks [next, end) not yet claimed by any participant, padded so neighbouring ranges don't share a cache line */
+struct VEC89_PARALLEL_RANGE {
+	size_t next;
+	size_t end;
+	char padding[VEC89_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+};
+
+struct VEC89_PARALLEL_JOB {
+	void (*task)(struct VEC89_PARALLEL_JOB *job, size_t chunk);
+	struct VEC89_PARALLEL_RANGE *ranges;
+	size_t participants;
+	size_t task_count;
+
+	/* Chunk 0 is [0, offset + step), chunk k is [offset + k * step, offset + (k + 1) * step) */
+	unsigned char *arr;
+	size_t count;
+	size_t elem_size;
+	size_t offset;
+	size_t step;
+	size_t chunk_count;
+
+	void *context;
+	vec89_range_function for_each;
+	vec89_transform_function transform;
+	unsigned char *destination;
+	size_t destination_size;
+	vec89_reduce_function reduce;
+	unsigned char *partials;
+	size_t result_size;
+	vec89_compare_function compare;
+	unsigned char *merge_source;
+	unsigned char *merge_destination;
+	size_t *bounds; /* Run boundaries of the current merge round */
+};
+
+static void vec89_parallel_participate(struct VEC89_PARALLEL_JOB *job, size_t id) {
+	size_t i;
+	for (i = 0; i < job->participants; i++) {
+		/* Own range first, then steal from the following participants */
+		struct VEC89_PARALLEL_RANGE *range = &job->ranges[(id + i) % job->participants];
+		while (VEC89_ATOMIC_LOAD(&range->next) < range->end) {
+			size_t task = VEC89_ATOMIC_FETCH_ADD(&range->next, 1);
+			if (task >= range->end) break;
+			job->task(job, task);
+		}
+	}
+}
+
+static void vec89_worker_loop(struct VEC89_THREAD_POOL_WORKER *worker) {
+	vec89_thread_pool_p pool = worker->pool;
+	size_t seen = 0;
+
+	VEC89_POOL_MUTEX_LOCK(&pool->mutex);
+	for (;;) {
+		while (!pool->stop && pool->generation == seen) VEC89_POOL_COND_WAIT(&pool->wake, &pool->mutex);
+		if (pool->stop) break;
+
+		seen = pool->generation;
+		struct VEC89_PARALLEL_JOB *job = pool->job;
+		VEC89_POOL_MUTEX_UNLOCK(&pool->mutex);
+
+		if (worker->id < job->participants) vec89_parallel_participate(job, worker->id);
+
+		VEC89_POOL_MUTEX_LOCK(&pool->mutex);
+		if (--pool->active == 0) VEC89_POOL_COND_SIGNAL(&pool->done);
+	}
+	VEC89_POOL_MUTEX_UNLOCK(&pool->mutex);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI vec89_worker_main(LPVOID argument) {
+	vec89_worker_loop(argument);
+	return 0;
+}
+#else
+static void *vec89_worker_main(void *argument) {
+	vec89_worker_loop(argument);
+	return NULL;
+}
+#endif
+
+/* Hands the tasks out over the participants' ranges and runs them, the calling thread is participant 0 */
+static void vec89_parallel_run(vec89_thread_pool_p pool, struct VEC89_PARALLEL_JOB *job, size_t task_count) {
+	size_t i;
+	for (i = 0; i < job->participants; i++) {
+		job->ranges[i].next = task_count * i / job->participants;
+		job->ranges[i].end = task_count * (i + 1) / job->participants;
+	}
+	job->task_count = task_count;
+
+	if (job->participants == 1) {
+		vec89_parallel_participate(job, 0);
+		return;
+	}
+
+	VEC89_POOL_MUTEX_LOCK(&pool->run_mutex);
+	VEC89_POOL_MUTEX_LOCK(&pool->mutex);
+	pool->job = job;
+	pool->active = pool->thread_count - 1;
+	pool->generation++;
+	VEC89_POOL_COND_BROADCAST(&pool->wake);
+	VEC89_POOL_MUTEX_UNLOCK(&pool->mutex);
+
+	vec89_parallel_participate(job, 0);
+
+	VEC89_POOL_MUTEX_LOCK(&pool->mutex);
+	while (pool->active > 0) VEC89_POOL_COND_WAIT(&pool->done, &pool->mutex);
+	pool->job = NULL;
+	VEC89_POOL_MUTEX_UNLOCK(&pool->mutex);
+	VEC89_POOL_MUTEX_UNLOCK(&pool->run_mutex);
+}
+
+static size_t vec89_gcd(size_t a, size_t b) {
+	while (b != 0) {
+		size_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+/*
+Splits the array into chunks of about target_size bytes. Chunk sizes are whole multiples of the cache line and every
+chunk but the first starts on a cache line boundary when the element size allows it, so no two chunks write the same line.
+*/
+static char vec89_parallel_prepare(struct VEC89_PARALLEL_JOB *job, vec89_thread_pool_p pool, size_t threads, void *arr, size_t count, size_t elem_size, size_t target_size) {
+	memset(job, 0, sizeof(*job));
+	job->arr = arr;
+	job->count = count;
+	job->elem_size = elem_size;
+
+	job->participants = 1;
+	if (pool != NULL && count >= VEC89_PARALLEL_THRESHOLD) {
+		job->participants = pool->thread_count;
+		if (threads > 0 && threads < job->participants) job->participants = threads;
+	}
+
+	if (job->participants == 1) {
+		job->step = max(count, 1);
+		job->chunk_count = 1;
+	} else {
+		size_t unit = VEC89_CACHE_LINE_SIZE / vec89_gcd(elem_size, VEC89_CACHE_LINE_SIZE);
+		size_t target = max(target_size / elem_size, 1);
+		job->step = (target + unit - 1) / unit * unit;
+
+		size_t i;
+		for (i = 0; i < unit; i++) {
+			if (((size_t)arr + i * elem_size) % VEC89_CACHE_LINE_SIZE == 0) {
+				job->offset = i;
+				break;
+			}
+		}
+
+		job->chunk_count = 1;
+		if (count > job->offset + job->step) job->chunk_count += (count - job->offset - job->step + job->step - 1) / job->step;
+	}
+
+	job->ranges = MALLOC_FUNCTION(sizeof(struct VEC89_PARALLEL_RANGE) * job->participants);
+	if (job->ranges == NULL) return VEC89_MEMORY_ERROR;
+	return VEC89_SUCCESS;
+}
+
+static void vec89_parallel_release(struct VEC89_PARALLEL_JOB *job) {
+	FREE_FUNCTION(job->ranges);
+}
+
+/* Chunk size for algorithms that profit from many small chunks to balance */
+static size_t vec89_parallel_chunk_target(vec89_thread_pool_p pool, size_t count, size_t elem_size) {
+	size_t threads = pool != NULL ? pool->thread_count : 1;
+	return max(min(VEC89_PARALLEL_CHUNK_SIZE, count / (threads * 4) * elem_size), VEC89_CACHE_LINE_SIZE);
+}
+
+static size_t vec89_chunk_begin(const struct VEC89_PARALLEL_JOB *job, size_t chunk) {
+	if (chunk == 0) return 0;
+	if (chunk >= job->chunk_count) return job->count;
+	return job->offset + chunk * job->step;
+}
+
+char VEC89_THREAD_POOL_INITIALIZATION(vec89_thread_pool_p pool, size_t thread_count) {
+	if (pool == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	if (thread_count == 0) {
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		thread_count = info.dwNumberOfProcessors;
+#else
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		thread_count = online > 0 ? (size_t)online : 1;
+#endif
+	}
+
+	pool->thread_count = thread_count;
+	pool->generation = 0;
+	pool->active = 0;
+	pool->stop = 0;
+	pool->job = NULL;
+	pool->threads = NULL;
+	pool->workers = NULL;
+
+	VEC89_POOL_MUTEX_INIT(&pool->mutex);
+	VEC89_POOL_MUTEX_INIT(&pool->run_mutex);
+	VEC89_POOL_COND_INIT(&pool->wake);
+	VEC89_POOL_COND_INIT(&pool->done);
+	if (thread_count == 1) return VEC89_SUCCESS;
+
+	struct VEC89_THREAD_POOL_WORKER *workers = MALLOC_FUNCTION(sizeof(struct VEC89_THREAD_POOL_WORKER) * (thread_count - 1));
+	pool->threads = MALLOC_FUNCTION(sizeof(VEC89_THREAD_TYPE) * (thread_count - 1));
+	pool->workers = workers;
+	if (workers == NULL || pool->threads == NULL) {
+		pool->thread_count = 1;
+		VEC89_THREAD_POOL_DESTROY(pool);
+		return VEC89_MEMORY_ERROR;
+	}
+
+	size_t i;
+	for (i = 0; i < thread_count - 1; i++) {
+		workers[i].pool = pool;
+		workers[i].id = i + 1;
+#ifdef _WIN32
+		pool->threads[i] = CreateThread(NULL, 0, vec89_worker_main, &workers[i], 0, NULL);
+		if (pool->threads[i] == NULL) break;
+#else
+		if (pthread_create(&pool->threads[i], NULL, vec89_worker_main, &workers[i]) != 0) break;
+#endif
+	}
+
+	if (i < thread_count - 1) {
+		/* Only the started workers are joined */
+		pool->thread_count = i + 1;
+		VEC89_THREAD_POOL_DESTROY(pool);
+		return VEC89_FAILURE;
+	}
+	return VEC89_SUCCESS;
+}
+
+void VEC89_THREAD_POOL_DESTROY(vec89_thread_pool_p pool) {
+	if (pool == NULL) return;
+
+	VEC89_POOL_MUTEX_LOCK(&pool->mutex);
+	pool->stop = 1;
+	VEC89_POOL_COND_BROADCAST(&pool->wake);
+	VEC89_POOL_MUTEX_UNLOCK(&pool->mutex);
+
+	size_t i;
+	for (i = 0; i + 1 < pool->thread_count; i++) {
+#ifdef _WIN32
+		WaitForSingleObject(pool->threads[i], INFINITE);
+		CloseHandle(pool->threads[i]);
+#else
+		pthread_join(pool->threads[i], NULL);
+#endif
+	}
+
+	FREE_FUNCTION(pool->threads);
+	FREE_FUNCTION(pool->workers);
+	pool->threads = NULL;
+	pool->workers = NULL;
+	pool->thread_count = 0;
+
+	VEC89_POOL_COND_DESTROY(&pool->done);
+	VEC89_POOL_COND_DESTROY(&pool->wake);
+	VEC89_POOL_MUTEX_DESTROY(&pool->run_mutex);
+	VEC89_POOL_MUTEX_DESTROY(&pool->mutex);
+}
+
+static void vec89_for_each_task(struct VEC89_PARALLEL_JOB *job, size_t chunk) {
+	size_t begin = vec89_chunk_begin(job, chunk), end = vec89_chunk_begin(job, chunk + 1);
+	job->for_each(job->arr + begin * job->elem_size, end - begin, begin, job->context);
+}
+
+char VEC89_PARALLEL_FOR_EACH(vec89_thread_pool_p pool, vec_p vec, vec89_range_function function, void *context, size_t threads) {
+	if (vec == NULL || function == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	/* The function may write the elements, a shared array is copied first */
+	result = VEC89_DETACH(vec);
+	if (result != VEC89_SUCCESS) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	struct VEC89_PARALLEL_JOB job;
+	result = vec89_parallel_prepare(&job, pool, threads, vec->arr, vec->count, vec->elem_size, vec89_parallel_chunk_target(pool, vec->count, vec->elem_size));
+	if (result == VEC89_SUCCESS) {
+		job.task = vec89_for_each_task;
+		job.for_each = function;
+		job.context = context;
+		if (vec->count > 0) vec89_parallel_run(pool, &job, job.chunk_count);
+	}
+	vec89_parallel_release(&job);
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return result;
+}
+
+static void vec89_transform_task(struct VEC89_PARALLEL_JOB *job, size_t chunk) {
+	size_t begin = vec89_chunk_begin(job, chunk), end = vec89_chunk_begin(job, chunk + 1);
+	job->transform(job->arr + begin * job->elem_size, job->destination + begin * job->destination_size, end - begin, job->context);
+}
+
+char VEC89_PARALLEL_TRANSFORM(vec89_thread_pool_p pool, vec_p source, vec_p destination, vec89_transform_function function, void *context, size_t threads) {
+	if (source == NULL || destination == NULL || source == destination || function == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	/* Locked in address order, like VEC89_APPEND_VEC */
+	const void *arr;
+	size_t count;
+	char result;
+	if (source < destination) {
+		result = VEC89_READ_BEGIN(source, &arr, &count);
+		if (result != VEC89_SUCCESS) return result;
+		result = VEC89_LOCK_SCOPE_BEGIN(destination);
+		if (result != VEC89_SUCCESS) {
+			VEC89_READ_END(source);
+			return result;
+		}
+	} else {
+		result = VEC89_LOCK_SCOPE_BEGIN(destination);
+		if (result != VEC89_SUCCESS) return result;
+		result = VEC89_READ_BEGIN(source, &arr, &count);
+		if (result != VEC89_SUCCESS) {
+			VEC89_LOCK_SCOPE_END(destination);
+			return result;
+		}
+	}
+
+	if (destination->arr == NULL) result = VEC89_INVALID_ARGUMENTS;
+	else if (destination->capacity < count) result = VEC89_RESERVE(destination, count);
+	if (result == VEC89_SUCCESS) result = VEC89_DETACH(destination);
+
+	struct VEC89_PARALLEL_JOB job;
+	if (result == VEC89_SUCCESS) {
+		result = vec89_parallel_prepare(&job, pool, threads, (void *)arr, count, source->elem_size, vec89_parallel_chunk_target(pool, count, source->elem_size));
+		if (result == VEC89_SUCCESS) {
+			job.task = vec89_transform_task;
+			job.transform = function;
+			job.destination = (unsigned char *)destination->arr;
+			job.destination_size = destination->elem_size;
+			job.context = context;
+			if (count > 0) vec89_parallel_run(pool, &job, job.chunk_count);
+			destination->count = count;
+		}
+		vec89_parallel_release(&job);
+	}
+
+	VEC89_READ_END(source);
+	VEC89_LOCK_SCOPE_END(destination);
+	return result;
+}
+
+static void vec89_reduce_task(struct VEC89_PARALLEL_JOB *job, size_t chunk) {
+	size_t begin = vec89_chunk_begin(job, chunk), end = vec89_chunk_begin(job, chunk + 1);
+	job->reduce(job->partials + chunk * job->result_size, job->arr + begin * job->elem_size, end - begin, job->context);
+}
+
+char VEC89_PARALLEL_REDUCE(vec89_thread_pool_p pool, vec_p vec, void *result, size_t result_size, vec89_reduce_function reduce, vec89_combine_function combine, void *context, size_t threads) {
+	if (vec == NULL || result == NULL || result_size == 0 || reduce == NULL || combine == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	const void *arr;
+	size_t count;
+	char code = VEC89_READ_BEGIN(vec, &arr, &count);
+	if (code != VEC89_SUCCESS) return code;
+
+	if (count < VEC89_PARALLEL_THRESHOLD || pool == NULL) {
+		reduce(result, arr, count, context);
+		VEC89_READ_END(vec);
+		return VEC89_SUCCESS;
+	}
+
+	struct VEC89_PARALLEL_JOB job;
+	code = vec89_parallel_prepare(&job, pool, threads, (void *)arr, count, vec->elem_size, vec89_parallel_chunk_target(pool, count, vec->elem_size));
+	if (code == VEC89_SUCCESS) {
+		/* Every chunk starts from its own copy of the identity */
+		job.partials = job.chunk_count > VEC89_SIZE_MAX / result_size ? NULL : MALLOC_FUNCTION(job.chunk_count * result_size);
+		if (job.partials == NULL) code = VEC89_MEMORY_ERROR;
+	}
+	if (code == VEC89_SUCCESS) {
+		size_t i;
+		for (i = 0; i < job.chunk_count; i++) memcpy(job.partials + i * result_size, result, result_size);
+
+		job.task = vec89_reduce_task;
+		job.reduce = reduce;
+		job.result_size = result_size;
+		job.context = context;
+		vec89_parallel_run(pool, &job, job.chunk_count);
+
+		for (i = 0; i < job.chunk_count; i++) combine(result, job.partials + i * result_size, context);
+		FREE_FUNCTION(job.partials);
+	}
+	vec89_parallel_release(&job);
+
+	VEC89_READ_END(vec);
+	return code;
+}
+
+static void vec89_sort_task(struct VEC89_PARALLEL_JOB *job, size_t chunk) {
+	size_t begin = vec89_chunk_begin(job, chunk), end = vec89_chunk_begin(job, chunk + 1);
+	VEC89_SORT_ARRAY(job->arr + begin * job->elem_size, end - begin, job->elem_size, job->compare);
+}
+
+/* Merges runs 2 * pair and 2 * pair + 1 of the current round, an unpaired last run is copied */
+static void vec89_merge_task(struct VEC89_PARALLEL_JOB *job, size_t pair) {
+	size_t size = job->elem_size;
+	size_t begin = job->bounds[2 * pair];
+	size_t middle = job->bounds[min(2 * pair + 1, job->chunk_count)];
+	size_t end = job->bounds[min(2 * pair + 2, job->chunk_count)];
+
+	const unsigned char *left = job->merge_source + begin * size, *left_end = job->merge_source + middle * size;
+	const unsigned char *right = left_end, *right_end = job->merge_source + end * size;
+	unsigned char *out = job->merge_destination + begin * size;
+
+	while (left < left_end && right < right_end) {
+		if (job->compare(right, left) < 0) {
+			memcpy(out, right, size);
+			right += size;
+		} else {
+			memcpy(out, left, size);
+			left += size;
+		}
+		out += size;
+	}
+	memcpy(out, left, (size_t)(left_end - left));
+	out += left_end - left;
+	memcpy(out, right, (size_t)(right_end - right));
+}
+
+char VEC89_PARALLEL_SORT(vec89_thread_pool_p pool, vec_p vec, vec89_compare_function compare, size_t threads) {
+	if (vec == NULL || compare == NULL) return VEC89_INVALID_ARGUMENTS;
+
+	char result = VEC89_LOCK_SCOPE_BEGIN(vec);
+	if (result != VEC89_SUCCESS) return result;
+	if (vec->arr == NULL) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_INVALID_ARGUMENTS;
+	}
+	/* Sorting writes the elements, a shared array is copied first */
+	result = VEC89_DETACH(vec);
+	if (result != VEC89_SUCCESS) {
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	size_t count = vec->count, size = vec->elem_size;
+	struct VEC89_PARALLEL_JOB job;
+
+	/* One run per participant keeps the number of merge rounds low */
+	size_t participants = pool != NULL ? pool->thread_count : 1;
+	if (threads > 0 && threads < participants) participants = threads;
+	result = vec89_parallel_prepare(&job, pool, threads, vec->arr, count, size, max(count / participants * size, VEC89_CACHE_LINE_SIZE));
+	if (result != VEC89_SUCCESS || job.chunk_count == 1) {
+		if (result == VEC89_SUCCESS) VEC89_SORT_ARRAY(vec->arr, count, size, compare);
+		vec89_parallel_release(&job);
+		VEC89_LOCK_SCOPE_END(vec);
+		return result;
+	}
+
+	unsigned char *temp = vec->allocator != NULL ? vec->allocator->alloc_function(vec->allocator->context, count * size) : MALLOC_FUNCTION(count * size);
+	job.bounds = MALLOC_FUNCTION(sizeof(size_t) * (job.chunk_count + 1));
+	if (temp == NULL || job.bounds == NULL) {
+		if (temp != NULL) {
+			if (vec->allocator != NULL) vec->allocator->free_function(vec->allocator->context, temp, count * size);
+			else FREE_FUNCTION(temp);
+		}
+		FREE_FUNCTION(job.bounds);
+		vec89_parallel_release(&job);
+		VEC89_LOCK_SCOPE_END(vec);
+		return VEC89_MEMORY_ERROR;
+	}
+
+	job.compare = compare;
+	job.task = vec89_sort_task;
+	vec89_parallel_run(pool, &job, job.chunk_count);
+
+	size_t i;
+	for (i = 0; i <= job.chunk_count; i++) job.bounds[i] = vec89_chunk_begin(&job, i);
+
+	/* chunk_count now holds the number of runs of the current round */
+	job.task = vec89_merge_task;
+	job.merge_source = (unsigned char *)vec->arr;
+	job.merge_destination = temp;
+	while (job.chunk_count > 1) {
+		size_t pairs = (job.chunk_count + 1) / 2;
+		vec89_parallel_run(pool, &job, pairs);
+
+		for (i = 0; i <= pairs; i++) job.bounds[i] = job.bounds[min(2 * i, job.chunk_count)];
+		job.chunk_count = pairs;
+
+		unsigned char *swap = job.merge_source;
+		job.merge_source = job.merge_destination;
+		job.merge_destination = swap;
+	}
+
+	if (job.merge_source == temp) memcpy(vec->arr, temp, count * size);
+	if (vec->allocator != NULL) vec->allocator->free_function(vec->allocator->context, temp, count * size);
+	else FREE_FUNCTION(temp);
+	FREE_FUNCTION(job.bounds);
+	vec89_parallel_release(&job);
+
+	VEC89_LOCK_SCOPE_END(vec);
+	return VEC89_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,167 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#ifndef VEC89_PARALLEL_H
+#define VEC89_PARALLEL_H
+
+#include "vec89.h"
+#include "vec89_algo.h"
+
+#ifdef VEC89_PARALLEL_NOTC89
+
+#ifdef _WIN32
+	#include <windows.h>
+	#define VEC89_THREAD_TYPE HANDLE
+	#define VEC89_POOL_MUTEX_TYPE CRITICAL_SECTION
+	#define VEC89_POOL_COND_TYPE CONDITION_VARIABLE
+#else
+	#include <pthread.h>
+	#define VEC89_THREAD_TYPE pthread_t
+	#define VEC89_POOL_MUTEX_TYPE pthread_mutex_t
+	#define VEC89_POOL_COND_TYPE pthread_cond_t
+#endif
+
+#ifndef VEC89_PARALLEL_THRESHOLD
+	#define VEC89_PARALLEL_THRESHOLD 32768 /* Vectors with fewer elements are processed on the calling thread */
+#endif
+
+#ifndef VEC89_PARALLEL_CHUNK_SIZE
+	#define VEC89_PARALLEL_CHUNK_SIZE ((size_t)1 << 16) /* Target bytes per chunk, chunks start on cache line boundaries */
+#endif
+
+#define VEC89_CACHE_LINE_SIZE 64
+
+/*
+Threads that run parallel algorithms. The calling thread always takes part in a job, so a pool of n threads starts
+n - 1 workers. Each participant owns a contiguous range of chunks and steals chunks from the others once its range is
+done. The pool runs one job at a time, calls from several threads take turns.
+*/
+typedef struct VEC89_THREAD_POOL {
+	VEC89_THREAD_TYPE *threads;
+	void *workers;			   /* Per worker start arguments */
+	size_t thread_count;	   /* Participants including the calling thread */
+	VEC89_POOL_MUTEX_TYPE mutex;
+	VEC89_POOL_MUTEX_TYPE run_mutex; /* Held by the thread whose job is running */
+	VEC89_POOL_COND_TYPE wake;
+	VEC89_POOL_COND_TYPE done;
+	size_t generation;		   /* Incremented for every job */
+	size_t active;			   /* Workers still running the current job */
+	char stop;
+	void *job;
+} vec89_thread_pool, *vec89_thread_pool_p;
+
+/* Called with n elements starting at index first_idx */
+typedef void (*vec89_range_function)(void *elements, size_t n, size_t first_idx, void *context);
+
+/* Writes the results for n source elements to destination */
+typedef void (*vec89_transform_function)(const void *source, void *destination, size_t n, void *context);
+
+/* Folds n elements into accumulator */
+typedef void (*vec89_reduce_function)(void *accumulator, const void *elements, size_t n, void *context);
+
+/* Folds partial, the result of elements following accumulator's, into accumulator */
+typedef void (*vec89_combine_function)(void *accumulator, const void *partial, void *context);
+
+#ifdef VEC89_FUNCTION_MACROS
+	#define vec_parallel_for_each(pool, vec_obj, function, context, threads) VEC89_PARALLEL_FOR_EACH(pool, &vec_obj, function, context, threads)
+	#define vec_parallel_transform(pool, source_obj, destination_obj, function, context, threads) VEC89_PARALLEL_TRANSFORM(pool, &source_obj, &destination_obj, function, context, threads)
+	#define vec_parallel_reduce(pool, vec_obj, result, result_size, reduce, combine, context, threads) VEC89_PARALLEL_REDUCE(pool, &vec_obj, result, result_size, reduce, combine, context, threads)
+	#define vec_parallel_sort(pool, vec_obj, compare, threads) VEC89_PARALLEL_SORT(pool, &vec_obj, compare, threads)
+#endif
+
+/*
+Starts the worker threads of a pool.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_thread_pool_p pool: Pointer to the pool. (pool != NULL)
+*size_t thread_count: Threads taking part in jobs including the caller, 0 for the number of online processors.
+*/
+char VEC89_THREAD_POOL_INITIALIZATION(vec89_thread_pool_p pool, size_t thread_count);
+
+/*
+Stops and joins the worker threads of a pool.
+
+*vec89_thread_pool_p pool: Pointer to the pool. (pool != NULL, no job running)
+*/
+void VEC89_THREAD_POOL_DESTROY(vec89_thread_pool_p pool);
+
+/*
+Calls function on every element, split into chunks that run in parallel. The function may modify the elements
+but must not call VEC89_* functions on the vector, which stays locked for the whole call.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_thread_pool_p pool: Pointer to the pool, NULL runs on the calling thread.
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_range_function function: Function called for every chunk. (function != NULL)
+*void *context: Passed to function.
+*size_t threads: Upper bound on the participating threads, 0 uses the whole pool.
+*/
+char VEC89_PARALLEL_FOR_EACH(vec89_thread_pool_p pool, vec_p vec, vec89_range_function function, void *context, size_t threads);
+
+/*
+Replaces the contents of destination with one element per source element, computed by function in parallel.
+The element sizes of the vectors may differ. Both vectors stay locked for the whole call.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_thread_pool_p pool: Pointer to the pool, NULL runs on the calling thread.
+*vec_p source: Pointer to the source vector. (source != NULL)
+*vec_p destination: Pointer to an initialized destination vector. (destination != NULL, destination != source)
+*vec89_transform_function function: Function called for every chunk. (function != NULL)
+*void *context: Passed to function.
+*size_t threads: Upper bound on the participating threads, 0 uses the whole pool.
+*/
+char VEC89_PARALLEL_TRANSFORM(vec89_thread_pool_p pool, vec_p source, vec_p destination, vec89_transform_function function, void *context, size_t threads);
+
+/*
+Reduces the vector in parallel. Every chunk is reduced into its own copy of the initial result, then the partial results
+are combined in chunk order, so the combiner has to be associative but not commutative.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_thread_pool_p pool: Pointer to the pool, NULL runs on the calling thread.
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*void *result: Holds the identity of the reduction on entry and the result on return. (result != NULL)
+*size_t result_size: Size of the result in bytes. (result_size > 0)
+*vec89_reduce_function reduce: Folds a chunk into an accumulator. (reduce != NULL)
+*vec89_combine_function combine: Folds a partial result into an accumulator. (combine != NULL)
+*void *context: Passed to reduce and combine.
+*size_t threads: Upper bound on the participating threads, 0 uses the whole pool.
+*/
+char VEC89_PARALLEL_REDUCE(vec89_thread_pool_p pool, vec_p vec, void *result, size_t result_size, vec89_reduce_function reduce, vec89_combine_function combine, void *context, size_t threads);
+
+/*
+Sorts the vector in parallel: runs are sorted with VEC89_SORT_ARRAY, then merged pairwise in rounds. Needs a temporary
+array as large as the elements, taken from the vector's allocator. Not stable.
+Returns 0 on success, non-zero error codes on failure.
+
+*vec89_thread_pool_p pool: Pointer to the pool, NULL runs on the calling thread.
+*vec_p vec: Pointer to the vector. (vec != NULL)
+*vec89_compare_function compare: Comparator of two elements. (compare != NULL)
+*size_t threads: Upper bound on the participating threads, 0 uses the whole pool.
+*/
+char VEC89_PARALLEL_SORT(vec89_thread_pool_p pool, vec_p vec, vec89_compare_function compare, size_t threads);
+
+#endif
+
+#endif /* VEC89_PARALLEL_H */
@@ -0,0 +1,189 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#ifndef VEC89_TYPED_H
+#define VEC89_TYPED_H
+
+#include "vec89.h"
+
+#include <string.h>
+
+/*
+Generates a vector type specialized for element type T.
+The generated struct only holds a generic vector as its first member, so &typed_vec.base (or a cast of the struct pointer)
+can be passed to every VEC89_* function. The generated functions use sizeof(T) as a compile-time constant, fast paths
+are plain loads and stores, only growth and vectors with a growth policy fall back to the generic functions.
+
+VEC89_DEFINE(int_vec, int) generates:
+	int_vec                                             Struct holding the generic vector as base
+	char int_vec_init(int_vec *v)                       VEC89_INITIALIZATION with sizeof(int)
+	void int_vec_array_free(int_vec *v)                 VEC89_ARRAY_FREE
+	char int_vec_push(int_vec *v, int value)            Appends value
+	char int_vec_pop(int_vec *v, int *out)              Removes the last element into out
+	char int_vec_get(int_vec *v, size_t idx, int *out)  Copies the element at idx into out
+	char int_vec_set(int_vec *v, size_t idx, int value) Overwrites the element at idx (idx < count)
+	char int_vec_insert(int_vec *v, size_t idx, int value)
+	char int_vec_remove(int_vec *v, size_t idx)
+	int *int_vec_data(int_vec *v)                       Pointer to the first element, unchecked and unlocked
+	size_t int_vec_count(int_vec *v)                    Element count, unlocked
+All functions returning char use the VEC89_* return codes.
+Writing through int_vec_data bypasses copy-on-write like VEC89_DATA, call VEC89_DETACH(&v->base) first on vectors
+that may share their array with clones or snapshots.
+
+T must be a type that can be assigned and whose name can be followed by a '*' (use a typedef for arrays and function pointers).
+*/
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	#define VEC89_TYPED_LOCK(v) VEC89_LOCK(&(v)->base.lock)
+	#define VEC89_TYPED_UNLOCK(v) VEC89_UNLOCK(&(v)->base.lock)
+	#define VEC89_TYPED_READ_LOCK(v) VEC89_READ_LOCK(&(v)->base.lock)
+	#define VEC89_TYPED_READ_UNLOCK(v) VEC89_READ_UNLOCK(&(v)->base.lock)
+#else
+	#define VEC89_TYPED_LOCK(v) ((void)0)
+	#define VEC89_TYPED_UNLOCK(v) ((void)0)
+	#define VEC89_TYPED_READ_LOCK(v) ((void)0)
+	#define VEC89_TYPED_READ_UNLOCK(v) ((void)0)
+#endif
+
+/* The fast paths bypass the generic functions, so they keep the VEC89_STATS counters themselves */
+#ifdef VEC89_STATS
+	#define VEC89_TYPED_STATS_ADD(v, Field, Amount) ((v)->base.stats.Field += (Amount))
+#else
+	#define VEC89_TYPED_STATS_ADD(v, Field, Amount) ((void)0)
+#endif
+
+/* Arrays shared by VEC89_CLONE or VEC89_SNAPSHOT take the generic functions, which copy them before writing */
+#ifdef VEC89_COPY_ON_WRITE_NOTC89
+	#define VEC89_TYPED_SHARED(v) ((v)->base.shared != NULL)
+#else
+	#define VEC89_TYPED_SHARED(v) 0
+#endif
+
+#define VEC89_DEFINE(name, T) \
+	typedef struct name { vec89 base; } name; \
+	\
+	VEC89_INLINE char name##_init(name *v) { \
+		return VEC89_INITIALIZATION(&v->base, sizeof(T)); \
+	} \
+	\
+	VEC89_INLINE void name##_array_free(name *v) { \
+		VEC89_ARRAY_FREE(&v->base); \
+	} \
+	\
+	VEC89_INLINE char name##_push(name *v, T value) { \
+		VEC89_TYPED_LOCK(v); \
+		if (v->base.arr != NULL && v->base.count < v->base.capacity && !VEC89_TYPED_SHARED(v)) { \
+			((T *)v->base.arr)[v->base.count++] = value; \
+			VEC89_TYPED_STATS_ADD(v, pushes, 1); \
+			VEC89_TYPED_UNLOCK(v); \
+			return VEC89_SUCCESS; \
+		} \
+		VEC89_TYPED_UNLOCK(v); \
+		return VEC89_PUSH(&v->base, &value); \
+	} \
+	\
+	VEC89_INLINE char name##_pop(name *v, T *out) { \
+		if (v->base.growth != NULL) return VEC89_POP_INTO(&v->base, out); \
+		VEC89_TYPED_LOCK(v); \
+		if (v->base.arr == NULL || v->base.count == 0) { \
+			VEC89_TYPED_UNLOCK(v); \
+			return v->base.arr == NULL ? VEC89_INVALID_ARGUMENTS : VEC89_ARRAY_OUT_OF_INDEX; \
+		} \
+		*out = ((T *)v->base.arr)[--v->base.count]; \
+		VEC89_TYPED_STATS_ADD(v, pops, 1); \
+		VEC89_TYPED_UNLOCK(v); \
+		return VEC89_SUCCESS; \
+	} \
+	\
+	VEC89_INLINE char name##_get(name *v, size_t idx, T *out) { \
+		VEC89_TYPED_READ_LOCK(v); \
+		if (v->base.arr == NULL || idx >= v->base.count) { \
+			VEC89_TYPED_READ_UNLOCK(v); \
+			return v->base.arr == NULL ? VEC89_INVALID_ARGUMENTS : VEC89_ARRAY_OUT_OF_INDEX; \
+		} \
+		*out = ((T *)v->base.arr)[idx]; \
+		VEC89_TYPED_READ_UNLOCK(v); \
+		return VEC89_SUCCESS; \
+	} \
+	\
+	VEC89_INLINE char name##_set(name *v, size_t idx, T value) { \
+		VEC89_TYPED_LOCK(v); \
+		if (v->base.arr == NULL || idx >= v->base.count) { \
+			VEC89_TYPED_UNLOCK(v); \
+			return v->base.arr == NULL ? VEC89_INVALID_ARGUMENTS : VEC89_ARRAY_OUT_OF_INDEX; \
+		} \
+		if (VEC89_TYPED_SHARED(v)) { \
+			VEC89_TYPED_UNLOCK(v); \
+			return VEC89_SET(&v->base, idx, &value); \
+		} \
+		((T *)v->base.arr)[idx] = value; \
+		VEC89_TYPED_UNLOCK(v); \
+		return VEC89_SUCCESS; \
+	} \
+	\
+	VEC89_INLINE char name##_insert(name *v, size_t idx, T value) { \
+		VEC89_TYPED_LOCK(v); \
+		if (v->base.arr != NULL && idx <= v->base.count && v->base.count < v->base.capacity && !VEC89_TYPED_SHARED(v)) { \
+			T *data = (T *)v->base.arr; \
+			memmove(data + idx + 1, data + idx, sizeof(T) * (v->base.count - idx)); \
+			data[idx] = value; \
+			VEC89_TYPED_STATS_ADD(v, memmove_bytes, sizeof(T) * (v->base.count - idx)); \
+			VEC89_TYPED_STATS_ADD(v, inserts, 1); \
+			v->base.count++; \
+			VEC89_TYPED_UNLOCK(v); \
+			return VEC89_SUCCESS; \
+		} \
+		VEC89_TYPED_UNLOCK(v); \
+		return VEC89_INSERT(&v->base, idx, &value); \
+	} \
+	\
+	VEC89_INLINE char name##_remove(name *v, size_t idx) { \
+		if (v->base.growth != NULL) return VEC89_REMOVE(&v->base, idx); \
+		VEC89_TYPED_LOCK(v); \
+		if (v->base.arr == NULL || idx >= v->base.count) { \
+			VEC89_TYPED_UNLOCK(v); \
+			return v->base.arr == NULL ? VEC89_INVALID_ARGUMENTS : VEC89_ARRAY_OUT_OF_INDEX; \
+		} \
+		if (VEC89_TYPED_SHARED(v)) { \
+			VEC89_TYPED_UNLOCK(v); \
+			return VEC89_REMOVE(&v->base, idx); \
+		} \
+		T *data = (T *)v->base.arr; \
+		memmove(data + idx, data + idx + 1, sizeof(T) * (v->base.count - (idx + 1))); \
+		VEC89_TYPED_STATS_ADD(v, memmove_bytes, sizeof(T) * (v->base.count - (idx + 1))); \
+		VEC89_TYPED_STATS_ADD(v, removes, 1); \
+		v->base.count--; \
+		VEC89_TYPED_UNLOCK(v); \
+		return VEC89_SUCCESS; \
+	} \
+	\
+	VEC89_INLINE T *name##_data(name *v) { \
+		return (T *)v->base.arr; \
+	} \
+	\
+	VEC89_INLINE size_t name##_count(name *v) { \
+		return v->base.count; \
+	}
+
+#endif /* VEC89_TYPED_H */
@@ -0,0 +1,61 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+#ifndef VEC89_TEST_H
+#define VEC89_TEST_H
+
+#include <stddef.h>
+
+/* Checks run and failed so far */
+extern size_t test_checks;
+extern size_t test_failures;
+
+/* Reports a failed check, the suite keeps running so one run shows every failure */
+void test_fail(const char *file, int line, const char *expression);
+
+/* Counts the check and reports it if expression is zero */
+#define TEST_CHECK(expression) do { \
+		test_checks++; \
+		if (!(expression)) test_fail(__FILE__, __LINE__, #expression); \
+	} while (0)
+
+/* Checks that a VEC89_* call returned VEC89_SUCCESS */
+#define TEST_OK(call) TEST_CHECK((call) == VEC89_SUCCESS)
+
+#define TEST_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+/* Deterministic pseudo-random numbers, the same sequence on every run */
+size_t test_random(size_t *state);
+
+/* Fills n bytes with pseudo-random bytes, each below limit so runs of equal elements appear. limit is at most 256 */
+void test_random_bytes(void *out, size_t n, unsigned limit, size_t *state);
+
+void test_vector_suite(void);
+void test_containers_suite(void);
+void test_algo_suite(void);
+void test_io_suite(void);
+void test_threads_suite(void);
+
+#endif /* VEC89_TEST_H */
\ No newline at end of file
@@ -0,0 +1,410 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+/*
+vec89_algo against reference implementations: qsort, linear scans and a sorted array kept by insertion.
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "../include/vec89_algo.h"
+
+#define TEST_ALGO_MAX_ELEMENT 64
+
+/* Element of the key sort tests: the key is stored at offset 0, seq is the original position */
+typedef struct TEST_KEYED {
+	unsigned char key[8];
+	size_t seq;
+} test_keyed;
+
+static char test_key_type;
+
+/* Key of an element widened to a double for the floating point types or to 64 bits for the integer types */
+static int test_key_order(const test_keyed *a, const test_keyed *b) {
+	switch (test_key_type) {
+		case VEC89_KEY_FLOAT:
+		case VEC89_KEY_DOUBLE: {
+			double x, y;
+			if (test_key_type == VEC89_KEY_FLOAT) {
+				float fx, fy;
+				memcpy(&fx, a->key, sizeof(float));
+				memcpy(&fy, b->key, sizeof(float));
+				x = fx;
+				y = fy;
+			} else {
+				memcpy(&x, a->key, sizeof(double));
+				memcpy(&y, b->key, sizeof(double));
+			}
+			if (x != y) return x < y ? -1 : 1;
+			/* -0.0 sorts before 0.0 */
+			return (y == 0 && 1 / y < 0) - (x == 0 && 1 / x < 0);
+		}
+		case VEC89_KEY_INT8: return (*(const signed char *)a->key > *(const signed char *)b->key) - (*(const signed char *)a->key < *(const signed char *)b->key);
+		case VEC89_KEY_UINT8: return (a->key[0] > b->key[0]) - (a->key[0] < b->key[0]);
+		case VEC89_KEY_UINT16:
+		case VEC89_KEY_UINT32:
+		case VEC89_KEY_UINT64: {
+			unsigned long long x = 0, y = 0;
+			size_t width = test_key_type == VEC89_KEY_UINT16 ? 2 : test_key_type == VEC89_KEY_UINT32 ? 4 : 8;
+			unsigned short x16, y16;
+			unsigned int x32, y32;
+			if (width == 2) { memcpy(&x16, a->key, 2); memcpy(&y16, b->key, 2); x = x16; y = y16; }
+			else if (width == 4) { memcpy(&x32, a->key, 4); memcpy(&y32, b->key, 4); x = x32; y = y32; }
+			else { memcpy(&x, a->key, 8); memcpy(&y, b->key, 8); }
+			return (x > y) - (x < y);
+		}
+		default: {
+			long long x = 0, y = 0;
+			short x16, y16;
+			int x32, y32;
+			if (test_key_type == VEC89_KEY_INT16) { memcpy(&x16, a->key, 2); memcpy(&y16, b->key, 2); x = x16; y = y16; }
+			else if (test_key_type == VEC89_KEY_INT32) { memcpy(&x32, a->key, 4); memcpy(&y32, b->key, 4); x = x32; y = y32; }
+			else { memcpy(&x, a->key, 8); memcpy(&y, b->key, 8); }
+			return (x > y) - (x < y);
+		}
+	}
+}
+
+/* Total order of the reference sort, equal keys keep their original order */
+static int test_keyed_compare(const void *a, const void *b) {
+	const test_keyed *x = a, *y = b;
+	int order = test_key_order(x, y);
+	if (order != 0) return order;
+	return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static void test_keyed_random(test_keyed *element, size_t seq, size_t *state) {
+	size_t r = test_random(state);
+	memset(element, 0, sizeof(*element));
+	element->seq = seq;
+	switch (test_key_type) {
+		case VEC89_KEY_FLOAT: {
+			float value = (float)((long)(r % 2001) - 1000) / 8.0f;
+			if (r % 50 == 0) value = -0.0f;
+			memcpy(element->key, &value, sizeof(value));
+			break;
+		}
+		case VEC89_KEY_DOUBLE: {
+			double value = (double)((long)(r % 200001) - 100000) / 16.0;
+			if (r % 50 == 0) value = -0.0;
+			memcpy(element->key, &value, sizeof(value));
+			break;
+		}
+		default:
+			/* Few distinct low bytes so equal keys are common, random high bytes so every pass runs */
+			test_random_bytes(element->key, 8, 256, state);
+			element->key[0] = (unsigned char)(r % 8);
+			break;
+	}
+}
+
+static void test_sort_key(void) {
+	static const char key_types[] = {
+		VEC89_KEY_UINT8, VEC89_KEY_UINT16, VEC89_KEY_UINT32, VEC89_KEY_UINT64, VEC89_KEY_INT8, VEC89_KEY_INT16,
+		VEC89_KEY_INT32, VEC89_KEY_INT64, VEC89_KEY_FLOAT, VEC89_KEY_DOUBLE
+	};
+	static const size_t counts[] = { 0, 1, 2, 17, 300, 5000 };
+	size_t t, c, i, state = 19;
+
+	for (t = 0; t < sizeof(key_types); t++) {
+		test_key_type = key_types[t];
+		for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+			vec89 vec;
+			test_keyed *reference = malloc((counts[c] + 1) * sizeof(test_keyed)), element;
+			TEST_CHECK(reference != NULL);
+			if (reference == NULL) return;
+
+			TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(test_keyed)));
+			for (i = 0; i < counts[c]; i++) {
+				test_keyed_random(&element, i, &state);
+				reference[i] = element;
+				TEST_OK(VEC89_PUSH(&vec, &element));
+			}
+			qsort(reference, counts[c], sizeof(test_keyed), test_keyed_compare);
+
+			TEST_OK(VEC89_SORT_KEY(&vec, 0, test_key_type));
+			TEST_CHECK(counts[c] == 0 || memcmp(vec.arr, reference, counts[c] * sizeof(test_keyed)) == 0);
+			TEST_CHECK(VEC89_SORT_KEY(&vec, sizeof(test_keyed) - 1, VEC89_KEY_UINT64) == VEC89_INVALID_ARGUMENTS);
+
+			VEC89_ARRAY_FREE(&vec);
+			free(reference);
+		}
+	}
+}
+
+static int test_int_compare(const void *a, const void *b) {
+	int x = *(const int *)a, y = *(const int *)b;
+	return (x > y) - (x < y);
+}
+
+/* Orders the keyed elements by the first key byte only, so most elements compare equal */
+static int test_first_byte_compare(const void *a, const void *b) {
+	const test_keyed *x = a, *y = b;
+	return (x->key[0] > y->key[0]) - (x->key[0] < y->key[0]);
+}
+
+#define TEST_INT_LESS(a, b) ((a) < (b))
+
+VEC89_DEFINE(test_int_vec, int)
+VEC89_DEFINE_SORT(test_int_vec, int, TEST_INT_LESS)
+
+static void test_sort(void) {
+	static const size_t counts[] = { 0, 1, 2, 3, 16, 17, 100, 1000, 20000 };
+	size_t c, i, state = 23;
+
+	for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		size_t n = counts[c], modulus;
+		int *reference = malloc((n + 1) * sizeof(int));
+		TEST_CHECK(reference != NULL);
+		if (reference == NULL) return;
+
+		/* Random, few distinct, ascending and descending inputs */
+		for (modulus = 0; modulus < 4; modulus++) {
+			vec89 vec;
+			test_int_vec typed;
+			size_t idx, expected;
+			int key, value;
+
+			TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(int)));
+			TEST_OK(test_int_vec_init(&typed));
+			for (i = 0; i < n; i++) {
+				if (modulus == 0) value = (int)(test_random(&state) % 100000) - 50000;
+				else if (modulus == 1) value = (int)(test_random(&state) % 4);
+				else if (modulus == 2) value = (int)i;
+				else value = (int)(n - i);
+				reference[i] = value;
+				TEST_OK(VEC89_PUSH(&vec, &value));
+				TEST_OK(test_int_vec_push(&typed, value));
+			}
+			qsort(reference, n, sizeof(int), test_int_compare);
+
+			TEST_OK(VEC89_SORT(&vec, test_int_compare));
+			TEST_CHECK(n == 0 || memcmp(vec.arr, reference, n * sizeof(int)) == 0);
+			TEST_OK(test_int_vec_sort(&typed));
+			TEST_CHECK(n == 0 || memcmp(test_int_vec_data(&typed), reference, n * sizeof(int)) == 0);
+
+			/* Bounds of keys below, inside and above the range */
+			for (i = 0; i < 20; i++) {
+				key = n == 0 ? 0 : reference[test_random(&state) % n] + (int)(test_random(&state) % 3) - 1;
+				for (expected = 0; expected < n && reference[expected] < key; expected++) {}
+				TEST_OK(VEC89_LOWER_BOUND(&vec, &key, test_int_compare, &idx));
+				TEST_CHECK(idx == expected);
+				TEST_OK(test_int_vec_lower_bound(&typed, key, &idx));
+				TEST_CHECK(idx == expected);
+				for (; expected < n && reference[expected] <= key; expected++) {}
+				TEST_OK(VEC89_UPPER_BOUND(&vec, &key, test_int_compare, &idx));
+				TEST_CHECK(idx == expected);
+				TEST_OK(test_int_vec_upper_bound(&typed, key, &idx));
+				TEST_CHECK(idx == expected);
+			}
+
+			VEC89_ARRAY_FREE(&vec);
+			test_int_vec_array_free(&typed);
+		}
+		free(reference);
+	}
+
+	/* Struct elements compared on one byte, so most elements are equal */
+	{
+		vec89 vec;
+		test_keyed element;
+		test_key_type = VEC89_KEY_UINT8;
+		TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(test_keyed)));
+		for (i = 0; i < 3000; i++) {
+			test_keyed_random(&element, i, &state);
+			TEST_OK(VEC89_PUSH(&vec, &element));
+		}
+		TEST_OK(VEC89_SORT(&vec, test_first_byte_compare));
+		for (i = 1; i < vec.count; i++) TEST_CHECK(VEC89_AT(&vec, test_keyed, i - 1).key[0] <= VEC89_AT(&vec, test_keyed, i).key[0]);
+		VEC89_ARRAY_FREE(&vec);
+	}
+}
+
+/* Find, count, fill and equal for every element size up to 64 bytes, on lengths around the register widths */
+static void test_scan(void) {
+	size_t size, state = 29;
+	unsigned char element[TEST_ALGO_MAX_ELEMENT], *reference = malloc(300 * TEST_ALGO_MAX_ELEMENT);
+	TEST_CHECK(reference != NULL);
+	if (reference == NULL) return;
+
+	for (size = 1; size <= TEST_ALGO_MAX_ELEMENT; size++) {
+		size_t count;
+		for (count = 0; count < 300; count += 1 + count / 8) {
+			vec89 vec, other;
+			size_t i, idx, n, expected_idx = count, expected_count = 0, result;
+			char equal;
+
+			test_random_bytes(reference, count * size, 2, &state);
+			TEST_OK(VEC89_INITIALIZATION(&vec, size));
+			TEST_OK(VEC89_PUSH_N(&vec, reference, count));
+
+			memcpy(element, count > 0 ? reference + (test_random(&state) % count) * size : reference, size);
+			if (count == 0) memset(element, 1, size);
+			for (i = 0; i < count; i++) {
+				if (memcmp(reference + i * size, element, size) != 0) continue;
+				if (expected_count++ == 0) expected_idx = i;
+			}
+			TEST_OK(VEC89_FIND(&vec, element, &result));
+			TEST_CHECK(result == expected_idx);
+			TEST_OK(VEC89_COUNT(&vec, element, &result));
+			TEST_CHECK(result == expected_count);
+
+			idx = count > 0 ? test_random(&state) % count : 0;
+			n = count - idx - (count > idx ? test_random(&state) % (count - idx) : 0);
+			test_random_bytes(element, size, 256, &state);
+			for (i = idx; i < idx + n; i++) memcpy(reference + i * size, element, size);
+			TEST_OK(VEC89_FILL(&vec, idx, n, element));
+			TEST_CHECK(count == 0 || memcmp(vec.arr, reference, count * size) == 0);
+			TEST_CHECK(VEC89_FILL(&vec, idx, count - idx + 1, element) == VEC89_ARRAY_OUT_OF_INDEX);
+
+			TEST_OK(VEC89_INITIALIZATION(&other, size));
+			TEST_OK(VEC89_PUSH_N(&other, reference, count));
+			TEST_OK(VEC89_EQUAL(&vec, &other, &equal));
+			TEST_CHECK(equal == 1);
+			if (count > 0) {
+				((unsigned char *)vec89_at(&other, count - 1))[0] ^= 0x80;
+				TEST_OK(VEC89_EQUAL(&vec, &other, &equal));
+				TEST_CHECK(equal == 0);
+			}
+
+			VEC89_ARRAY_FREE(&other);
+			VEC89_ARRAY_FREE(&vec);
+		}
+	}
+	free(reference);
+}
+
+/* Sorted vector of (key, value) pairs against an array kept sorted by insertion */
+typedef struct TEST_PAIR {
+	unsigned int key;
+	unsigned int value;
+} test_pair;
+
+static test_pair test_sorted_reference[40000];
+static size_t test_sorted_count;
+
+/* Index after every element with key, where VEC89_SORTED_INSERT_MULTI inserts */
+static size_t test_sorted_upper(unsigned int key) {
+	size_t i = test_sorted_count;
+	while (i > 0 && test_sorted_reference[i - 1].key > key) i--;
+	return i;
+}
+
+static char test_sorted_contains(unsigned int key) {
+	size_t i = test_sorted_upper(key);
+	return i > 0 && test_sorted_reference[i - 1].key == key;
+}
+
+static void test_sorted_insert(const test_pair *pair, char unique) {
+	size_t i = test_sorted_upper(pair->key);
+	if (unique && test_sorted_contains(pair->key)) return;
+	memmove(test_sorted_reference + i + 1, test_sorted_reference + i, (test_sorted_count - i) * sizeof(test_pair));
+	test_sorted_reference[i] = *pair;
+	test_sorted_count++;
+}
+
+static int test_unsigned_compare(const void *a, const void *b) {
+	unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+	return (x > y) - (x < y);
+}
+
+static void test_sorted(vec89_compare_function compare) {
+	vec89_sorted sorted;
+	test_pair pair, batch[1200];
+	size_t step, state = 31, i, begin, end, count;
+	unsigned int value = 0;
+	char inserted;
+
+	test_sorted_count = 0;
+	TEST_OK(VEC89_SORTED_INITIALIZATION(&sorted, sizeof(test_pair), offsetof(test_pair, key), VEC89_KEY_UINT32, compare, NULL));
+
+	for (step = 0; step < 600 && test_sorted_count < 30000; step++) {
+		pair.key = (unsigned int)(test_random(&state) % 2000);
+		pair.value = value++;
+
+		switch (test_random(&state) % 6) {
+			case 0:
+				count = test_sorted_contains(pair.key) ? 0 : 1;
+				TEST_OK(VEC89_SORTED_INSERT_UNIQUE(&sorted, &pair, &inserted));
+				TEST_CHECK((size_t)inserted == count);
+				test_sorted_insert(&pair, 1);
+				break;
+			case 1:
+				TEST_OK(VEC89_SORTED_INSERT_MULTI(&sorted, &pair));
+				test_sorted_insert(&pair, 0);
+				break;
+			case 2: {
+				size_t expected = 0;
+				for (i = 0; i < test_sorted_count; i++) expected += test_sorted_reference[i].key == pair.key;
+				TEST_OK(VEC89_SORTED_ERASE(&sorted, &pair.key, &count));
+				TEST_CHECK(count == expected);
+				for (i = 0, begin = 0; i < test_sorted_count; i++) {
+					if (test_sorted_reference[i].key != pair.key) test_sorted_reference[begin++] = test_sorted_reference[i];
+				}
+				test_sorted_count = begin;
+				break;
+			}
+			case 3: {
+				/* Small batches merge with a comparison sort, large ones with the radix sort */
+				size_t n = test_random(&state) % 2 == 0 ? test_random(&state) % 40 : 300 + test_random(&state) % 900;
+				char unique = (char)(test_random(&state) % 2);
+				size_t before = test_sorted_count;
+				for (i = 0; i < n; i++) {
+					batch[i].key = (unsigned int)(test_random(&state) % 2000);
+					batch[i].value = value++;
+				}
+				TEST_OK(VEC89_SORTED_MERGE(&sorted, batch, n, unique, &count));
+				for (i = 0; i < n; i++) test_sorted_insert(&batch[i], unique);
+				TEST_CHECK(count == test_sorted_count - before);
+				break;
+			}
+			default:
+				TEST_OK(VEC89_SORTED_EQUAL_RANGE(&sorted, &pair.key, &begin, &end));
+				for (i = 0; i < test_sorted_count && test_sorted_reference[i].key < pair.key; i++) {}
+				TEST_CHECK(begin == i);
+				for (; i < test_sorted_count && test_sorted_reference[i].key == pair.key; i++) {}
+				TEST_CHECK(end == i);
+				TEST_OK(VEC89_SORTED_FIND(&sorted, &pair.key, &i));
+				TEST_CHECK(i == (begin < end ? begin : sorted.vec.count));
+				break;
+		}
+		TEST_CHECK(sorted.vec.count == test_sorted_count);
+		TEST_CHECK(sorted.vec.count == test_sorted_count && (test_sorted_count == 0 ||
+			memcmp(sorted.vec.arr, test_sorted_reference, test_sorted_count * sizeof(test_pair)) == 0));
+	}
+
+	VEC89_SORTED_ARRAY_FREE(&sorted);
+}
+
+void test_algo_suite(void) {
+	test_sort();
+	test_sort_key();
+	test_scan();
+	test_sorted(NULL);
+	test_sorted(test_unsigned_compare);
+}
\ No newline at end of file
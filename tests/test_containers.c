@@ -0,0 +1,496 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+/*
+Deque, segmented, columnar and bit vectors against plain arrays.
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "test.h"
+#include "../include/vec89.h"
+
+#define TEST_CONTAINER_STEPS 6000
+#define TEST_CONTAINER_MAX_COUNT 700 /* Operations that add elements are skipped above this count */
+
+static size_t test_values[TEST_CONTAINER_MAX_COUNT + 64];
+static size_t test_count;
+
+static void test_values_insert(size_t idx, size_t value) {
+	memmove(test_values + idx + 1, test_values + idx, (test_count - idx) * sizeof(size_t));
+	test_values[idx] = value;
+	test_count++;
+}
+
+static void test_values_remove(size_t idx) {
+	memmove(test_values + idx, test_values + idx + 1, (test_count - idx - 1) * sizeof(size_t));
+	test_count--;
+}
+
+static int test_deque_matches(vec89_deque_p deque) {
+	size_t i;
+	if (deque->count != test_count) return 0;
+	for (i = 0; i < test_count; i++) {
+		void *element;
+		if (VEC89_DEQUE_GET(deque, i, &element) != VEC89_SUCCESS || *(size_t *)element != test_values[i]) return 0;
+	}
+	return 1;
+}
+
+static void test_deque(void) {
+	vec89_deque deque;
+	size_t step, state = 7, value;
+	void *arr;
+
+	test_count = 0;
+	TEST_OK(VEC89_DEQUE_INITIALIZATION(&deque, sizeof(size_t), NULL));
+	TEST_CHECK(VEC89_DEQUE_POP_FRONT(&deque, &value) == VEC89_ARRAY_OUT_OF_INDEX);
+
+	for (step = 0; step < TEST_CONTAINER_STEPS; step++) {
+		size_t idx = test_count > 0 ? test_random(&state) % test_count : 0;
+		char full = test_count >= TEST_CONTAINER_MAX_COUNT;
+		value = test_random(&state);
+
+		switch (test_random(&state) % 10) {
+			case 0:
+				if (full) break;
+				TEST_OK(VEC89_DEQUE_PUSH_BACK(&deque, &value));
+				test_values_insert(test_count, value);
+				break;
+			case 1:
+				if (full) break;
+				TEST_OK(VEC89_DEQUE_PUSH_FRONT(&deque, &value));
+				test_values_insert(0, value);
+				break;
+			case 2:
+				if (test_count == 0) break;
+				TEST_OK(VEC89_DEQUE_POP_BACK(&deque, &value));
+				TEST_CHECK(value == test_values[test_count - 1]);
+				test_count--;
+				break;
+			case 3:
+				if (test_count == 0) break;
+				TEST_OK(VEC89_DEQUE_POP_FRONT(&deque, &value));
+				TEST_CHECK(value == test_values[0]);
+				test_values_remove(0);
+				break;
+			case 4:
+				if (full) break;
+				idx = test_random(&state) % (test_count + 1);
+				TEST_OK(VEC89_DEQUE_INSERT(&deque, idx, &value));
+				test_values_insert(idx, value);
+				break;
+			case 5:
+				if (test_count == 0) break;
+				TEST_OK(VEC89_DEQUE_REMOVE(&deque, idx));
+				test_values_remove(idx);
+				break;
+			case 6:
+				if (test_count == 0) break;
+				TEST_OK(VEC89_DEQUE_SET(&deque, idx, &value));
+				test_values[idx] = value;
+				break;
+			case 7:
+				TEST_OK(VEC89_DEQUE_LINEARIZE(&deque, &arr));
+				TEST_CHECK(test_count == 0 || memcmp(arr, test_values, test_count * sizeof(size_t)) == 0);
+				break;
+			case 8:
+				TEST_OK(VEC89_DEQUE_RESERVE(&deque, test_count + value % 100));
+				TEST_CHECK(deque.capacity >= test_count && (deque.capacity & (deque.capacity - 1)) == 0);
+				break;
+			default:
+				if (value % 64 != 0) break;
+				TEST_OK(VEC89_DEQUE_CLEAR(&deque));
+				test_count = 0;
+				break;
+		}
+		TEST_CHECK(VEC89_DEQUE_SET(&deque, test_count, &value) == VEC89_ARRAY_OUT_OF_INDEX);
+		if (step % 16 == 0) TEST_CHECK(test_deque_matches(&deque));
+	}
+	TEST_CHECK(test_deque_matches(&deque));
+
+	VEC89_DEQUE_ARRAY_FREE(&deque);
+}
+
+static int test_segmented_matches(vec89_segmented_p vec) {
+	size_t segment, total = 0, n;
+	void *elements;
+	if (vec->count != test_count) return 0;
+	for (segment = 0; VEC89_SEGMENTED_SEGMENT(vec, segment, &elements, &n) == VEC89_SUCCESS; segment++) {
+		if (total + n > test_count || memcmp(elements, test_values + total, n * sizeof(size_t)) != 0) return 0;
+		total += n;
+	}
+	return total == test_count;
+}
+
+static void test_segmented(void) {
+	vec89_segmented vec;
+	size_t step, state = 11, value, first = 0;
+	size_t *first_element = NULL;
+
+	test_count = 0;
+	TEST_OK(VEC89_SEGMENTED_INITIALIZATION(&vec, sizeof(size_t), NULL));
+
+	for (step = 0; step < TEST_CONTAINER_STEPS; step++) {
+		size_t idx = test_count > 0 ? test_random(&state) % test_count : 0, batch[8];
+		char full = test_count >= TEST_CONTAINER_MAX_COUNT;
+		void *element;
+		value = test_random(&state);
+
+		switch (test_random(&state) % 10) {
+			case 0:
+			case 1:
+				if (full) break;
+				TEST_OK(VEC89_SEGMENTED_PUSH(&vec, &value));
+				test_values_insert(test_count, value);
+				break;
+			case 2:
+				if (full) break;
+				for (idx = 0; idx < 8; idx++) batch[idx] = value + idx;
+				TEST_OK(VEC89_SEGMENTED_PUSH_N(&vec, batch, 8));
+				for (idx = 0; idx < 8; idx++) test_values_insert(test_count, batch[idx]);
+				break;
+			case 3:
+				if (test_count == 0) {
+					TEST_CHECK(VEC89_SEGMENTED_POP_INTO(&vec, &value) == VEC89_ARRAY_OUT_OF_INDEX);
+					break;
+				}
+				TEST_OK(VEC89_SEGMENTED_POP_INTO(&vec, &value));
+				TEST_CHECK(value == test_values[test_count - 1]);
+				test_count--;
+				break;
+			case 4:
+				if (full) break;
+				idx = test_random(&state) % (test_count + 1);
+				TEST_OK(VEC89_SEGMENTED_INSERT(&vec, idx, &value));
+				test_values_insert(idx, value);
+				break;
+			case 5:
+				if (test_count == 0) break;
+				TEST_OK(VEC89_SEGMENTED_REMOVE(&vec, idx));
+				test_values_remove(idx);
+				break;
+			case 6:
+				if (test_count == 0) break;
+				TEST_OK(VEC89_SEGMENTED_SET(&vec, idx, &value));
+				test_values[idx] = value;
+				break;
+			case 7:
+				if (test_count == 0) break;
+				TEST_OK(VEC89_SEGMENTED_GET_COPY(&vec, idx, &value));
+				TEST_CHECK(value == test_values[idx]);
+				TEST_OK(VEC89_SEGMENTED_GET(&vec, idx, &element));
+				TEST_CHECK(*(size_t *)element == test_values[idx]);
+				break;
+			case 8:
+				if (value % 2 == 0) TEST_OK(VEC89_SEGMENTED_RESERVE(&vec, test_count + value % 300));
+				else TEST_OK(VEC89_SEGMENTED_SHRINK_TO_FIT(&vec));
+				TEST_CHECK(vec.capacity >= test_count);
+				break;
+			default:
+				if (value % 64 != 0) break;
+				TEST_OK(VEC89_SEGMENTED_CLEAR(&vec));
+				test_count = 0;
+				break;
+		}
+		TEST_CHECK(VEC89_SEGMENTED_GET(&vec, test_count, &element) == VEC89_ARRAY_OUT_OF_INDEX);
+		if (step % 16 == 0) TEST_CHECK(test_segmented_matches(&vec));
+	}
+	TEST_CHECK(test_segmented_matches(&vec));
+	VEC89_SEGMENTED_ARRAY_FREE(&vec);
+
+	/* Pushing never moves existing elements */
+	TEST_OK(VEC89_SEGMENTED_INITIALIZATION(&vec, sizeof(size_t), NULL));
+	for (value = 0; value < 10000; value++) {
+		TEST_OK(VEC89_SEGMENTED_PUSH(&vec, &value));
+		if (value == 0) {
+			void *element;
+			TEST_OK(VEC89_SEGMENTED_GET(&vec, 0, &element));
+			first_element = element;
+		}
+	}
+	TEST_CHECK(first_element != NULL && *first_element == first);
+	if (first_element != NULL) {
+		void *element;
+		TEST_OK(VEC89_SEGMENTED_GET(&vec, 0, &element));
+		TEST_CHECK(element == (void *)first_element);
+	}
+	VEC89_SEGMENTED_ARRAY_FREE(&vec);
+}
+
+/* Row of the columnar vector test, padded so rows have bytes that belong to no field */
+typedef struct TEST_RECORD {
+	int key;
+	char tag;
+	double weight;
+} test_record;
+
+static const vec89_soa_field test_record_fields[3] = {
+	{ offsetof(test_record, key), sizeof(int) },
+	{ offsetof(test_record, tag), sizeof(char) },
+	{ offsetof(test_record, weight), sizeof(double) }
+};
+
+static test_record test_rows[TEST_CONTAINER_MAX_COUNT + 64];
+static size_t test_row_count;
+
+static int test_record_equal(const test_record *a, const test_record *b) {
+	return a->key == b->key && a->tag == b->tag && a->weight == b->weight;
+}
+
+static test_record test_record_random(size_t *state) {
+	test_record record;
+	memset(&record, 0, sizeof(record));
+	record.key = (int)(test_random(state) % 1000) - 500;
+	record.tag = (char)(test_random(state) % 100);
+	record.weight = (double)(test_random(state) % 4096) / 8.0;
+	return record;
+}
+
+static int test_soa_matches(vec89_soa_p soa) {
+	vec89_view views[3];
+	size_t i;
+	int equal = soa->count == test_row_count;
+	if (VEC89_SOA_VIEW(soa, 0, VEC89_VIEW_END_OF_VECTOR, 0, views) != VEC89_SUCCESS) return 0;
+	for (i = 0; equal && i < views[0].count; i++) {
+		equal = VEC89_VIEW_AT(&views[0], int, i) == test_rows[i].key && VEC89_VIEW_AT(&views[1], char, i) == test_rows[i].tag &&
+			VEC89_VIEW_AT(&views[2], double, i) == test_rows[i].weight;
+	}
+	VEC89_SOA_VIEW_RELEASE(soa, views);
+	return equal;
+}
+
+static void test_soa(void) {
+	vec89_soa soa;
+	test_record record, batch[6];
+	size_t step, state = 13, i;
+
+	test_row_count = 0;
+	TEST_OK(VEC89_SOA_INITIALIZATION(&soa, test_record_fields, 3, sizeof(test_record), NULL));
+
+	for (step = 0; step < TEST_CONTAINER_STEPS / 2; step++) {
+		size_t idx = test_row_count > 0 ? test_random(&state) % test_row_count : 0, n = test_random(&state) % 6;
+		char full = test_row_count >= TEST_CONTAINER_MAX_COUNT;
+		record = test_record_random(&state);
+		for (i = 0; i < 6; i++) batch[i] = test_record_random(&state);
+
+		switch (test_random(&state) % 10) {
+			case 0:
+				if (full) break;
+				TEST_OK(VEC89_SOA_PUSH(&soa, &record));
+				test_rows[test_row_count++] = record;
+				break;
+			case 1:
+				if (full) break;
+				TEST_OK(VEC89_SOA_PUSH_N(&soa, batch, n));
+				memcpy(test_rows + test_row_count, batch, n * sizeof(test_record));
+				test_row_count += n;
+				break;
+			case 2:
+				if (test_row_count == 0) break;
+				TEST_OK(VEC89_SOA_POP_INTO(&soa, &record));
+				TEST_CHECK(test_record_equal(&record, &test_rows[--test_row_count]));
+				break;
+			case 3:
+				if (full) break;
+				idx = test_random(&state) % (test_row_count + 1);
+				TEST_OK(VEC89_SOA_INSERT(&soa, idx, &record));
+				memmove(test_rows + idx + 1, test_rows + idx, (test_row_count - idx) * sizeof(test_record));
+				test_rows[idx] = record;
+				test_row_count++;
+				break;
+			case 4:
+				if (test_row_count == 0) break;
+				TEST_OK(VEC89_SOA_REMOVE(&soa, idx));
+				memmove(test_rows + idx, test_rows + idx + 1, (test_row_count - idx - 1) * sizeof(test_record));
+				test_row_count--;
+				break;
+			case 5:
+				if (test_row_count == 0) break;
+				TEST_OK(VEC89_SOA_SET(&soa, idx, &record));
+				test_rows[idx] = record;
+				TEST_OK(VEC89_SOA_GET(&soa, idx, &record));
+				TEST_CHECK(test_record_equal(&record, &test_rows[idx]));
+				break;
+			case 6:
+				if (test_row_count == 0) break;
+				TEST_OK(VEC89_SOA_SET_FIELD(&soa, idx, 2, &record.weight));
+				test_rows[idx].weight = record.weight;
+				TEST_OK(VEC89_SOA_GET_FIELD(&soa, idx, 0, &record.key));
+				TEST_CHECK(record.key == test_rows[idx].key);
+				break;
+			case 7:
+				n = TEST_MIN(n, test_row_count - idx);
+				TEST_OK(VEC89_SOA_SCATTER(&soa, idx, batch, n));
+				memcpy(test_rows + idx, batch, n * sizeof(test_record));
+				TEST_OK(VEC89_SOA_GATHER(&soa, idx, batch, n));
+				for (i = 0; i < n; i++) TEST_CHECK(test_record_equal(&batch[i], &test_rows[idx + i]));
+				TEST_CHECK(VEC89_SOA_GATHER(&soa, test_row_count, batch, 1) == VEC89_ARRAY_OUT_OF_INDEX);
+				break;
+			case 8:
+				TEST_OK(VEC89_SOA_RESERVE(&soa, test_row_count + n * 10));
+				break;
+			default:
+				if (test_random(&state) % 32 != 0) break;
+				TEST_OK(VEC89_SOA_CLEAR(&soa));
+				test_row_count = 0;
+				break;
+		}
+		if (step % 8 == 0) TEST_CHECK(test_soa_matches(&soa));
+	}
+	TEST_CHECK(test_soa_matches(&soa));
+
+	VEC89_SOA_ARRAY_FREE(&soa);
+}
+
+static unsigned char test_bits[4 * TEST_CONTAINER_MAX_COUNT];
+static unsigned char test_other_bits[4 * TEST_CONTAINER_MAX_COUNT];
+static size_t test_bit_count;
+
+static int test_bits_matches(vec89_bits_p bits) {
+	size_t i, words = (test_bit_count + VEC89_BITS_PER_WORD - 1) / VEC89_BITS_PER_WORD;
+	if (bits->count != test_bit_count) return 0;
+	for (i = 0; i < test_bit_count; i++) {
+		char value;
+		if (VEC89_BITS_GET(bits, i, &value) != VEC89_SUCCESS || value != test_bits[i]) return 0;
+	}
+	/* The bits past count stay zero */
+	if (test_bit_count % VEC89_BITS_PER_WORD != 0 && (bits->words[words - 1] >> (test_bit_count % VEC89_BITS_PER_WORD)) != 0) return 0;
+	return 1;
+}
+
+static void test_bit_vector(void) {
+	vec89_bits bits, other;
+	size_t step, state = 17, i, n, expected, found;
+	char value;
+
+	test_bit_count = 0;
+	TEST_OK(VEC89_BITS_INITIALIZATION(&bits, NULL));
+	TEST_OK(VEC89_BITS_INITIALIZATION(&other, NULL));
+
+	for (step = 0; step < TEST_CONTAINER_STEPS; step++) {
+		size_t idx = test_bit_count > 0 ? test_random(&state) % test_bit_count : 0;
+		char full = test_bit_count >= 3 * TEST_CONTAINER_MAX_COUNT;
+		value = (char)(test_random(&state) % 2);
+
+		switch (test_random(&state) % 12) {
+			case 0:
+			case 1:
+				if (full) break;
+				TEST_OK(VEC89_BITS_PUSH(&bits, value));
+				test_bits[test_bit_count++] = (unsigned char)value;
+				break;
+			case 2:
+				if (test_bit_count == 0) {
+					TEST_CHECK(VEC89_BITS_POP(&bits, &value) == VEC89_ARRAY_OUT_OF_INDEX);
+					break;
+				}
+				TEST_OK(VEC89_BITS_POP(&bits, &value));
+				TEST_CHECK(value == test_bits[--test_bit_count]);
+				break;
+			case 3:
+				if (full) break;
+				idx = test_random(&state) % (test_bit_count + 1);
+				TEST_OK(VEC89_BITS_INSERT(&bits, idx, value));
+				memmove(test_bits + idx + 1, test_bits + idx, test_bit_count - idx);
+				test_bits[idx] = (unsigned char)value;
+				test_bit_count++;
+				break;
+			case 4:
+				if (test_bit_count == 0) break;
+				TEST_OK(VEC89_BITS_REMOVE(&bits, idx));
+				memmove(test_bits + idx, test_bits + idx + 1, test_bit_count - idx - 1);
+				test_bit_count--;
+				break;
+			case 5:
+				if (test_bit_count == 0) break;
+				TEST_OK(VEC89_BITS_SET(&bits, idx, value));
+				test_bits[idx] = (unsigned char)value;
+				break;
+			case 6:
+				n = test_random(&state) % (3 * TEST_CONTAINER_MAX_COUNT);
+				TEST_OK(VEC89_BITS_RESIZE(&bits, n, value));
+				if (n > test_bit_count) memset(test_bits + test_bit_count, value, n - test_bit_count);
+				test_bit_count = n;
+				break;
+			case 7:
+			case 8: {
+				char operation = (char)(test_random(&state) % 3);
+				TEST_OK(VEC89_BITS_RESIZE(&other, 0, 0));
+				for (i = 0; i < test_bit_count; i++) {
+					test_other_bits[i] = (unsigned char)(test_random(&state) % 2);
+					TEST_OK(VEC89_BITS_PUSH(&other, (char)test_other_bits[i]));
+				}
+				if (operation == 0) TEST_OK(VEC89_BITS_AND(&bits, &other));
+				else if (operation == 1) TEST_OK(VEC89_BITS_OR(&bits, &other));
+				else TEST_OK(VEC89_BITS_XOR(&bits, &other));
+				for (i = 0; i < test_bit_count; i++) {
+					if (operation == 0) test_bits[i] &= test_other_bits[i];
+					else if (operation == 1) test_bits[i] |= test_other_bits[i];
+					else test_bits[i] ^= test_other_bits[i];
+				}
+				TEST_OK(VEC89_BITS_PUSH(&other, 1));
+				TEST_CHECK(VEC89_BITS_AND(&bits, &other) == VEC89_INVALID_ARGUMENTS);
+				break;
+			}
+			case 9:
+				TEST_OK(VEC89_BITS_NOT(&bits));
+				for (i = 0; i < test_bit_count; i++) test_bits[i] ^= 1;
+				break;
+			case 10:
+				idx = test_random(&state) % (test_bit_count + 1);
+				for (i = 0, expected = 0; i < idx; i++) expected += test_bits[i];
+				TEST_OK(VEC89_BITS_RANK(&bits, idx, &found));
+				TEST_CHECK(found == expected);
+				for (; i < test_bit_count; i++) expected += test_bits[i];
+				TEST_OK(VEC89_BITS_POPCOUNT(&bits, &found));
+				TEST_CHECK(found == expected);
+				break;
+			default:
+				/* Walks every set bit */
+				TEST_OK(VEC89_BITS_FIND_FIRST_SET(&bits, &found));
+				for (i = 0; i <= test_bit_count; i++) {
+					if (i < test_bit_count && !test_bits[i]) continue;
+					TEST_CHECK(found == i);
+					if (found >= test_bit_count) break;
+					TEST_OK(VEC89_BITS_FIND_NEXT_SET(&bits, found + 1, &found));
+				}
+				break;
+		}
+		if (step % 16 == 0) TEST_CHECK(test_bits_matches(&bits));
+	}
+	TEST_CHECK(test_bits_matches(&bits));
+
+	VEC89_BITS_ARRAY_FREE(&other);
+	VEC89_BITS_ARRAY_FREE(&bits);
+}
+
+void test_containers_suite(void) {
+	test_deque();
+	test_segmented();
+	test_soa();
+	test_bit_vector();
+}
\ No newline at end of file
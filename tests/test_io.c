@@ -0,0 +1,421 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+/*
+Stream round trips, damaged streams, and with VEC89_FILE_BACKED_NOTC89 and VEC89_MMAP_NOTC89 vectors in files and mappings.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "../include/vec89_algo.h"
+#include "../include/vec89_io.h"
+
+#ifdef VEC89_FILE_BACKED_NOTC89
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+/* Writes vec to a temporary file and returns it rewound, NULL if the write failed */
+static FILE *test_write_temporary(vec_p vec, size_t flags) {
+	FILE *file = tmpfile();
+	TEST_CHECK(file != NULL);
+	if (file == NULL) return NULL;
+	TEST_OK(VEC89_WRITE(vec, file, flags));
+	rewind(file);
+	return file;
+}
+
+static long test_file_size(FILE *file) {
+	long size;
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	rewind(file);
+	return size;
+}
+
+static void test_round_trip(void) {
+	/* 200000 elements of 12 bytes span three chunks */
+	static const size_t counts[] = { 0, 1, 1000, 200000 };
+	size_t c, flags, i, state = 37;
+
+	for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		for (flags = 0; flags <= VEC89_IO_CHECKSUM; flags++) {
+			vec89 vec, copy;
+			unsigned char element[12];
+			char equal;
+			FILE *file;
+
+			TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(element)));
+			for (i = 0; i < counts[c]; i++) {
+				test_random_bytes(element, sizeof(element), 256, &state);
+				TEST_OK(VEC89_PUSH(&vec, element));
+			}
+
+			file = test_write_temporary(&vec, flags);
+			if (file == NULL) return;
+
+			/* Reading appends to the elements already in the vector */
+			TEST_OK(VEC89_INITIALIZATION(&copy, sizeof(element)));
+			memset(element, 0xAB, sizeof(element));
+			TEST_OK(VEC89_PUSH(&copy, element));
+			TEST_OK(VEC89_READ(&copy, file));
+			TEST_OK(VEC89_REMOVE(&copy, 0));
+			TEST_OK(VEC89_EQUAL(&vec, &copy, &equal));
+			TEST_CHECK(equal == 1);
+			VEC89_ARRAY_FREE(&copy);
+
+			/* Streams longer than a chunk grow up to exactly their count */
+			rewind(file);
+			TEST_OK(VEC89_INITIALIZATION(&copy, sizeof(element)));
+			TEST_OK(VEC89_READ(&copy, file));
+			TEST_CHECK(copy.count == counts[c] && (counts[c] < 1000 || copy.capacity == counts[c]));
+
+			fclose(file);
+			VEC89_ARRAY_FREE(&copy);
+			VEC89_ARRAY_FREE(&vec);
+		}
+	}
+}
+
+/* A stream of unknown length written chunk by chunk and read chunk by chunk */
+static void test_stream_chunks(void) {
+	vec89 vec;
+	vec89_stream stream;
+	size_t values[100], i, chunk, appended, total = 0;
+	FILE *file = tmpfile();
+	TEST_CHECK(file != NULL);
+	if (file == NULL) return;
+
+	TEST_OK(VEC89_STREAM_OPEN_FILE(&stream, file));
+	TEST_OK(VEC89_STREAM_WRITE_HEADER(&stream, sizeof(size_t), VEC89_IO_UNKNOWN_COUNT, VEC89_IO_CHECKSUM));
+	for (chunk = 0; chunk < 10; chunk++) {
+		for (i = 0; i < 100; i++) values[i] = chunk * 100 + i;
+		TEST_OK(VEC89_STREAM_WRITE_CHUNK(&stream, values, chunk * 10));
+	}
+	TEST_OK(VEC89_STREAM_WRITE_END(&stream));
+	TEST_CHECK(VEC89_STREAM_WRITE_CHUNK(&stream, values, 1) == VEC89_INVALID_ARGUMENTS);
+	rewind(file);
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(size_t)));
+	TEST_OK(VEC89_STREAM_OPEN_FILE(&stream, file));
+	TEST_OK(VEC89_STREAM_READ_HEADER(&stream));
+	TEST_CHECK(stream.elem_size == sizeof(size_t) && stream.count == VEC89_IO_UNKNOWN_COUNT && stream.flags == VEC89_IO_CHECKSUM);
+	for (chunk = 1; chunk < 10; chunk++) {
+		TEST_OK(VEC89_STREAM_READ_CHUNK(&vec, &stream, &appended));
+		TEST_CHECK(appended == chunk * 10);
+		for (i = 0; i < appended; i++) TEST_CHECK(VEC89_AT(&vec, size_t, total + i) == chunk * 100 + i);
+		total += appended;
+	}
+	TEST_OK(VEC89_STREAM_READ_CHUNK(&vec, &stream, &appended));
+	TEST_CHECK(appended == 0 && stream.finished && vec.count == total);
+
+	fclose(file);
+	VEC89_ARRAY_FREE(&vec);
+}
+
+/* Writes the stream in bytes to a temporary file and reads it into a new vector of size_t, returns the result */
+static char test_read_bytes(const unsigned char *bytes, size_t size, vec_p out_vec) {
+	char result;
+	FILE *file = tmpfile();
+	if (file == NULL) return VEC89_FAILURE;
+	fwrite(bytes, 1, size, file);
+	rewind(file);
+	result = VEC89_INITIALIZATION(out_vec, sizeof(size_t));
+	if (result == VEC89_SUCCESS) result = VEC89_READ(out_vec, file);
+	fclose(file);
+	return result;
+}
+
+/* Headers are not trusted: counts that the chunks don't add up to and unknown flags fail, huge counts reserve little */
+static void test_untrusted_headers(void) {
+	vec89 vec, copy;
+	vec89_stream stream;
+	size_t i;
+	long size;
+	unsigned char *bytes;
+	FILE *file;
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(size_t)));
+	for (i = 0; i < 1000; i++) TEST_OK(VEC89_PUSH(&vec, &i));
+	file = test_write_temporary(&vec, 0);
+	if (file == NULL) return;
+	size = test_file_size(file);
+	bytes = malloc((size_t)size);
+	TEST_CHECK(bytes != NULL && fread(bytes, 1, (size_t)size, file) == (size_t)size);
+	if (bytes == NULL) return;
+
+	/* The count is at byte 24 of the header, little-endian */
+	bytes[24] = 1000 % 256 + 1;
+	TEST_CHECK(test_read_bytes(bytes, (size_t)size, &copy) == VEC89_FAILURE);
+	VEC89_ARRAY_FREE(&copy);
+	bytes[24] = 1000 % 256 - 1;
+	TEST_CHECK(test_read_bytes(bytes, (size_t)size, &copy) == VEC89_FAILURE);
+	VEC89_ARRAY_FREE(&copy);
+
+	/* A header claiming 2^40 elements in front of 1000 */
+	bytes[24] = 1000 % 256;
+	bytes[29] = 1;
+	TEST_CHECK(test_read_bytes(bytes, (size_t)size, &copy) == VEC89_FAILURE);
+	TEST_CHECK(copy.count == 1000 && copy.capacity <= 2 * VEC89_IO_CHUNK_SIZE / sizeof(size_t));
+	VEC89_ARRAY_FREE(&copy);
+	bytes[29] = 0;
+
+	/* Flags are at byte 12 */
+	bytes[12] = 0x02;
+	TEST_CHECK(test_read_bytes(bytes, (size_t)size, &copy) == VEC89_FAILURE);
+	TEST_CHECK(copy.count == 0);
+	VEC89_ARRAY_FREE(&copy);
+	bytes[12] = 0;
+	TEST_OK(test_read_bytes(bytes, (size_t)size, &copy));
+	TEST_CHECK(copy.count == 1000);
+	VEC89_ARRAY_FREE(&copy);
+
+	/* The writer keeps to its own header */
+	rewind(file);
+	TEST_OK(VEC89_STREAM_OPEN_FILE(&stream, file));
+	TEST_CHECK(VEC89_STREAM_WRITE_HEADER(&stream, sizeof(size_t), 10, 0x02) == VEC89_INVALID_ARGUMENTS);
+	TEST_OK(VEC89_STREAM_WRITE_HEADER(&stream, sizeof(size_t), 10, 0));
+	TEST_OK(VEC89_STREAM_WRITE_CHUNK(&stream, vec.arr, 6));
+	TEST_CHECK(VEC89_STREAM_WRITE_CHUNK(&stream, vec.arr, 5) == VEC89_INVALID_ARGUMENTS);
+	TEST_CHECK(VEC89_STREAM_WRITE_END(&stream) == VEC89_INVALID_ARGUMENTS);
+	TEST_OK(VEC89_STREAM_WRITE_CHUNK(&stream, vec.arr, 4));
+	TEST_OK(VEC89_STREAM_WRITE_END(&stream));
+
+	free(bytes);
+	fclose(file);
+	VEC89_ARRAY_FREE(&vec);
+}
+
+/* Truncated streams, damaged chunks and mismatched element sizes fail without appending the damaged chunk */
+static void test_damaged_streams(void) {
+	vec89 vec, copy;
+	size_t i;
+	long size, cut;
+	unsigned char *bytes;
+	FILE *file, *damaged;
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(size_t)));
+	for (i = 0; i < 1000; i++) TEST_OK(VEC89_PUSH(&vec, &i));
+	file = test_write_temporary(&vec, VEC89_IO_CHECKSUM);
+	if (file == NULL) return;
+	size = test_file_size(file);
+	bytes = malloc((size_t)size);
+	TEST_CHECK(bytes != NULL && fread(bytes, 1, (size_t)size, file) == (size_t)size);
+	if (bytes == NULL) return;
+
+	/* Every cut before the end chunk is complete is an error */
+	for (cut = 0; cut < size; cut += cut < 64 ? 1 : 997) {
+		damaged = tmpfile();
+		fwrite(bytes, 1, (size_t)cut, damaged);
+		rewind(damaged);
+		TEST_OK(VEC89_INITIALIZATION(&copy, sizeof(size_t)));
+		TEST_CHECK(VEC89_READ(&copy, damaged) == VEC89_FAILURE);
+		TEST_CHECK(copy.count == 0);
+		VEC89_ARRAY_FREE(&copy);
+		fclose(damaged);
+	}
+
+	/* A flipped payload byte fails the checksum */
+	bytes[size / 2] ^= 0x01;
+	damaged = tmpfile();
+	fwrite(bytes, 1, (size_t)size, damaged);
+	rewind(damaged);
+	TEST_OK(VEC89_INITIALIZATION(&copy, sizeof(size_t)));
+	TEST_CHECK(VEC89_READ(&copy, damaged) == VEC89_FAILURE);
+	TEST_CHECK(copy.count == 0);
+	VEC89_ARRAY_FREE(&copy);
+	fclose(damaged);
+
+	/* A different element size or magic */
+	rewind(file);
+	TEST_OK(VEC89_INITIALIZATION(&copy, sizeof(int)));
+	TEST_CHECK(VEC89_READ(&copy, file) == VEC89_FAILURE);
+	VEC89_ARRAY_FREE(&copy);
+	bytes[size / 2] ^= 0x01;
+	bytes[0] = 'X';
+	damaged = tmpfile();
+	fwrite(bytes, 1, (size_t)size, damaged);
+	rewind(damaged);
+	TEST_OK(VEC89_INITIALIZATION(&copy, sizeof(size_t)));
+	TEST_CHECK(VEC89_READ(&copy, damaged) == VEC89_FAILURE);
+	VEC89_ARRAY_FREE(&copy);
+	fclose(damaged);
+
+	free(bytes);
+	fclose(file);
+	VEC89_ARRAY_FREE(&vec);
+}
+
+/* Chunks larger than VEC89_IO_CHUNK_SIZE are read in pieces, a chunk's count alone never sizes the allocation */
+static void test_oversized_chunks(void) {
+	vec89 vec, copy;
+	vec89_stream stream;
+	size_t i, n = 3 * VEC89_IO_CHUNK_SIZE / sizeof(size_t) + 5, byte;
+	unsigned char chunk_header[16];
+	char equal = 0;
+	long size;
+	unsigned char *bytes;
+	FILE *file;
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(size_t)));
+	for (i = 0; i < n; i++) TEST_OK(VEC89_PUSH(&vec, &i));
+	file = tmpfile();
+	TEST_CHECK(file != NULL);
+	if (file == NULL) return;
+	TEST_OK(VEC89_STREAM_OPEN_FILE(&stream, file));
+	TEST_OK(VEC89_STREAM_WRITE_HEADER(&stream, sizeof(size_t), VEC89_IO_UNKNOWN_COUNT, VEC89_IO_CHECKSUM));
+	TEST_OK(VEC89_STREAM_WRITE_CHUNK(&stream, vec.arr, n));
+	TEST_OK(VEC89_STREAM_WRITE_END(&stream));
+	size = test_file_size(file);
+	bytes = malloc((size_t)size);
+	TEST_CHECK(bytes != NULL && fread(bytes, 1, (size_t)size, file) == (size_t)size);
+	if (bytes == NULL) return;
+	fclose(file);
+
+	/* One chunk of several pieces, the checksum runs across them */
+	TEST_OK(test_read_bytes(bytes, (size_t)size, &copy));
+	TEST_OK(VEC89_EQUAL(&vec, &copy, &equal));
+	TEST_CHECK(copy.count == n && equal);
+	VEC89_ARRAY_FREE(&copy);
+	bytes[size - 20] ^= 0x01;
+	TEST_CHECK(test_read_bytes(bytes, (size_t)size, &copy) == VEC89_FAILURE);
+	TEST_CHECK(copy.count == 0);
+	VEC89_ARRAY_FREE(&copy);
+	free(bytes);
+
+	/* A header and a chunk both claiming 2^30 and 2^34 elements in front of 4 bytes, with a known and an unknown count */
+	for (i = 0; i < 4; i++) {
+		size_t claimed = (size_t)1 << (i % 2 ? 30 : (sizeof(size_t) > 4 ? 34 : 31));
+		file = tmpfile();
+		TEST_CHECK(file != NULL);
+		if (file == NULL) break;
+		TEST_OK(VEC89_STREAM_OPEN_FILE(&stream, file));
+		TEST_OK(VEC89_STREAM_WRITE_HEADER(&stream, sizeof(size_t), i < 2 ? claimed : VEC89_IO_UNKNOWN_COUNT, 0));
+		memset(chunk_header, 0, sizeof(chunk_header));
+		for (byte = 0; byte < 8; byte++) chunk_header[byte] = (unsigned char)((claimed >> (byte * 8)) & 0xFF);
+		fwrite(chunk_header, 1, sizeof(chunk_header), file);
+		rewind(file);
+
+		TEST_OK(VEC89_INITIALIZATION(&copy, sizeof(size_t)));
+		TEST_CHECK(VEC89_READ(&copy, file) == VEC89_FAILURE);
+		TEST_CHECK(copy.count == 0 && copy.capacity <= 2 * VEC89_IO_CHUNK_SIZE / sizeof(size_t));
+		VEC89_ARRAY_FREE(&copy);
+		fclose(file);
+	}
+
+	VEC89_ARRAY_FREE(&vec);
+}
+
+#ifdef VEC89_FILE_BACKED_NOTC89
+static void test_file_backed(void) {
+	char path[] = "/tmp/vec89_test_XXXXXX";
+	vec89 vec;
+	size_t i, value;
+	pid_t child;
+	int fd = mkstemp(path);
+	TEST_CHECK(fd >= 0);
+	if (fd < 0) return;
+	close(fd);
+
+	TEST_OK(VEC89_FILE_OPEN(&vec, path, sizeof(size_t), VEC89_FILE_CREATE));
+	for (i = 0; i < 50000; i++) TEST_OK(VEC89_PUSH(&vec, &i));
+	TEST_OK(VEC89_REMOVE_RANGE(&vec, 100, 100));
+	TEST_OK(VEC89_FILE_SYNC(&vec));
+	VEC89_ARRAY_FREE(&vec);
+
+	TEST_OK(VEC89_FILE_OPEN(&vec, path, 0, VEC89_FILE_READ_ONLY));
+	TEST_CHECK(vec.elem_size == sizeof(size_t) && vec.count == 49900);
+	for (i = 0; i < vec.count; i++) TEST_CHECK(VEC89_AT(&vec, size_t, i) == (i < 100 ? i : i + 100));
+	/* Read-only changes stay private and can't grow the vector */
+	value = 7;
+	TEST_OK(VEC89_SET(&vec, 0, &value));
+	VEC89_ARRAY_FREE(&vec);
+
+	TEST_OK(VEC89_FILE_OPEN(&vec, path, sizeof(size_t), VEC89_FILE_READ_WRITE));
+	TEST_CHECK(vec.count == 49900 && VEC89_AT(&vec, size_t, 0) == 0);
+	VEC89_ARRAY_FREE(&vec);
+
+	TEST_CHECK(VEC89_FILE_OPEN(&vec, path, sizeof(int), VEC89_FILE_READ_WRITE) == VEC89_FAILURE);
+
+	/* A process that shrinks the file below the count of its last sync and dies before the next one leaves a file that opens */
+	child = fork();
+	TEST_CHECK(child >= 0);
+	if (child == 0) {
+		if (VEC89_FILE_OPEN(&vec, path, sizeof(size_t), VEC89_FILE_CREATE) != VEC89_SUCCESS) _exit(1);
+		for (i = 0; i < 1000; i++) if (VEC89_PUSH(&vec, &i) != VEC89_SUCCESS) _exit(1);
+		if (VEC89_FILE_SYNC(&vec) != VEC89_SUCCESS) _exit(1);
+		while (vec.count > 0) if (VEC89_POP_INTO(&vec, &value) != VEC89_SUCCESS) _exit(1);
+		if (VEC89_SHRINK_TO_FIT(&vec) != VEC89_SUCCESS) _exit(1);
+		_exit(0);
+	}
+	if (child > 0) {
+		int status = 1;
+		waitpid(child, &status, 0);
+		TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+		TEST_OK(VEC89_FILE_OPEN(&vec, path, sizeof(size_t), VEC89_FILE_READ_WRITE));
+		TEST_CHECK(vec.count <= vec.capacity && vec.count < 1000);
+		for (i = 0; i < vec.count; i++) TEST_CHECK(VEC89_AT(&vec, size_t, i) == i);
+		VEC89_ARRAY_FREE(&vec);
+	}
+	unlink(path);
+}
+#endif
+
+#ifdef VEC89_MMAP_NOTC89
+/* Arrays cross the mapping threshold in both directions */
+static void test_mapped(void) {
+	vec89 vec;
+	size_t i;
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(size_t)));
+	TEST_OK(VEC89_SET_MMAP_THRESHOLD(&vec, 4096));
+	for (i = 0; i < 100000; i++) TEST_OK(VEC89_PUSH(&vec, &i));
+	TEST_CHECK(vec.mapped);
+	TEST_OK(VEC89_REMOVE_RANGE(&vec, 10, vec.count - 20));
+	TEST_OK(VEC89_SHRINK_TO_FIT(&vec));
+	TEST_CHECK(!vec.mapped && vec.count == 20);
+	for (i = 0; i < vec.count; i++) TEST_CHECK(VEC89_AT(&vec, size_t, i) == (i < 10 ? i : 99980 + i));
+	for (i = 0; i < 100000; i++) TEST_OK(VEC89_PUSH(&vec, &i));
+	TEST_CHECK(vec.mapped && VEC89_AT(&vec, size_t, 19) == 99999 && VEC89_AT(&vec, size_t, 20 + 99999) == 99999);
+	VEC89_ARRAY_FREE(&vec);
+}
+#endif
+
+void test_io_suite(void) {
+	test_round_trip();
+	test_stream_chunks();
+	test_damaged_streams();
+	test_untrusted_headers();
+	test_oversized_chunks();
+#ifdef VEC89_FILE_BACKED_NOTC89
+	test_file_backed();
+#endif
+#ifdef VEC89_MMAP_NOTC89
+	test_mapped();
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+/*
+vec89_tests: differential tests that run every vec89 container next to a plain reference model and compare them
+after each operation. Run "vec89_tests [suite...]" for a subset, the exit code is non-zero if any check failed.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "../include/vec89.h"
+
+size_t test_checks;
+size_t test_failures;
+
+void test_fail(const char *file, int line, const char *expression) {
+	test_failures++;
+	if (test_failures <= 50) fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+}
+
+size_t test_random(size_t *state) {
+	/* xorshift64*, state must not start at 0 */
+	unsigned long long x = *state ? (unsigned long long)*state : 0x9E3779B97F4A7C15ULL;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = (size_t)x;
+	return (size_t)((x * 0x2545F4914F6CDD1DULL) >> 16);
+}
+
+void test_random_bytes(void *out, size_t n, unsigned limit, size_t *state) {
+	unsigned char *bytes = out;
+	size_t i;
+	for (i = 0; i < n; i++) bytes[i] = (unsigned char)(test_random(state) % limit);
+}
+
+typedef struct TEST_SUITE {
+	const char *name;
+	void (*run)(void);
+} test_suite;
+
+static const test_suite test_suites[] = {
+	{ "vector", test_vector_suite },
+	{ "containers", test_containers_suite },
+	{ "algo", test_algo_suite },
+	{ "io", test_io_suite },
+	{ "threads", test_threads_suite }
+};
+
+#define TEST_SUITE_COUNT (sizeof(test_suites) / sizeof(test_suites[0]))
+
+int main(int argc, char **argv) {
+	size_t i;
+	int j;
+
+	for (j = 1; j < argc; j++) {
+		for (i = 0; i < TEST_SUITE_COUNT; i++) {
+			if (strcmp(argv[j], test_suites[i].name) == 0) break;
+		}
+		if (i == TEST_SUITE_COUNT) {
+			fprintf(stderr, "unknown suite %s, the suites are vector, containers, algo, io and threads\n", argv[j]);
+			return 2;
+		}
+	}
+
+	for (i = 0; i < TEST_SUITE_COUNT; i++) {
+		size_t failures = test_failures, checks = test_checks;
+		if (argc > 1) {
+			for (j = 1; j < argc; j++) {
+				if (strcmp(argv[j], test_suites[i].name) == 0) break;
+			}
+			if (j == argc) continue;
+		}
+		test_suites[i].run();
+		printf("%-10s %8lu checks, %lu failed\n", test_suites[i].name,
+			(unsigned long)(test_checks - checks), (unsigned long)(test_failures - failures));
+	}
+
+	return test_failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+/*
+Parallel algorithms against their serial results, and containers written from several pool threads at once.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "../include/vec89_parallel.h"
+
+#ifdef VEC89_PARALLEL_NOTC89
+
+#define TEST_PARALLEL_COUNT 300000 /* Above VEC89_PARALLEL_THRESHOLD so jobs are split */
+
+static void test_add_index(void *elements, size_t n, size_t first_idx, void *context) {
+	size_t *values = elements, i;
+	(void)context;
+	for (i = 0; i < n; i++) values[i] += first_idx + i;
+}
+
+static void test_square(const void *source, void *destination, size_t n, void *context) {
+	const size_t *values = source;
+	unsigned long long *squares = destination;
+	size_t i;
+	(void)context;
+	for (i = 0; i < n; i++) squares[i] = (unsigned long long)values[i] * values[i];
+}
+
+/* Reduction of a range into its sum and its first and last value, combining out of order breaks last == first - 1 */
+typedef struct TEST_RANGE_SUM {
+	size_t first;
+	size_t last;
+	size_t sum;
+	size_t count;
+	size_t ordered;
+} test_range_sum;
+
+static void test_reduce_range(void *accumulator, const void *elements, size_t n, void *context) {
+	test_range_sum *sum = accumulator;
+	const size_t *values = elements;
+	size_t i;
+	(void)context;
+	for (i = 0; i < n; i++) {
+		if (sum->count == 0) sum->first = values[i];
+		else if (values[i] != sum->last + 1) sum->ordered = 0;
+		sum->last = values[i];
+		sum->sum += values[i];
+		sum->count++;
+	}
+}
+
+static void test_combine_range(void *accumulator, const void *partial, void *context) {
+	test_range_sum *sum = accumulator;
+	const test_range_sum *part = partial;
+	(void)context;
+	if (part->count == 0) return;
+	if (sum->count == 0) {
+		*sum = *part;
+		return;
+	}
+	if (part->first != sum->last + 1 || !part->ordered) sum->ordered = 0;
+	sum->last = part->last;
+	sum->sum += part->sum;
+	sum->count += part->count;
+}
+
+static int test_size_compare(const void *a, const void *b) {
+	size_t x = *(const size_t *)a, y = *(const size_t *)b;
+	return (x > y) - (x < y);
+}
+
+static void test_parallel(vec89_thread_pool_p pool, size_t threads) {
+	vec89 vec, squares;
+	size_t i, state = 41;
+	size_t *reference = malloc(TEST_PARALLEL_COUNT * sizeof(size_t));
+	test_range_sum sum;
+	TEST_CHECK(reference != NULL);
+	if (reference == NULL) return;
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(size_t)));
+	TEST_OK(VEC89_INITIALIZATION(&squares, sizeof(unsigned long long)));
+	for (i = 0; i < TEST_PARALLEL_COUNT; i++) TEST_OK(VEC89_PUSH(&vec, &i));
+
+	TEST_OK(VEC89_PARALLEL_FOR_EACH(pool, &vec, test_add_index, NULL, threads));
+	for (i = 0; i < TEST_PARALLEL_COUNT && VEC89_AT(&vec, size_t, i) == 2 * i; i++) {}
+	TEST_CHECK(i == TEST_PARALLEL_COUNT);
+
+	TEST_OK(VEC89_PARALLEL_TRANSFORM(pool, &vec, &squares, test_square, NULL, threads));
+	TEST_CHECK(squares.count == TEST_PARALLEL_COUNT);
+	for (i = 0; i < squares.count && VEC89_AT(&squares, unsigned long long, i) == 4ULL * i * i; i++) {}
+	TEST_CHECK(i == TEST_PARALLEL_COUNT);
+
+	for (i = 0; i < TEST_PARALLEL_COUNT; i++) VEC89_AT(&vec, size_t, i) = i;
+	memset(&sum, 0, sizeof(sum));
+	sum.ordered = 1;
+	TEST_OK(VEC89_PARALLEL_REDUCE(pool, &vec, &sum, sizeof(sum), test_reduce_range, test_combine_range, NULL, threads));
+	TEST_CHECK(sum.count == TEST_PARALLEL_COUNT && sum.ordered && sum.first == 0 && sum.last == TEST_PARALLEL_COUNT - 1);
+	TEST_CHECK(sum.sum == (size_t)TEST_PARALLEL_COUNT * (TEST_PARALLEL_COUNT - 1) / 2);
+
+	for (i = 0; i < TEST_PARALLEL_COUNT; i++) {
+		reference[i] = test_random(&state) % 100000;
+		VEC89_AT(&vec, size_t, i) = reference[i];
+	}
+	qsort(reference, TEST_PARALLEL_COUNT, sizeof(size_t), test_size_compare);
+	TEST_OK(VEC89_PARALLEL_SORT(pool, &vec, test_size_compare, threads));
+	TEST_CHECK(memcmp(vec.arr, reference, TEST_PARALLEL_COUNT * sizeof(size_t)) == 0);
+
+	VEC89_ARRAY_FREE(&squares);
+	VEC89_ARRAY_FREE(&vec);
+	free(reference);
+}
+
+#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+/* Every element of a chunk is pushed from the thread running the chunk */
+static void test_concurrent_push(void *elements, size_t n, size_t first_idx, void *context) {
+	const size_t *values = elements;
+	size_t i;
+	(void)first_idx;
+	for (i = 0; i < n; i++) {
+		if (VEC89_CONCURRENT_PUSH(context, &values[i], NULL) != VEC89_SUCCESS) abort();
+	}
+}
+
+static void test_concurrent(vec89_thread_pool_p pool) {
+	vec89 source;
+	vec89_concurrent vec;
+	unsigned char *seen = calloc(TEST_PARALLEL_COUNT, 1);
+	size_t i, missing = 0;
+	TEST_CHECK(seen != NULL);
+	if (seen == NULL) return;
+
+	TEST_OK(VEC89_INITIALIZATION(&source, sizeof(size_t)));
+	for (i = 0; i < TEST_PARALLEL_COUNT; i++) TEST_OK(VEC89_PUSH(&source, &i));
+	TEST_OK(VEC89_CONCURRENT_INITIALIZATION(&vec, sizeof(size_t), NULL));
+
+	TEST_OK(VEC89_PARALLEL_FOR_EACH(pool, &source, test_concurrent_push, &vec, 0));
+	TEST_CHECK(VEC89_CONCURRENT_COUNT(&vec) == TEST_PARALLEL_COUNT);
+	for (i = 0; i < VEC89_CONCURRENT_COUNT(&vec); i++) {
+		void *element;
+		size_t value;
+		TEST_OK(VEC89_CONCURRENT_GET(&vec, i, &element));
+		value = *(size_t *)element;
+		if (value < TEST_PARALLEL_COUNT) seen[value]++;
+	}
+	for (i = 0; i < TEST_PARALLEL_COUNT; i++) missing += seen[i] != 1;
+	TEST_CHECK(missing == 0);
+	{
+		void *element;
+		TEST_CHECK(VEC89_CONCURRENT_GET(&vec, TEST_PARALLEL_COUNT, &element) == VEC89_ARRAY_OUT_OF_INDEX);
+	}
+
+	VEC89_CONCURRENT_ARRAY_FREE(&vec);
+	VEC89_ARRAY_FREE(&source);
+	free(seen);
+}
+#endif
+
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+/* Chunks push each of their elements twice into one shared vector and pop one copy back out */
+static void test_locked_push(void *elements, size_t n, size_t first_idx, void *context) {
+	const size_t *values = elements;
+	size_t i, popped;
+	(void)first_idx;
+	for (i = 0; i < n; i++) {
+		if (VEC89_PUSH(context, &values[i]) != VEC89_SUCCESS || VEC89_PUSH(context, &values[i]) != VEC89_SUCCESS) abort();
+		if (VEC89_POP_INTO(context, &popped) != VEC89_SUCCESS) abort();
+	}
+}
+
+static void test_thread_safe(vec89_thread_pool_p pool) {
+	vec89 source, vec;
+	size_t i, sum = 0;
+
+	TEST_OK(VEC89_INITIALIZATION(&source, sizeof(size_t)));
+	for (i = 0; i < TEST_PARALLEL_COUNT; i++) TEST_OK(VEC89_PUSH(&source, &i));
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(size_t)));
+
+	TEST_OK(VEC89_PARALLEL_FOR_EACH(pool, &source, test_locked_push, &vec, 0));
+	TEST_CHECK(vec.count == TEST_PARALLEL_COUNT);
+	for (i = 0; i < vec.count; i++) sum += VEC89_AT(&vec, size_t, i) < TEST_PARALLEL_COUNT;
+	TEST_CHECK(sum == vec.count);
+
+	VEC89_ARRAY_FREE(&vec);
+	VEC89_ARRAY_FREE(&source);
+}
+#endif
+#endif
+
+void test_threads_suite(void) {
+#ifdef VEC89_PARALLEL_NOTC89
+	vec89_thread_pool pool;
+	TEST_OK(VEC89_THREAD_POOL_INITIALIZATION(&pool, 4));
+
+	test_parallel(NULL, 0);
+	test_parallel(&pool, 0);
+	test_parallel(&pool, 2);
+#ifdef VEC89_CONCURRENT_APPEND_NOTC89
+	test_concurrent(&pool);
+#endif
+#ifdef VEC89_THREAD_SAFE_IMPLEMENTATION_NOTC89
+	test_thread_safe(&pool);
+#endif
+
+	VEC89_THREAD_POOL_DESTROY(&pool);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,349 @@
+/*
+	*	MIT License
+	*
+	*	Copyright (c) 2025 xyurt
+	*
+	*	Permission is hereby granted, free of charge, to any person obtaining a copy
+	*	of this software and associated documentation files (the "Software"), to deal
+	*	in the Software without restriction, including without limitation the rights
+	*	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	*	copies of the Software, and to permit persons to whom the Software is
+	*	furnished to do so, subject to the following conditions:
+	*		
+	*	The above copyright notice and this permission notice shall be included in all
+	*	copies or substantial portions of the Software.
+	*	
+	*	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	*	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	*	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	*	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	*	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	*	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	*	SOFTWARE.
+*/
+
+
+/*
+vec89 against a plain array: random sequences of every element operation, compared after each step.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "../include/vec89_algo.h"
+
+#define TEST_VECTOR_STEPS 4000
+#define TEST_VECTOR_MAX_COUNT 1024 /* Operations that add elements are skipped above this count */
+#define TEST_VECTOR_MAX_BATCH 24
+
+/* Plain array the vector is compared with */
+typedef struct TEST_MODEL {
+	unsigned char *data;
+	size_t count;
+	size_t elem_size;
+} test_model;
+
+static unsigned char *test_model_at(test_model *model, size_t idx) {
+	return model->data + idx * model->elem_size;
+}
+
+static void test_model_insert(test_model *model, size_t idx, const void *elements, size_t n) {
+	size_t size = model->elem_size;
+	memmove(test_model_at(model, idx + n), test_model_at(model, idx), (model->count - idx) * size);
+	memcpy(test_model_at(model, idx), elements, n * size);
+	model->count += n;
+}
+
+static void test_model_remove(test_model *model, size_t idx, size_t n) {
+	size_t size = model->elem_size;
+	memmove(test_model_at(model, idx), test_model_at(model, idx + n), (model->count - idx - n) * size);
+	model->count -= n;
+}
+
+/* Removes the elements whose first byte is odd, or even with keep_odd, and returns how many were removed */
+static size_t test_model_filter(test_model *model, char keep_odd) {
+	size_t i, kept = 0, removed;
+	for (i = 0; i < model->count; i++) {
+		if (((*test_model_at(model, i) & 1) != 0) == (keep_odd != 0)) {
+			memmove(test_model_at(model, kept), test_model_at(model, i), model->elem_size);
+			kept++;
+		}
+	}
+	removed = model->count - kept;
+	model->count = kept;
+	return removed;
+}
+
+static size_t test_model_dedup(test_model *model) {
+	size_t i, kept = model->count > 0 ? 1 : 0, removed;
+	for (i = 1; i < model->count; i++) {
+		if (memcmp(test_model_at(model, i), test_model_at(model, kept - 1), model->elem_size) != 0) {
+			memmove(test_model_at(model, kept), test_model_at(model, i), model->elem_size);
+			kept++;
+		}
+	}
+	removed = model->count - kept;
+	model->count = kept;
+	return removed;
+}
+
+static char test_odd_first_byte(const void *element, void *context) {
+	(void)context;
+	return (*(const unsigned char *)element & 1) != 0;
+}
+
+/* Returns non-zero if the vector holds exactly the model's elements */
+static int test_vector_matches(vec_p vec, test_model *model) {
+	const void *arr;
+	size_t count;
+	int equal;
+	if (VEC89_READ_BEGIN(vec, &arr, &count) != VEC89_SUCCESS) return 0;
+	equal = count == model->count && vec->capacity >= count && (count == 0 || memcmp(arr, model->data, count * model->elem_size) == 0);
+	VEC89_READ_END(vec);
+	return equal;
+}
+
+static void test_vector_model(size_t elem_size, const vec89_growth_policy *growth, size_t seed) {
+	vec89 vec;
+	test_model model;
+	unsigned char *batch = malloc(TEST_VECTOR_MAX_BATCH * elem_size), *out = malloc(TEST_VECTOR_MAX_BATCH * elem_size);
+	size_t step, state = seed;
+
+	model.data = malloc(2 * TEST_VECTOR_MAX_COUNT * elem_size);
+	model.count = 0;
+	model.elem_size = elem_size;
+	TEST_CHECK(batch != NULL && out != NULL && model.data != NULL);
+	if (batch == NULL || out == NULL || model.data == NULL) return;
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, elem_size));
+	if (growth != NULL) TEST_OK(VEC89_SET_GROWTH_POLICY(&vec, growth));
+
+	for (step = 0; step < TEST_VECTOR_STEPS; step++) {
+		size_t operation = test_random(&state) % 20, removed = 0;
+		size_t idx = model.count > 0 ? test_random(&state) % model.count : 0;
+		size_t n = test_random(&state) % TEST_VECTOR_MAX_BATCH;
+		char full = model.count > TEST_VECTOR_MAX_COUNT;
+		test_random_bytes(batch, TEST_VECTOR_MAX_BATCH * elem_size, 4, &state);
+
+		switch (operation) {
+			case 0:
+			case 1:
+				if (full) break;
+				TEST_OK(VEC89_PUSH(&vec, batch));
+				test_model_insert(&model, model.count, batch, 1);
+				break;
+			case 2:
+				if (model.count == 0) {
+					TEST_CHECK(VEC89_POP_INTO(&vec, out) == VEC89_ARRAY_OUT_OF_INDEX);
+					break;
+				}
+				TEST_OK(VEC89_POP_INTO(&vec, out));
+				TEST_CHECK(memcmp(out, test_model_at(&model, model.count - 1), elem_size) == 0);
+				model.count--;
+				break;
+			case 3:
+				if (full) break;
+				idx = test_random(&state) % (model.count + 1);
+				TEST_OK(VEC89_INSERT(&vec, idx, batch));
+				test_model_insert(&model, idx, batch, 1);
+				break;
+			case 4:
+				if (model.count == 0) break;
+				TEST_OK(VEC89_REMOVE(&vec, idx));
+				test_model_remove(&model, idx, 1);
+				break;
+			case 5:
+				if (model.count == 0) break;
+				TEST_OK(VEC89_SET(&vec, idx, batch));
+				memcpy(test_model_at(&model, idx), batch, elem_size);
+				break;
+			case 6:
+				if (full) break;
+				TEST_OK(VEC89_PUSH_N(&vec, batch, n));
+				test_model_insert(&model, model.count, batch, n);
+				break;
+			case 7:
+				if (full) break;
+				idx = test_random(&state) % (model.count + 1);
+				TEST_OK(VEC89_INSERT_RANGE(&vec, idx, batch, n));
+				test_model_insert(&model, idx, batch, n);
+				break;
+			case 8:
+				n = TEST_MIN(n, model.count - idx);
+				TEST_OK(VEC89_REMOVE_RANGE(&vec, idx, n));
+				test_model_remove(&model, idx, n);
+				TEST_CHECK(VEC89_REMOVE_RANGE(&vec, model.count, 1) == VEC89_ARRAY_OUT_OF_INDEX);
+				break;
+			case 9:
+				if (model.count == 0) break;
+				TEST_OK(VEC89_SWAP_REMOVE(&vec, idx));
+				memcpy(test_model_at(&model, idx), test_model_at(&model, model.count - 1), elem_size);
+				model.count--;
+				break;
+			case 10:
+				n = TEST_MIN(n, model.count);
+				TEST_OK(VEC89_POP_N(&vec, out, n));
+				TEST_CHECK(n == 0 || memcmp(out, test_model_at(&model, model.count - n), n * elem_size) == 0);
+				model.count -= n;
+				break;
+			case 11:
+				n = TEST_MIN(n, model.count - idx);
+				TEST_OK(VEC89_GET_N(&vec, idx, out, n));
+				TEST_CHECK(n == 0 || memcmp(out, test_model_at(&model, idx), n * elem_size) == 0);
+				TEST_CHECK(VEC89_GET_N(&vec, idx, out, model.count - idx + 1) == VEC89_ARRAY_OUT_OF_INDEX);
+				break;
+			case 12:
+				n = TEST_MIN(n, model.count - idx);
+				TEST_OK(VEC89_SET_N(&vec, idx, batch, n));
+				if (n > 0) memcpy(test_model_at(&model, idx), batch, n * elem_size);
+				break;
+			case 13:
+				if (test_random(&state) % 8 != 0) break;
+				TEST_OK(VEC89_REMOVE_IF(&vec, test_odd_first_byte, NULL, &removed));
+				TEST_CHECK(removed == test_model_filter(&model, 0));
+				break;
+			case 14:
+				if (test_random(&state) % 8 != 0) break;
+				TEST_OK(VEC89_RETAIN(&vec, test_odd_first_byte, NULL, &removed));
+				TEST_CHECK(removed == test_model_filter(&model, 1));
+				break;
+			case 15:
+				TEST_OK(VEC89_DEDUP(&vec, NULL, NULL, &removed));
+				TEST_CHECK(removed == test_model_dedup(&model));
+				break;
+			case 16:
+				if (model.count > TEST_VECTOR_MAX_COUNT / 2) break;
+				TEST_OK(VEC89_APPEND_VEC(&vec, &vec));
+				memcpy(test_model_at(&model, model.count), model.data, model.count * elem_size);
+				model.count *= 2;
+				break;
+			case 17:
+				if (model.count == 0) {
+					TEST_CHECK(VEC89_GET_COPY(&vec, 0, out) == VEC89_ARRAY_OUT_OF_INDEX);
+					break;
+				}
+				TEST_OK(VEC89_GET_COPY(&vec, idx, out));
+				TEST_CHECK(memcmp(out, test_model_at(&model, idx), elem_size) == 0);
+				TEST_CHECK(VEC89_GET_COPY(&vec, model.count, out) == VEC89_ARRAY_OUT_OF_INDEX);
+				break;
+			case 18:
+				switch (test_random(&state) % 4) {
+					case 0: TEST_OK(VEC89_SHRINK_TO_FIT(&vec)); break;
+					case 1: TEST_OK(VEC89_RESERVE(&vec, model.count + n)); break;
+					case 2: TEST_OK(VEC89_SHRINK(&vec, 2)); break;
+					default:
+						if (test_random(&state) % 8 != 0) break;
+						TEST_OK(VEC89_CLEAR(&vec));
+						model.count = 0;
+						break;
+				}
+				break;
+			default: {
+				vec89_view view;
+				size_t end = idx + TEST_MIN(n, model.count - idx), i;
+				TEST_OK(VEC89_VIEW(&vec, idx, end, 1, &view));
+				TEST_CHECK(view.count == end - idx && view.stride == elem_size);
+				for (i = 0; i < view.count; i++) {
+					unsigned char *element = vec89_view_at(&view, i);
+					TEST_CHECK(memcmp(element, test_model_at(&model, idx + i), elem_size) == 0);
+					element[0] ^= 1;
+					test_model_at(&model, idx + i)[0] ^= 1;
+				}
+				VEC89_VIEW_RELEASE(&view);
+				TEST_CHECK(VEC89_VIEW(&vec, 0, model.count + 1, 0, &view) == VEC89_ARRAY_OUT_OF_INDEX);
+				break;
+			}
+		}
+		TEST_CHECK(test_vector_matches(&vec, &model));
+	}
+
+	VEC89_ARRAY_FREE(&vec);
+	free(model.data);
+	free(batch);
+	free(out);
+}
+
+/* Clones and snapshots keep their elements whatever happens to the vector, with or without copy-on-write */
+static void test_vector_clone(void) {
+	vec89 vec, clone;
+	vec89_snapshot snapshot;
+	int value, i;
+
+	TEST_OK(VEC89_INITIALIZATION(&vec, sizeof(int)));
+	for (value = 0; value < 100; value++) TEST_OK(VEC89_PUSH(&vec, &value));
+
+	TEST_OK(VEC89_CLONE(&vec, &clone));
+	TEST_OK(VEC89_SNAPSHOT(&vec, &snapshot));
+	TEST_CHECK(clone.count == 100 && snapshot.count == 100);
+
+	value = -1;
+	TEST_OK(VEC89_SET(&vec, 0, &value));
+	TEST_OK(VEC89_PUSH(&vec, &value));
+	TEST_OK(VEC89_REMOVE(&vec, 50));
+	TEST_CHECK(VEC89_AT(&clone, int, 0) == 0 && VEC89_SNAPSHOT_AT(&snapshot, int, 0) == 0);
+
+	TEST_OK(VEC89_SET(&clone, 1, &value));
+	TEST_CHECK(VEC89_AT(&vec, int, 1) == 1 && VEC89_SNAPSHOT_AT(&snapshot, int, 1) == 1);
+
+	for (i = 0; i < 100; i++) {
+		TEST_CHECK(VEC89_SNAPSHOT_AT(&snapshot, int, i) == i);
+		TEST_CHECK(VEC89_AT(&clone, int, i) == (i == 1 ? -1 : i));
+	}
+	TEST_CHECK(vec.count == 100 && VEC89_AT(&vec, int, 50) == 51);
+
+	/* Writing through VEC89_DATA is only safe after a detach */
+	VEC89_ARRAY_FREE(&clone);
+	TEST_OK(VEC89_CLONE(&vec, &clone));
+	VEC89_SNAPSHOT_RELEASE(&snapshot);
+	TEST_OK(VEC89_SNAPSHOT(&clone, &snapshot));
+	TEST_OK(VEC89_DETACH(&vec));
+	VEC89_DATA(&vec, int)[2] = -2;
+	TEST_CHECK(VEC89_AT(&clone, int, 2) == 2 && VEC89_SNAPSHOT_AT(&snapshot, int, 2) == 2);
+
+	VEC89_SNAPSHOT_RELEASE(&snapshot);
+	VEC89_ARRAY_FREE(&clone);
+	VEC89_ARRAY_FREE(&vec);
+}
+
+#define TEST_INT_GREATER(a, b) ((a) > (b))
+
+VEC89_DEFINE(test_shared_vec, int)
+VEC89_DEFINE_SORT(test_shared_vec, int, TEST_INT_GREATER)
+
+/* Typed sorting reorders the sorted vector only, not the clones and snapshots sharing its array */
+static void test_vector_clone_sort(void) {
+	test_shared_vec typed;
+	vec89 clone;
+	vec89_snapshot snapshot;
+	int value;
+
+	TEST_OK(test_shared_vec_init(&typed));
+	for (value = 0; value < 100; value++) TEST_OK(test_shared_vec_push(&typed, value));
+	TEST_OK(VEC89_CLONE(&typed.base, &clone));
+	TEST_OK(VEC89_SNAPSHOT(&typed.base, &snapshot));
+
+	TEST_OK(test_shared_vec_sort(&typed));
+	TEST_CHECK(test_shared_vec_data(&typed)[0] == 99 && test_shared_vec_data(&typed)[99] == 0);
+	for (value = 0; value < 100; value++) {
+		TEST_CHECK(VEC89_AT(&clone, int, value) == value);
+		TEST_CHECK(VEC89_SNAPSHOT_AT(&snapshot, int, value) == value);
+	}
+
+	VEC89_SNAPSHOT_RELEASE(&snapshot);
+	VEC89_ARRAY_FREE(&clone);
+	test_shared_vec_array_free(&typed);
+}
+
+void test_vector_suite(void) {
+	static const size_t elem_sizes[] = { 1, 4, 12, 40 };
+	vec89_growth_policy shrinking = { 150, 0, 0, 4, 25, 50, 8 };
+	size_t i;
+
+	for (i = 0; i < sizeof(elem_sizes) / sizeof(elem_sizes[0]); i++) {
+		test_vector_model(elem_sizes[i], NULL, 1 + i);
+		test_vector_model(elem_sizes[i], &shrinking, 101 + i);
+	}
+	test_vector_clone();
+	test_vector_clone_sort();
+}
\ No newline at end of file